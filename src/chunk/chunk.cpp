@@ -1,7 +1,7 @@
 #include "chunk/chunk.h"
 #include "chunk/disassembler.h"
 #include "error/error.h"
-#include "value/valueHashTable.h"
+#include "value/globalTable.h"
 
 namespace aria {
 
@@ -12,11 +12,11 @@ Chunk::Chunk(GC *gc)
     , codes_{nullptr}
     , lines_(nullptr)
     , consts_{gc}
-    , globals_{new ValueHashTable{gc}}
+    , globals_{new GlobalTable{}}
     , globals_manageable_{false}
 {}
 
-Chunk::Chunk(ValueHashTable *globals, GC *gc)
+Chunk::Chunk(GlobalTable *globals, GC *gc)
     : gc_{gc}
     , count_{0}
     , capacity_{0}
@@ -111,6 +111,46 @@ void Chunk::emit_op_value(opCode op, Value value, uint32_t line)
     emit_word(static_cast<uint16_t>(index), line);
 }
 
+void Chunk::emit_field_op(opCode op, Value name, uint32_t line)
+{
+    emit_op_value(op, name, line);
+    if (field_caches_.size() > UINT16_MAX) {
+        fatal_error(ErrorCode::RESOURCE_CHUNK_OVERFLOW, "Too many field accesses in one chunk.");
+    }
+    emit_word(static_cast<uint16_t>(field_caches_.size()), line);
+    field_caches_.emplace_back();
+}
+
+void Chunk::emit_invoke(Value name, uint8_t argCount, uint32_t line)
+{
+    emit_op_value(opCode::INVOKE_METHOD, name, line);
+    emit_byte(argCount, line);
+    if (method_caches_.size() > UINT16_MAX) {
+        fatal_error(ErrorCode::RESOURCE_CHUNK_OVERFLOW, "Too many method calls in one chunk.");
+    }
+    emit_word(static_cast<uint16_t>(method_caches_.size()), line);
+    method_caches_.emplace_back();
+}
+
+void Chunk::emit_call(opCode op, uint8_t argCount, uint32_t line)
+{
+    emit_op_arg8(op, argCount, line);
+    if (call_caches_.size() > UINT16_MAX) {
+        fatal_error(ErrorCode::RESOURCE_CHUNK_OVERFLOW, "Too many calls in one chunk.");
+    }
+    emit_word(static_cast<uint16_t>(call_caches_.size()), line);
+    call_caches_.emplace_back();
+}
+
+void Chunk::emit_global(opCode op, ObjString *name, uint32_t line)
+{
+    uint32_t slot = globals_->slot_of(name);
+    if (slot > UINT16_MAX) {
+        fatal_error(ErrorCode::RESOURCE_CHUNK_OVERFLOW, "Too many global variables in one module.");
+    }
+    emit_op_arg16(op, static_cast<uint16_t>(slot), line);
+}
+
 uint32_t Chunk::emit_jump(opCode jump_op, uint32_t line)
 {
     emit_op(jump_op, line);
@@ -118,6 +158,16 @@ uint32_t Chunk::emit_jump(opCode jump_op, uint32_t line)
     return count_ - 2;
 }
 
+void Chunk::emit_for_iter(uint16_t slot, uint32_t loop_start, uint32_t line)
+{
+    emit_op_arg16(opCode::FOR_ITER, slot, line);
+    uint32_t offset = count_ + 2 - loop_start;
+    if (offset > UINT16_MAX) {
+        fatal_error(ErrorCode::RESOURCE_JUMP_OVERFLOW, "Loop body too large.");
+    }
+    emit_word(static_cast<uint16_t>(offset), line);
+}
+
 void Chunk::emit_pop_n(uint32_t count, uint32_t line)
 {
     while (count > 0) {
@@ -203,6 +253,16 @@ uint32_t Chunk::line_of_last_code() const
     return lines_[count_ - 1];
 }
 
+const ExceptionHandler *Chunk::find_handler(uint32_t offset) const
+{
+    for (const auto &handler : handlers_) {
+        if (offset >= handler.start && offset < handler.end) {
+            return &handler;
+        }
+    }
+    return nullptr;
+}
+
 void Chunk::rewrite_byte(uint8_t byte, uint32_t index)
 {
     codes_[index] = byte;
@@ -7,14 +7,72 @@
 
 namespace aria {
 
-class ValueHashTable;
+class GlobalTable;
+class ObjString;
+class Shape;
+class ObjClass;
+class ObjFunction;
+class ObjClosure;
+
+// LOAD_FIELD/STORE_FIELD 的单态内联缓存，以实例的 shape 为键
+struct FieldCache
+{
+    Shape *shape = nullptr;
+    // STORE_FIELD 添加新字段时迁移到的 shape；访问已有字段时为 nullptr
+    Shape *transition = nullptr;
+    uint32_t slot = 0;
+};
+
+// INVOKE_METHOD 的单态内联缓存：实例的 shape 和类都与缓存相同时直接调用缓存的方法
+struct MethodCache
+{
+    Shape *shape = nullptr;
+    ObjClass *klass = nullptr;
+    Value method = NanBox::NilValue;
+};
+
+// CALL/TAIL_CALL 调用点缓存的被调用者种类，NONE 表示缓存为空或被调用者不适合缓存
+enum class CallCacheKind : uint8_t
+{
+    NONE,
+    // ObjFunction 或 ObjClosure，参数个数与原型完全一致且不接受可变参数
+    FUNCTION,
+    // 参数个数完全一致且不接受可变参数的原生函数，或按 STACK 约定接收可变参数的原生函数
+    NATIVE,
+    // 类：init 方法的参数个数完全一致，或者没有 init 方法且没有参数
+    CLASS,
+};
+
+// CALL/TAIL_CALL 的单态调用点缓存：被调用者与缓存的值相同时跳过类型分派和参数个数检查。
+// 缓存是弱引用，不标记其中的对象；被调用者被回收时 GC::clear_dead_call_caches 清空缓存。
+// function 和 closure 都可以从 callee 到达，callee 存活时它们也存活
+struct CallCache
+{
+    Value callee = NanBox::NilValue;
+    CallCacheKind kind = CallCacheKind::NONE;
+    // FUNCTION 为被调用者的原型，CLASS 为 init 方法的原型（没有 init 方法时为 nullptr）
+    ObjFunction *function = nullptr;
+    // function 对应的闭包，不是闭包时为 nullptr
+    ObjClosure *closure = nullptr;
+};
+
+// try 语句的异常处理表项：偏移在 [start, end) 内的指令抛出异常时，
+// 把栈截断到 stack_depth（相对栈帧基址）并跳转到 handler。
+// 内层 try 的表项排在外层之前，按顺序查找的第一个匹配项就是最内层的处理器
+struct ExceptionHandler
+{
+    uint32_t start;
+    uint32_t end;
+    uint32_t handler;
+    uint32_t stack_depth;
+};
 
 class Chunk
 {
 public:
     explicit Chunk(GC *gc);
 
-    Chunk(ValueHashTable *globals, GC *gc);
+    Chunk(GlobalTable *globals, GC *gc);
 
     ~Chunk();
 
@@ -38,10 +96,25 @@ public:
 
     void emit_op_value(opCode op, Value value, uint32_t line);
 
+    // op name16 cache16, cache16 is the index of a new FieldCache
+    void emit_field_op(opCode op, Value name, uint32_t line);
+
+    // INVOKE_METHOD name16 argc8 cache16, cache16 is the index of a new MethodCache
+    void emit_invoke(Value name, uint8_t argCount, uint32_t line);
+
+    // CALL/TAIL_CALL argc8 cache16, cache16 is the index of a new CallCache
+    void emit_call(opCode op, uint8_t argCount, uint32_t line);
+
+    // DEF/LOAD/STORE_GLOBAL with the slot of name in globals_
+    void emit_global(opCode op, ObjString *name, uint32_t line);
+
     // Write a jump instruction with a placeholder (2 bytes)
     // return the offset position (for subsequent backfilling)
     uint32_t emit_jump(opCode jump_op, uint32_t line);
 
+    // FOR_ITER slot16 offset16, jumps back to loop_start while the iteration has a next value
+    void emit_for_iter(uint16_t slot, uint32_t loop_start, uint32_t line);
+
     void emit_pop_n(uint32_t count, uint32_t line);
 
     void emit_scope_cleanup(const List<opCode> &ops, uint32_t line);
@@ -58,13 +131,20 @@ public:
 
     [[nodiscard]] uint32_t line_of_last_code() const;
 
+    // 覆盖 offset 处指令的最内层异常处理器，没有时返回 nullptr
+    [[nodiscard]] const ExceptionHandler *find_handler(uint32_t offset) const;
+
     GC *gc_;
     uint32_t count_;
     uint32_t capacity_;
     uint8_t *codes_;
     uint32_t *lines_;
     ValueArray consts_;
-    ValueHashTable *globals_;
+    List<FieldCache> field_caches_;
+    List<MethodCache> method_caches_;
+    List<CallCache> call_caches_;
+    List<ExceptionHandler> handlers_;
+    GlobalTable *globals_;
     bool globals_manageable_;
 
 private:
@@ -82,18 +82,107 @@ enum class opCode : uint8_t {
 
     // iterator
     GET_ITER,
-    ITER_HAS_NEXT,
-    ITER_GET_NEXT,
+    FOR_ITER,
 
-    // exception handling
-    SETUP_EXCEPT,
-    END_EXCEPT,
+    // exception handling (try blocks are described by Chunk::handlers_)
     THROW,
 
     // return
     RETURN,
+
+    // superinstructions (only produced by the peephole pass, see chunk/peephole.h)
+    INC_LOCAL,
+    LOCAL_LOCAL_CMP_JUMP,
+    LOCAL_CONST_CMP_JUMP,
+    LOAD_LOCAL_FIELD,
+    // INC_LOCAL + LOCAL_*_CMP_JUMP + JUMP_FWD: the back-edge of a rotated counted loop
+    FOR_RANGE,
+
+    // quickened forms (rewritten in place by the interpreter on first execution)
+    ADD_NUM,
+    SUBTRACT_NUM,
+    MULTIPLY_NUM,
+    DIVIDE_NUM,
+    MOD_NUM,
+    GREATER_NUM,
+    GREATER_EQUAL_NUM,
+    LESS_NUM,
+    LESS_EQUAL_NUM,
+
+    // register backend (only produced by compile/registerGenerator.h)
+    // operands are 8-bit registers, i.e. slots of the current frame
+    REG_MOVE,
+    REG_LOAD_GLOBAL,
+    REG_STORE_GLOBAL,
+    REG_ADD,
+    REG_SUBTRACT,
+    REG_MULTIPLY,
+    REG_DIVIDE,
+    REG_MOD,
+    REG_EQUAL,
+    REG_NOT_EQUAL,
+    REG_GREATER,
+    REG_GREATER_EQUAL,
+    REG_LESS,
+    REG_LESS_EQUAL,
+    REG_NOT,
+    REG_NEGATE,
+    REG_JUMP_TRUE,
+    REG_JUMP_FALSE,
+    // a b offset16: jump forward when the comparison is false
+    REG_EQUAL_JUMP,
+    REG_NOT_EQUAL_JUMP,
+    REG_GREATER_JUMP,
+    REG_GREATER_EQUAL_JUMP,
+    REG_LESS_JUMP,
+    REG_LESS_EQUAL_JUMP,
+    REG_CALL,
+    REG_RETURN,
+    REG_PRINT,
+
+    // `return f(args)`: reuses the current frame for the callee, always followed by RETURN
+    TAIL_CALL,
+
+    // rest parameter of a varargs function (slot16), the extra arguments stay in AriaVM::rest_args_
+    // until the parameter is used as a value
+    LOAD_REST,
+    LOAD_REST_ITEM,
+    LOAD_REST_ITER,
+
+    // debugger breakpoint patched over the first byte of an instruction, the original byte is kept
+    // by AriaDebugger; never emitted by the compiler
+    BREAKPOINT,
 };
 
+inline constexpr opCode k_last_opcode = opCode::BREAKPOINT;
+
+// quickened opcode -> generic opcode
+inline constexpr opCode generic_opcode(opCode op)
+{
+    switch (op) {
+    case opCode::ADD_NUM:
+        return opCode::ADD;
+    case opCode::SUBTRACT_NUM:
+        return opCode::SUBTRACT;
+    case opCode::MULTIPLY_NUM:
+        return opCode::MULTIPLY;
+    case opCode::DIVIDE_NUM:
+        return opCode::DIVIDE;
+    case opCode::MOD_NUM:
+        return opCode::MOD;
+    case opCode::GREATER_NUM:
+        return opCode::GREATER;
+    case opCode::GREATER_EQUAL_NUM:
+        return opCode::GREATER_EQUAL;
+    case opCode::LESS_NUM:
+        return opCode::LESS;
+    case opCode::LESS_EQUAL_NUM:
+        return opCode::LESS_EQUAL;
+    default:
+        return op;
+    }
+}
+
 }
 
 #endif //ARIA_CODE_H
@@ -1,7 +1,9 @@
 #include "chunk/disassembler.h"
 #include "chunk/chunk.h"
 #include "object/objFunction.h"
+#include "object/objString.h"
 #include "util/util.h"
+#include "value/globalTable.h"
 
 namespace aria {
 
@@ -20,6 +22,9 @@ void Disassembler::disassembleChunk(const Chunk *chunk, StringView name)
             break;
         }
     }
+    for (const auto &[start, end, handler, stackDepth] : chunk->handlers_) {
+        println("  handler [{:06}, {:06}) -> {:06}  stack {}", start, end, handler, stackDepth);
+    }
     println("  ======== {:^10} ========", "chunk end");
 }
 
@@ -57,15 +62,15 @@ uint32_t Disassembler::disassembleInstruction(
     case opCode::CLOSE_UPVALUE:
         return simpleInstruction("CLOSE_UPVALUE", offset);
     case opCode::DEF_GLOBAL:
-        return constantInstruction(chunk, "DEF_GLOBAL", offset);
+        return globalInstruction(chunk, "DEF_GLOBAL", offset);
     case opCode::LOAD_GLOBAL:
-        return constantInstruction(chunk, "LOAD_GLOBAL", offset);
+        return globalInstruction(chunk, "LOAD_GLOBAL", offset);
     case opCode::STORE_GLOBAL:
-        return constantInstruction(chunk, "STORE_GLOBAL", offset);
+        return globalInstruction(chunk, "STORE_GLOBAL", offset);
     case opCode::LOAD_FIELD:
-        return constantInstruction(chunk, "LOAD_FIELD", offset);
+        return fieldInstruction(chunk, "LOAD_FIELD", offset);
     case opCode::STORE_FIELD:
-        return constantInstruction(chunk, "STORE_FIELD", offset);
+        return fieldInstruction(chunk, "STORE_FIELD", offset);
     case opCode::LOAD_SUBSCR:
         return simpleInstruction("LOAD_SUBSCR", offset);
     case opCode::STORE_SUBSCR:
@@ -117,7 +122,9 @@ uint32_t Disassembler::disassembleInstruction(
     case opCode::JUMP_FALSE_NOPOP:
         return jumpInstruction(chunk, "JUMP_FALSE_NOPOP", offset, 1);
     case opCode::CALL:
-        return twoBytesInstruction(chunk, "CALL", offset);
+        return callInstruction(chunk, "CALL", offset);
+    case opCode::INVOKE_METHOD:
+        return invokeInstruction(chunk, offset);
     case opCode::CLOSURE:
         return closureInstruction(chunk, offset);
     case opCode::MAKE_CLASS:
@@ -138,18 +145,108 @@ uint32_t Disassembler::disassembleInstruction(
         return constantInstruction(chunk, "IMPORT", offset);
     case opCode::GET_ITER:
         return simpleInstruction("GET_ITER", offset);
-    case opCode::ITER_HAS_NEXT:
-        return simpleInstruction("ITER_HAS_NEXT", offset);
-    case opCode::ITER_GET_NEXT:
-        return simpleInstruction("ITER_GET_NEXT", offset);
-    case opCode::SETUP_EXCEPT:
-        return jumpInstruction(chunk, "SETUP_EXCEPT", offset, 1);
-    case opCode::END_EXCEPT:
-        return simpleInstruction("END_EXCEPT", offset);
+    case opCode::FOR_ITER:
+        return forIterInstruction(chunk, offset);
     case opCode::THROW:
         return simpleInstruction("THROW", offset);
     case opCode::RETURN:
         return simpleInstruction("RETURN", offset);
+    case opCode::INC_LOCAL:
+        return incLocalInstruction(chunk, offset);
+    case opCode::LOCAL_LOCAL_CMP_JUMP:
+        return compareJumpInstruction(chunk, "LOCAL_LOCAL_CMP_JUMP", offset);
+    case opCode::LOCAL_CONST_CMP_JUMP:
+        return compareJumpInstruction(chunk, "LOCAL_CONST_CMP_JUMP", offset);
+    case opCode::LOAD_LOCAL_FIELD:
+        return loadLocalFieldInstruction(chunk, offset);
+    case opCode::FOR_RANGE:
+        return forRangeInstruction(chunk, offset);
+    case opCode::ADD_NUM:
+        return simpleInstruction("ADD_NUM", offset);
+    case opCode::SUBTRACT_NUM:
+        return simpleInstruction("SUBTRACT_NUM", offset);
+    case opCode::MULTIPLY_NUM:
+        return simpleInstruction("MULTIPLY_NUM", offset);
+    case opCode::DIVIDE_NUM:
+        return simpleInstruction("DIVIDE_NUM", offset);
+    case opCode::MOD_NUM:
+        return simpleInstruction("MOD_NUM", offset);
+    case opCode::GREATER_NUM:
+        return simpleInstruction("GREATER_NUM", offset);
+    case opCode::GREATER_EQUAL_NUM:
+        return simpleInstruction("GREATER_EQUAL_NUM", offset);
+    case opCode::LESS_NUM:
+        return simpleInstruction("LESS_NUM", offset);
+    case opCode::LESS_EQUAL_NUM:
+        return simpleInstruction("LESS_EQUAL_NUM", offset);
+    case opCode::REG_MOVE:
+        return registerInstruction(chunk, "REG_MOVE", offset, 2);
+    case opCode::REG_LOAD_GLOBAL:
+        return registerGlobalInstruction(chunk, "REG_LOAD_GLOBAL", offset);
+    case opCode::REG_STORE_GLOBAL:
+        return registerGlobalInstruction(chunk, "REG_STORE_GLOBAL", offset);
+    case opCode::REG_ADD:
+        return registerInstruction(chunk, "REG_ADD", offset, 3);
+    case opCode::REG_SUBTRACT:
+        return registerInstruction(chunk, "REG_SUBTRACT", offset, 3);
+    case opCode::REG_MULTIPLY:
+        return registerInstruction(chunk, "REG_MULTIPLY", offset, 3);
+    case opCode::REG_DIVIDE:
+        return registerInstruction(chunk, "REG_DIVIDE", offset, 3);
+    case opCode::REG_MOD:
+        return registerInstruction(chunk, "REG_MOD", offset, 3);
+    case opCode::REG_EQUAL:
+        return registerInstruction(chunk, "REG_EQUAL", offset, 3);
+    case opCode::REG_NOT_EQUAL:
+        return registerInstruction(chunk, "REG_NOT_EQUAL", offset, 3);
+    case opCode::REG_GREATER:
+        return registerInstruction(chunk, "REG_GREATER", offset, 3);
+    case opCode::REG_GREATER_EQUAL:
+        return registerInstruction(chunk, "REG_GREATER_EQUAL", offset, 3);
+    case opCode::REG_LESS:
+        return registerInstruction(chunk, "REG_LESS", offset, 3);
+    case opCode::REG_LESS_EQUAL:
+        return registerInstruction(chunk, "REG_LESS_EQUAL", offset, 3);
+    case opCode::REG_NOT:
+        return registerInstruction(chunk, "REG_NOT", offset, 2);
+    case opCode::REG_NEGATE:
+        return registerInstruction(chunk, "REG_NEGATE", offset, 2);
+    case opCode::REG_JUMP_TRUE:
+        return registerJumpInstruction(chunk, "REG_JUMP_TRUE", offset);
+    case opCode::REG_JUMP_FALSE:
+        return registerJumpInstruction(chunk, "REG_JUMP_FALSE", offset);
+    case opCode::REG_EQUAL_JUMP:
+        return registerCompareJumpInstruction(chunk, "REG_EQUAL_JUMP", "==", offset);
+    case opCode::REG_NOT_EQUAL_JUMP:
+        return registerCompareJumpInstruction(chunk, "REG_NOT_EQUAL_JUMP", "!=", offset);
+    case opCode::REG_GREATER_JUMP:
+        return registerCompareJumpInstruction(chunk, "REG_GREATER_JUMP", ">", offset);
+    case opCode::REG_GREATER_EQUAL_JUMP:
+        return registerCompareJumpInstruction(chunk, "REG_GREATER_EQUAL_JUMP", ">=", offset);
+    case opCode::REG_LESS_JUMP:
+        return registerCompareJumpInstruction(chunk, "REG_LESS_JUMP", "<", offset);
+    case opCode::REG_LESS_EQUAL_JUMP:
+        return registerCompareJumpInstruction(chunk, "REG_LESS_EQUAL_JUMP", "<=", offset);
+    case opCode::REG_CALL: {
+        const uint8_t base = (*chunk)[offset + 1];
+        const uint8_t argCount = (*chunk)[offset + 2];
+        println("{:<18} r{} ({} args)", "REG_CALL", base, argCount);
+        return offset + 3;
+    }
+    case opCode::REG_RETURN:
+        return registerInstruction(chunk, "REG_RETURN", offset, 1);
+    case opCode::REG_PRINT:
+        return registerInstruction(chunk, "REG_PRINT", offset, 1);
+    case opCode::TAIL_CALL:
+        return callInstruction(chunk, "TAIL_CALL", offset);
+    case opCode::LOAD_REST:
+        return threeBytesInstruction(chunk, "LOAD_REST", offset);
+    case opCode::LOAD_REST_ITEM:
+        return threeBytesInstruction(chunk, "LOAD_REST_ITEM", offset);
+    case opCode::LOAD_REST_ITER:
+        return threeBytesInstruction(chunk, "LOAD_REST_ITER", offset);
+    case opCode::BREAKPOINT:
+        return simpleInstruction("BREAKPOINT", offset);
     default:
         println("Unknown opcode {:02x}", static_cast<uint8_t>(instruction));
         return -1;
@@ -179,6 +276,61 @@ uint32_t Disassembler::constantInstruction(const Chunk *chunk, String name, uint
 }
 
 // two bytes instruction
+// name16 + inline cache index16
+uint32_t Disassembler::globalInstruction(const Chunk *chunk, String name, uint32_t offset)
+{
+    uint16_t slot = getU16data(chunk->codes_, offset + 1);
+    println("{:<18} {}", name, chunk->globals_->name(slot)->c_str());
+    return offset + 3;
+}
+
+uint32_t Disassembler::fieldInstruction(const Chunk *chunk, String name, uint32_t offset)
+{
+    uint16_t slot = getU16data(chunk->codes_, offset + 1);
+    uint16_t cache = getU16data(chunk->codes_, offset + 3);
+    println("{:<18} {} [ic {}]", name, value_string(chunk->consts_[slot]), cache);
+    return offset + 5;
+}
+
+// name16 + argc8 + inline cache index16
+uint32_t Disassembler::invokeInstruction(const Chunk *chunk, uint32_t offset)
+{
+    uint16_t name = getU16data(chunk->codes_, offset + 1);
+    uint8_t argCount = (*chunk)[offset + 3];
+    uint16_t cache = getU16data(chunk->codes_, offset + 4);
+    println(
+        "{:<18} {} ({} args) [ic {}]",
+        "INVOKE_METHOD",
+        value_string(chunk->consts_[name]),
+        argCount,
+        cache);
+    return offset + 6;
+}
+
+// argc8 + call cache index16, followed by the cached callee when the cache is filled
+uint32_t Disassembler::callInstruction(const Chunk *chunk, String name, uint32_t offset)
+{
+    uint8_t argCount = (*chunk)[offset + 1];
+    uint16_t index = getU16data(chunk->codes_, offset + 2);
+    const CallCache &cache = chunk->call_caches_[index];
+    String state;
+    switch (cache.kind) {
+    case CallCacheKind::FUNCTION:
+        state = format(" function {}", value_string(cache.callee));
+        break;
+    case CallCacheKind::NATIVE:
+        state = format(" native {}", value_string(cache.callee));
+        break;
+    case CallCacheKind::CLASS:
+        state = format(" class {}", value_string(cache.callee));
+        break;
+    case CallCacheKind::NONE:
+        break;
+    }
+    println("{:<18} {} [ic {}{}]", name, argCount, index, state);
+    return offset + 4;
+}
+
 uint32_t Disassembler::twoBytesInstruction(const Chunk *chunk, String name, uint32_t offset)
 {
     const uint8_t n = (*chunk)[offset + 1];
@@ -190,7 +342,7 @@ uint32_t Disassembler::twoBytesInstruction(const Chunk *chunk, String name, uint
 uint32_t Disassembler::threeBytesInstruction(const Chunk *chunk, String name, uint32_t offset)
 {
     uint16_t slot = getU16data(chunk->codes_, offset + 1);
-    if (name == "LOAD_LOCAL" || name == "STORE_LOCAL") {
+    if (name == "LOAD_LOCAL" || name == "STORE_LOCAL" || name.starts_with("LOAD_REST")) {
         println("{:<18} base+{}", name, slot);
     } else if (name == "LOAD_UPVALUE" || name == "STORE_UPVALUE") {
         println("{:<18} upvalue({})", name, slot);
@@ -208,6 +360,15 @@ uint32_t Disassembler::jumpInstruction(const Chunk *chunk, String name, uint32_t
     return offset + 3;
 }
 
+// FOR_ITER slot16 offset16, jumps back to the loop body
+uint32_t Disassembler::forIterInstruction(const Chunk *chunk, uint32_t offset)
+{
+    uint16_t slot = getU16data(chunk->codes_, offset + 1);
+    uint16_t jump = getU16data(chunk->codes_, offset + 3);
+    println("{:<18} base+{} {} -> {}", "FOR_ITER", slot, offset, offset + 5 - jump);
+    return offset + 5;
+}
+
 //  1+3k bytes instruction
 uint32_t Disassembler::closureInstruction(const Chunk *chunk, uint32_t offset)
 {
@@ -225,6 +386,128 @@ uint32_t Disassembler::closureInstruction(const Chunk *chunk, uint32_t offset)
     return offset;
 }
 
+static const char *compareOperator(opCode op)
+{
+    switch (generic_opcode(op)) {
+    case opCode::LESS:
+        return "<";
+    case opCode::LESS_EQUAL:
+        return "<=";
+    case opCode::GREATER:
+        return ">";
+    case opCode::GREATER_EQUAL:
+        return ">=";
+    default:
+        return "?";
+    }
+}
+
+// 11 bytes superinstruction: LOAD_LOCAL, LOAD_CONST, ADD|SUBTRACT, STORE_LOCAL, POP
+uint32_t Disassembler::incLocalInstruction(const Chunk *chunk, uint32_t offset)
+{
+    uint16_t slot = getU16data(chunk->codes_, offset + 1);
+    uint16_t constant = getU16data(chunk->codes_, offset + 4);
+    const char *op =
+        generic_opcode(static_cast<opCode>((*chunk)[offset + 6])) == opCode::ADD ? "+=" : "-=";
+    String constName = value_representation(chunk->consts_[constant]);
+    println("{:<18} base+{} {} ({}) {}", "INC_LOCAL", slot, op, constant, constName);
+    return offset + 11;
+}
+
+// 10 bytes superinstruction: LOAD_LOCAL, LOAD_LOCAL|LOAD_CONST, compare, JUMP_FALSE
+uint32_t Disassembler::compareJumpInstruction(const Chunk *chunk, String name, uint32_t offset)
+{
+    uint16_t lhs = getU16data(chunk->codes_, offset + 1);
+    uint16_t rhs = getU16data(chunk->codes_, offset + 4);
+    const char *op = compareOperator(static_cast<opCode>((*chunk)[offset + 6]));
+    uint16_t jump = getU16data(chunk->codes_, offset + 8);
+    String rhsName = static_cast<opCode>((*chunk)[offset + 3]) == opCode::LOAD_LOCAL
+                         ? format("base+{}", rhs)
+                         : format("({}) {}", rhs, value_representation(chunk->consts_[rhs]));
+    println("{:<18} base+{} {} {} else {} -> {}", name, lhs, op, rhsName, offset, offset + 10 + jump);
+    return offset + 10;
+}
+
+// 24 bytes superinstruction: the INC_LOCAL sequence, the LOCAL_*_CMP_JUMP sequence, JUMP_FWD
+uint32_t Disassembler::forRangeInstruction(const Chunk *chunk, uint32_t offset)
+{
+    uint16_t slot = getU16data(chunk->codes_, offset + 1);
+    uint16_t step = getU16data(chunk->codes_, offset + 4);
+    const char *stepOp =
+        generic_opcode(static_cast<opCode>((*chunk)[offset + 6])) == opCode::ADD ? "+=" : "-=";
+    uint16_t rhs = getU16data(chunk->codes_, offset + 15);
+    const char *op = compareOperator(static_cast<opCode>((*chunk)[offset + 17]));
+    uint16_t jump = getU16data(chunk->codes_, offset + 22);
+    String rhsName = static_cast<opCode>((*chunk)[offset + 14]) == opCode::LOAD_LOCAL
+                         ? format("base+{}", rhs)
+                         : format("({}) {}", rhs, value_representation(chunk->consts_[rhs]));
+    println(
+        "{:<18} base+{} {} {}, while {} {} -> {}",
+        "FOR_RANGE",
+        slot,
+        stepOp,
+        value_representation(chunk->consts_[step]),
+        op,
+        rhsName,
+        offset + 24 - jump);
+    return offset + 24;
+}
+
+// 8 bytes superinstruction: LOAD_LOCAL, LOAD_FIELD
+uint32_t Disassembler::loadLocalFieldInstruction(const Chunk *chunk, uint32_t offset)
+{
+    uint16_t slot = getU16data(chunk->codes_, offset + 1);
+    uint16_t name = getU16data(chunk->codes_, offset + 4);
+    uint16_t cache = getU16data(chunk->codes_, offset + 6);
+    println(
+        "{:<18} base+{} {} [ic {}]",
+        "LOAD_LOCAL_FIELD",
+        slot,
+        value_string(chunk->consts_[name]),
+        cache);
+    return offset + 8;
+}
+
+// opcode + count registers
+uint32_t Disassembler::registerInstruction(const Chunk *chunk, String name, uint32_t offset, int count)
+{
+    String operands;
+    for (int i = 1; i <= count; i++) {
+        operands += format("{}r{}", i == 1 ? "" : " ", (*chunk)[offset + i]);
+    }
+    println("{:<18} {}", name, operands);
+    return offset + 1 + count;
+}
+
+// register8 + global slot16
+uint32_t Disassembler::registerGlobalInstruction(const Chunk *chunk, String name, uint32_t offset)
+{
+    const uint8_t reg = (*chunk)[offset + 1];
+    uint16_t slot = getU16data(chunk->codes_, offset + 2);
+    println("{:<18} r{} {}", name, reg, chunk->globals_->name(slot)->c_str());
+    return offset + 4;
+}
+
+// register8 + forward offset16
+uint32_t Disassembler::registerJumpInstruction(const Chunk *chunk, String name, uint32_t offset)
+{
+    const uint8_t reg = (*chunk)[offset + 1];
+    uint16_t jump = getU16data(chunk->codes_, offset + 2);
+    println("{:<18} r{} {} -> {}", name, reg, offset, offset + 4 + jump);
+    return offset + 4;
+}
+
+// lhs8 + rhs8 + forward offset16, jump if the comparison is false
+uint32_t Disassembler::registerCompareJumpInstruction(
+    const Chunk *chunk, String name, const char *op, uint32_t offset)
+{
+    const uint8_t lhs = (*chunk)[offset + 1];
+    const uint8_t rhs = (*chunk)[offset + 2];
+    uint16_t jump = getU16data(chunk->codes_, offset + 3);
+    println("{:<18} r{} {} r{} else {} -> {}", name, lhs, op, rhs, offset, offset + 5 + jump);
+    return offset + 5;
+}
+
 uint32_t Disassembler::readInstruction(const Chunk *chunk, uint32_t offset)
 {
     if (offset >= chunk->count_) {
@@ -256,9 +539,9 @@ uint32_t Disassembler::readInstruction(const Chunk *chunk, uint32_t offset)
     case opCode::STORE_GLOBAL:
         return offset + 3;
     case opCode::LOAD_FIELD:
-        return offset + 3;
+        return offset + 5;
     case opCode::STORE_FIELD:
-        return offset + 3;
+        return offset + 5;
     case opCode::LOAD_SUBSCR:
         return offset + 1;
     case opCode::STORE_SUBSCR:
@@ -310,12 +593,14 @@ uint32_t Disassembler::readInstruction(const Chunk *chunk, uint32_t offset)
     case opCode::JUMP_FALSE_NOPOP:
         return offset + 3;
     case opCode::CALL:
-        return offset + 2;
+        return offset + 4;
+    case opCode::INVOKE_METHOD:
+        return offset + 6;
     case opCode::CLOSURE: {
         uint16_t funIndex = getU16data(chunk->codes_, offset + 1);
         offset += 3;
         ObjFunction *function = as_obj_function(chunk->consts_[funIndex]);
-        offset += 2 * function->upvalue_count_;
+        offset += 3 * function->upvalue_count_;
         return offset;
     }
     case opCode::MAKE_CLASS:
@@ -336,21 +621,288 @@ uint32_t Disassembler::readInstruction(const Chunk *chunk, uint32_t offset)
         return offset + 3;
     case opCode::GET_ITER:
         return offset + 1;
-    case opCode::ITER_HAS_NEXT:
+    case opCode::FOR_ITER:
+        return offset + 5;
+    case opCode::THROW:
         return offset + 1;
-    case opCode::ITER_GET_NEXT:
+    case opCode::RETURN:
         return offset + 1;
-    case opCode::SETUP_EXCEPT:
-        return offset + 3;
-    case opCode::END_EXCEPT:
+    case opCode::INC_LOCAL:
+        return offset + 11;
+    case opCode::LOCAL_LOCAL_CMP_JUMP:
+        return offset + 10;
+    case opCode::LOCAL_CONST_CMP_JUMP:
+        return offset + 10;
+    case opCode::LOAD_LOCAL_FIELD:
+        return offset + 8;
+    case opCode::FOR_RANGE:
+        return offset + 24;
+    case opCode::ADD_NUM:
         return offset + 1;
-    case opCode::THROW:
+    case opCode::SUBTRACT_NUM:
         return offset + 1;
-    case opCode::RETURN:
+    case opCode::MULTIPLY_NUM:
+        return offset + 1;
+    case opCode::DIVIDE_NUM:
+        return offset + 1;
+    case opCode::MOD_NUM:
+        return offset + 1;
+    case opCode::GREATER_NUM:
+        return offset + 1;
+    case opCode::GREATER_EQUAL_NUM:
         return offset + 1;
+    case opCode::LESS_NUM:
+        return offset + 1;
+    case opCode::LESS_EQUAL_NUM:
+        return offset + 1;
+    case opCode::REG_MOVE:
+    case opCode::REG_NOT:
+    case opCode::REG_NEGATE:
+    case opCode::REG_CALL:
+        return offset + 3;
+    case opCode::REG_LOAD_GLOBAL:
+    case opCode::REG_STORE_GLOBAL:
+    case opCode::REG_ADD:
+    case opCode::REG_SUBTRACT:
+    case opCode::REG_MULTIPLY:
+    case opCode::REG_DIVIDE:
+    case opCode::REG_MOD:
+    case opCode::REG_EQUAL:
+    case opCode::REG_NOT_EQUAL:
+    case opCode::REG_GREATER:
+    case opCode::REG_GREATER_EQUAL:
+    case opCode::REG_LESS:
+    case opCode::REG_LESS_EQUAL:
+    case opCode::REG_JUMP_TRUE:
+    case opCode::REG_JUMP_FALSE:
+        return offset + 4;
+    case opCode::REG_EQUAL_JUMP:
+    case opCode::REG_NOT_EQUAL_JUMP:
+    case opCode::REG_GREATER_JUMP:
+    case opCode::REG_GREATER_EQUAL_JUMP:
+    case opCode::REG_LESS_JUMP:
+    case opCode::REG_LESS_EQUAL_JUMP:
+        return offset + 5;
+    case opCode::TAIL_CALL:
+        return offset + 4;
+    case opCode::LOAD_REST:
+    case opCode::LOAD_REST_ITEM:
+    case opCode::LOAD_REST_ITER:
+        return offset + 3;
+    case opCode::REG_RETURN:
+    case opCode::REG_PRINT:
+        return offset + 2;
     default:
         return offset + 1;
     }
 }
 
+const char *Disassembler::opcodeName(opCode op)
+{
+    switch (op) {
+    case opCode::LOAD_CONST:
+        return "LOAD_CONST";
+    case opCode::LOAD_NIL:
+        return "LOAD_NIL";
+    case opCode::LOAD_TRUE:
+        return "LOAD_TRUE";
+    case opCode::LOAD_FALSE:
+        return "LOAD_FALSE";
+    case opCode::LOAD_LOCAL:
+        return "LOAD_LOCAL";
+    case opCode::STORE_LOCAL:
+        return "STORE_LOCAL";
+    case opCode::LOAD_UPVALUE:
+        return "LOAD_UPVALUE";
+    case opCode::STORE_UPVALUE:
+        return "STORE_UPVALUE";
+    case opCode::CLOSE_UPVALUE:
+        return "CLOSE_UPVALUE";
+    case opCode::DEF_GLOBAL:
+        return "DEF_GLOBAL";
+    case opCode::LOAD_GLOBAL:
+        return "LOAD_GLOBAL";
+    case opCode::STORE_GLOBAL:
+        return "STORE_GLOBAL";
+    case opCode::LOAD_FIELD:
+        return "LOAD_FIELD";
+    case opCode::STORE_FIELD:
+        return "STORE_FIELD";
+    case opCode::LOAD_SUBSCR:
+        return "LOAD_SUBSCR";
+    case opCode::STORE_SUBSCR:
+        return "STORE_SUBSCR";
+    case opCode::EQUAL:
+        return "EQUAL";
+    case opCode::NOT_EQUAL:
+        return "NOT_EQUAL";
+    case opCode::GREATER:
+        return "GREATER";
+    case opCode::GREATER_EQUAL:
+        return "GREATER_EQUAL";
+    case opCode::LESS:
+        return "LESS";
+    case opCode::LESS_EQUAL:
+        return "LESS_EQUAL";
+    case opCode::ADD:
+        return "ADD";
+    case opCode::SUBTRACT:
+        return "SUBTRACT";
+    case opCode::MULTIPLY:
+        return "MULTIPLY";
+    case opCode::DIVIDE:
+        return "DIVIDE";
+    case opCode::MOD:
+        return "MOD";
+    case opCode::NOT:
+        return "NOT";
+    case opCode::NEGATE:
+        return "NEGATE";
+    case opCode::POP:
+        return "POP";
+    case opCode::POP_N:
+        return "POP_N";
+    case opCode::PRINT:
+        return "PRINT";
+    case opCode::NOP:
+        return "NOP";
+    case opCode::JUMP_FWD:
+        return "JUMP_FWD";
+    case opCode::JUMP_BWD:
+        return "JUMP_BWD";
+    case opCode::JUMP_TRUE:
+        return "JUMP_TRUE";
+    case opCode::JUMP_TRUE_NOPOP:
+        return "JUMP_TRUE_NOPOP";
+    case opCode::JUMP_FALSE:
+        return "JUMP_FALSE";
+    case opCode::JUMP_FALSE_NOPOP:
+        return "JUMP_FALSE_NOPOP";
+    case opCode::CALL:
+        return "CALL";
+    case opCode::CLOSURE:
+        return "CLOSURE";
+    case opCode::MAKE_CLASS:
+        return "MAKE_CLASS";
+    case opCode::INHERIT:
+        return "INHERIT";
+    case opCode::MAKE_METHOD:
+        return "MAKE_METHOD";
+    case opCode::MAKE_INIT_METHOD:
+        return "MAKE_INIT_METHOD";
+    case opCode::INVOKE_METHOD:
+        return "INVOKE_METHOD";
+    case opCode::LOAD_SUPER_METHOD:
+        return "LOAD_SUPER_METHOD";
+    case opCode::MAKE_LIST:
+        return "MAKE_LIST";
+    case opCode::MAKE_MAP:
+        return "MAKE_MAP";
+    case opCode::IMPORT:
+        return "IMPORT";
+    case opCode::GET_ITER:
+        return "GET_ITER";
+    case opCode::FOR_ITER:
+        return "FOR_ITER";
+    case opCode::THROW:
+        return "THROW";
+    case opCode::RETURN:
+        return "RETURN";
+    case opCode::INC_LOCAL:
+        return "INC_LOCAL";
+    case opCode::LOCAL_LOCAL_CMP_JUMP:
+        return "LOCAL_LOCAL_CMP_JUMP";
+    case opCode::LOCAL_CONST_CMP_JUMP:
+        return "LOCAL_CONST_CMP_JUMP";
+    case opCode::LOAD_LOCAL_FIELD:
+        return "LOAD_LOCAL_FIELD";
+    case opCode::FOR_RANGE:
+        return "FOR_RANGE";
+    case opCode::ADD_NUM:
+        return "ADD_NUM";
+    case opCode::SUBTRACT_NUM:
+        return "SUBTRACT_NUM";
+    case opCode::MULTIPLY_NUM:
+        return "MULTIPLY_NUM";
+    case opCode::DIVIDE_NUM:
+        return "DIVIDE_NUM";
+    case opCode::MOD_NUM:
+        return "MOD_NUM";
+    case opCode::GREATER_NUM:
+        return "GREATER_NUM";
+    case opCode::GREATER_EQUAL_NUM:
+        return "GREATER_EQUAL_NUM";
+    case opCode::LESS_NUM:
+        return "LESS_NUM";
+    case opCode::LESS_EQUAL_NUM:
+        return "LESS_EQUAL_NUM";
+    case opCode::REG_MOVE:
+        return "REG_MOVE";
+    case opCode::REG_LOAD_GLOBAL:
+        return "REG_LOAD_GLOBAL";
+    case opCode::REG_STORE_GLOBAL:
+        return "REG_STORE_GLOBAL";
+    case opCode::REG_ADD:
+        return "REG_ADD";
+    case opCode::REG_SUBTRACT:
+        return "REG_SUBTRACT";
+    case opCode::REG_MULTIPLY:
+        return "REG_MULTIPLY";
+    case opCode::REG_DIVIDE:
+        return "REG_DIVIDE";
+    case opCode::REG_MOD:
+        return "REG_MOD";
+    case opCode::REG_EQUAL:
+        return "REG_EQUAL";
+    case opCode::REG_NOT_EQUAL:
+        return "REG_NOT_EQUAL";
+    case opCode::REG_GREATER:
+        return "REG_GREATER";
+    case opCode::REG_GREATER_EQUAL:
+        return "REG_GREATER_EQUAL";
+    case opCode::REG_LESS:
+        return "REG_LESS";
+    case opCode::REG_LESS_EQUAL:
+        return "REG_LESS_EQUAL";
+    case opCode::REG_NOT:
+        return "REG_NOT";
+    case opCode::REG_NEGATE:
+        return "REG_NEGATE";
+    case opCode::REG_JUMP_TRUE:
+        return "REG_JUMP_TRUE";
+    case opCode::REG_JUMP_FALSE:
+        return "REG_JUMP_FALSE";
+    case opCode::REG_EQUAL_JUMP:
+        return "REG_EQUAL_JUMP";
+    case opCode::REG_NOT_EQUAL_JUMP:
+        return "REG_NOT_EQUAL_JUMP";
+    case opCode::REG_GREATER_JUMP:
+        return "REG_GREATER_JUMP";
+    case opCode::REG_GREATER_EQUAL_JUMP:
+        return "REG_GREATER_EQUAL_JUMP";
+    case opCode::REG_LESS_JUMP:
+        return "REG_LESS_JUMP";
+    case opCode::REG_LESS_EQUAL_JUMP:
+        return "REG_LESS_EQUAL_JUMP";
+    case opCode::REG_CALL:
+        return "REG_CALL";
+    case opCode::REG_RETURN:
+        return "REG_RETURN";
+    case opCode::REG_PRINT:
+        return "REG_PRINT";
+    case opCode::TAIL_CALL:
+        return "TAIL_CALL";
+    case opCode::LOAD_REST:
+        return "LOAD_REST";
+    case opCode::LOAD_REST_ITEM:
+        return "LOAD_REST_ITEM";
+    case opCode::LOAD_REST_ITER:
+        return "LOAD_REST_ITER";
+    case opCode::BREAKPOINT:
+        return "BREAKPOINT";
+    default:
+        return "UNKNOWN";
+    }
+}
+
 } // namespace aria
\ No newline at end of file
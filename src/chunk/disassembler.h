@@ -19,6 +19,14 @@ public:
 
     static uint32_t constantInstruction(const Chunk *chunk, String name, uint32_t offset);
 
+    static uint32_t globalInstruction(const Chunk *chunk, String name, uint32_t offset);
+
+    static uint32_t fieldInstruction(const Chunk *chunk, String name, uint32_t offset);
+
+    static uint32_t invokeInstruction(const Chunk *chunk, uint32_t offset);
+
+    static uint32_t callInstruction(const Chunk *chunk, String name, uint32_t offset);
+
     static uint32_t twoBytesInstruction(const Chunk *chunk, String name, uint32_t offset);
 
     static uint32_t threeBytesInstruction(const Chunk *chunk, String name, uint32_t offset);
@@ -27,7 +35,28 @@ public:
 
     static uint32_t closureInstruction(const Chunk *chunk, uint32_t offset);
 
+    static uint32_t incLocalInstruction(const Chunk *chunk, uint32_t offset);
+
+    static uint32_t forIterInstruction(const Chunk *chunk, uint32_t offset);
+
+    static uint32_t compareJumpInstruction(const Chunk *chunk, String name, uint32_t offset);
+
+    static uint32_t forRangeInstruction(const Chunk *chunk, uint32_t offset);
+
+    static uint32_t loadLocalFieldInstruction(const Chunk *chunk, uint32_t offset);
+
+    static uint32_t registerInstruction(const Chunk *chunk, String name, uint32_t offset, int count);
+
+    static uint32_t registerGlobalInstruction(const Chunk *chunk, String name, uint32_t offset);
+
+    static uint32_t registerJumpInstruction(const Chunk *chunk, String name, uint32_t offset);
+
+    static uint32_t registerCompareJumpInstruction(
+        const Chunk *chunk, String name, const char *op, uint32_t offset);
+
     static uint32_t readInstruction(const Chunk *chunk, uint32_t offset);
+
+    static const char *opcodeName(opCode op);
 };
 
 } // namespace aria
@@ -0,0 +1,166 @@
+#include "chunk/peephole.h"
+#include "chunk/chunk.h"
+#include "chunk/disassembler.h"
+#include "object/objFunction.h"
+
+namespace aria {
+
+namespace {
+
+struct Instruction
+{
+    uint32_t offset;
+    opCode op;
+};
+
+uint16_t wordAt(const Chunk *chunk, uint32_t offset)
+{
+    return static_cast<uint16_t>(chunk->codes_[offset] | (chunk->codes_[offset + 1] << 8));
+}
+
+bool isNumberConst(const Chunk *chunk, uint32_t offset)
+{
+    return NanBox::isNumber(chunk->consts_[wordAt(chunk, offset + 1)]);
+}
+
+bool isNumericCompare(opCode op)
+{
+    return op == opCode::LESS || op == opCode::LESS_EQUAL || op == opCode::GREATER
+           || op == opCode::GREATER_EQUAL;
+}
+
+// 标记所有跳转目标；被融合序列的内部指令不能是跳转目标
+List<bool> collectJumpTargets(const Chunk *chunk, const List<Instruction> &instructions)
+{
+    List<bool> targets(chunk->count_ + 1, false);
+    for (const auto &[offset, op] : instructions) {
+        switch (op) {
+        case opCode::JUMP_FWD:
+            targets[offset + 3 - wordAt(chunk, offset + 1)] = true;
+            break;
+        case opCode::JUMP_BWD:
+        case opCode::JUMP_TRUE:
+        case opCode::JUMP_TRUE_NOPOP:
+        case opCode::JUMP_FALSE:
+        case opCode::JUMP_FALSE_NOPOP:
+            targets[offset + 3 + wordAt(chunk, offset + 1)] = true;
+            break;
+        case opCode::LOCAL_LOCAL_CMP_JUMP:
+        case opCode::LOCAL_CONST_CMP_JUMP:
+            targets[offset + 10 + wordAt(chunk, offset + 8)] = true;
+            break;
+        case opCode::FOR_ITER:
+            targets[offset + 5 - wordAt(chunk, offset + 3)] = true;
+            break;
+        case opCode::FOR_RANGE:
+            targets[offset + 24 - wordAt(chunk, offset + 22)] = true;
+            break;
+        default:
+            break;
+        }
+    }
+    // 超级指令不能跨越 try 块的边界，handler 也是跳转目标
+    for (const auto &handler : chunk->handlers_) {
+        targets[handler.start] = true;
+        targets[handler.end] = true;
+        targets[handler.handler] = true;
+    }
+    return targets;
+}
+
+// LOAD_LOCAL a; LOAD_CONST k; ADD|SUBTRACT; STORE_LOCAL a; POP
+bool matchIncLocal(const Chunk *chunk, const Instruction *ins)
+{
+    return ins[0].op == opCode::LOAD_LOCAL && ins[1].op == opCode::LOAD_CONST
+           && isNumberConst(chunk, ins[1].offset)
+           && (ins[2].op == opCode::ADD || ins[2].op == opCode::SUBTRACT)
+           && ins[3].op == opCode::STORE_LOCAL
+           && wordAt(chunk, ins[0].offset + 1) == wordAt(chunk, ins[3].offset + 1)
+           && ins[4].op == opCode::POP;
+}
+
+// LOAD_LOCAL a; LOAD_LOCAL b | LOAD_CONST k; LESS|LESS_EQUAL|GREATER|GREATER_EQUAL; JUMP_FALSE
+bool matchCompareJump(const Chunk *chunk, const Instruction *ins)
+{
+    return ins[0].op == opCode::LOAD_LOCAL
+           && (ins[1].op == opCode::LOAD_LOCAL
+               || (ins[1].op == opCode::LOAD_CONST && isNumberConst(chunk, ins[1].offset)))
+           && isNumericCompare(ins[2].op) && ins[3].op == opCode::JUMP_FALSE;
+}
+
+// 计数循环的回边：自增 a，再比较 a，为假时跳出（JUMP_FALSE 恰好越过 JUMP_FWD），否则跳回循环体
+bool matchForRange(const Chunk *chunk, const Instruction *ins)
+{
+    return matchIncLocal(chunk, ins) && matchCompareJump(chunk, ins + 5)
+           && wordAt(chunk, ins[5].offset + 1) == wordAt(chunk, ins[0].offset + 1)
+           && ins[8].offset + 3 + wordAt(chunk, ins[8].offset + 1) == ins[9].offset + 3
+           && ins[9].op == opCode::JUMP_FWD;
+}
+
+// LOAD_LOCAL a; LOAD_FIELD name
+bool matchLoadLocalField(const Instruction *ins)
+{
+    return ins[0].op == opCode::LOAD_LOCAL && ins[1].op == opCode::LOAD_FIELD;
+}
+
+} // namespace
+
+void Peephole::optimize(ObjFunction *function)
+{
+    Chunk *chunk = function->chunk_;
+    // 寄存器后端生成的代码没有可融合的栈式指令序列
+    if (function->frame_size_ == 0) {
+        optimizeChunk(chunk);
+    }
+    for (uint32_t i = 0; i < chunk->consts_.size(); i++) {
+        if (is_obj_function(chunk->consts_[i])) {
+            optimize(as_obj_function(chunk->consts_[i]));
+        }
+    }
+}
+
+void Peephole::optimizeChunk(Chunk *chunk)
+{
+    List<Instruction> instructions;
+    for (uint32_t offset = 0; offset < chunk->count_;) {
+        instructions.push_back({offset, static_cast<opCode>(chunk->codes_[offset])});
+        offset = Disassembler::readInstruction(chunk, offset);
+    }
+    auto targets = collectJumpTargets(chunk, instructions);
+
+    auto fusible = [&](size_t begin, size_t length) {
+        if (begin + length > instructions.size()) {
+            return false;
+        }
+        for (size_t i = begin + 1; i < begin + length; i++) {
+            if (targets[instructions[i].offset]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (size_t i = 0; i < instructions.size();) {
+        const Instruction *ins = &instructions[i];
+        uint8_t *code = chunk->codes_ + ins->offset;
+        if (fusible(i, 10) && matchForRange(chunk, ins)) {
+            *code = static_cast<uint8_t>(opCode::FOR_RANGE);
+            i += 10;
+        } else if (fusible(i, 5) && matchIncLocal(chunk, ins)) {
+            *code = static_cast<uint8_t>(opCode::INC_LOCAL);
+            i += 5;
+        } else if (fusible(i, 4) && matchCompareJump(chunk, ins)) {
+            *code = static_cast<uint8_t>(
+                ins[1].op == opCode::LOAD_LOCAL ? opCode::LOCAL_LOCAL_CMP_JUMP
+                                                : opCode::LOCAL_CONST_CMP_JUMP);
+            i += 4;
+        } else if (fusible(i, 2) && matchLoadLocalField(ins)) {
+            *code = static_cast<uint8_t>(opCode::LOAD_LOCAL_FIELD);
+            i += 2;
+        } else {
+            i++;
+        }
+    }
+}
+
+} // namespace aria
@@ -0,0 +1,26 @@
+#ifndef ARIA_PEEPHOLE_H
+#define ARIA_PEEPHOLE_H
+
+#include "chunk/code.h"
+
+namespace aria {
+
+class Chunk;
+class ObjFunction;
+
+// 代码生成之后的窥孔优化：把热点指令序列改写为超级指令。
+// 改写是"等长"的：只替换序列第一条指令的操作码，其余字节原样保留，
+// 因此 lines_、跳转偏移以及调试器记录的指令地址都不需要修正；
+// 超级指令的守卫失败时退化为第一条 LOAD_LOCAL，然后继续执行原始指令。
+class Peephole
+{
+public:
+    // optimize function and all functions nested in its constant pool
+    static void optimize(ObjFunction *function);
+
+    static void optimizeChunk(Chunk *chunk);
+};
+
+} // namespace aria
+
+#endif //ARIA_PEEPHOLE_H
@@ -1,6 +1,7 @@
 #include "compile/byteCodeGenerator.h"
 #include "compile/ast.h"
 #include "compile/functionContext.h"
+#include "compile/registerGenerator.h"
 #include "object/objFunction.h"
 #include "object/objString.h"
 
@@ -38,6 +39,33 @@ static bool isSuperVarNode(const ASTNode *node)
     return false;
 }
 
+// obj.method(args)，super.method(args) 除外
+static bool isInvokeCall(const CallExprNode *node)
+{
+    auto field = dynamic_cast<const FieldExprNode *>(node->callee.get());
+    return field != nullptr && !isSuperVarNode(field->receiver.get());
+}
+
+// i < n、i <= 10 这类没有副作用的比较，可以在循环头和循环尾各生成一份
+static bool isCountedLoopCondition(const ASTNode *node)
+{
+    auto binary = dynamic_cast<const BinaryExprNode *>(node);
+    if (binary == nullptr) {
+        return false;
+    }
+    const auto t = binary->opToken.type;
+    if (t != TokenType::LESS && t != TokenType::LESS_EQUAL && t != TokenType::GREATER
+        && t != TokenType::GREATER_EQUAL) {
+        return false;
+    }
+    auto plainVar = [](const ASTNode *operand) {
+        auto var = dynamic_cast<const VarNode *>(operand);
+        return var != nullptr && var->tag == VarTag::VAR;
+    };
+    return plainVar(binary->lhs.get())
+           && (plainVar(binary->rhs.get()) || dynamic_cast<const NumberNode *>(binary->rhs.get()));
+}
+
 static void checkAssignFlag(ASTNode *node)
 {
     if (node->asLvalue) {
@@ -68,8 +96,13 @@ static void declareLocalVariable(FunctionContext *context, const Token &nameToke
 }
 
 ByteCodeGenerator::ByteCodeGenerator(
-    const String &_moduleName, const String &_moduleLocation, ValueHashTable *_globals, GC *_gc)
+    const String &_moduleName,
+    const String &_moduleLocation,
+    GlobalTable *_globals,
+    GC *_gc,
+    CodeBackend _backend)
     : context{new FunctionContext{_moduleName, _moduleLocation, _globals, _gc}}
+    , backend{_backend}
 {}
 
 ByteCodeGenerator::~ByteCodeGenerator()
@@ -103,18 +136,21 @@ FunctionContext *ByteCodeGenerator::createLocalFunctionContext(
         node->acceptsVarargs};
 }
 
-void ByteCodeGenerator::defineFunction(
-    ObjFunction *fun, const Token &funNameToken, uint32_t line) const
+// 局部函数在生成函数体之前声明，函数体可以通过 upvalue 递归引用自己
+void ByteCodeGenerator::declareFunction(const Token &funNameToken) const
 {
-    Chunk *chunk = context->chunk;
-
-    chunk->emit_op_value(opCode::LOAD_CONST, NanBox::fromObj(fun), line);
     if (context->scopeDepth > 0) {
         checkDefine(context, funNameToken);
         declareLocalVariable(context, funNameToken);
         context->finalizeLocal();
-    } else {
-        chunk->emit_op_value(opCode::DEF_GLOBAL, NanBox::fromObj(fun->name_), line);
+    }
+}
+
+// 函数值已由 emitClosure 压栈：局部函数就留在声明的槽位上，全局函数再定义为全局变量
+void ByteCodeGenerator::defineFunction(ObjFunction *fun, uint32_t line) const
+{
+    if (context->scopeDepth == 0) {
+        context->chunk->emit_global(opCode::DEF_GLOBAL, fun->name_, line);
     }
 }
 
@@ -129,15 +165,18 @@ void ByteCodeGenerator::defineParam(const Token &paramNameToken) const
     context->finalizeLocal();
 }
 
+// push the function value: the prototype itself, or a new closure when it captures variables
 void ByteCodeGenerator::emitClosure(Chunk *chunk, ObjFunction *fun, uint32_t line)
 {
-    fun->initUpvalues();
-    if (fun->upvalue_count_ != 0) {
-        chunk->emit_op_value(opCode::CLOSURE, NanBox::fromObj(fun), line);
-        for (int i = 0; i < fun->upvalue_count_; i++) {
-            chunk->emit_byte(context->upvalues[i].isLocal ? 1 : 0, line);
-            chunk->emit_word(context->upvalues[i].index, line);
-        }
+    // 使用 super 的方法即使不捕获变量也要生成闭包，MAKE_METHOD 在闭包上记录定义它的类
+    if (fun->upvalue_count_ == 0 && !context->usesSuper) {
+        chunk->emit_op_value(opCode::LOAD_CONST, NanBox::fromObj(fun), line);
+        return;
+    }
+    chunk->emit_op_value(opCode::CLOSURE, NanBox::fromObj(fun), line);
+    for (int i = 0; i < fun->upvalue_count_; i++) {
+        chunk->emit_byte(context->upvalues[i].isLocal ? 1 : 0, line);
+        chunk->emit_word(context->upvalues[i].index, line);
     }
 }
 
@@ -146,17 +185,21 @@ void ByteCodeGenerator::visitFunDeclNode(FunDeclNode *node)
     FunctionContext *innerCtx = createLocalFunctionContext(node, FunctionType::FUNCTION);
     ObjFunction *fun = innerCtx->currentFunction();
     Chunk *outerCtxChunk = context->chunk;
-    defineFunction(fun, node->funNameToken, node->endLine);
+    declareFunction(node->funNameToken);
     context = innerCtx;
 
-    // Call beginScope() then all parameters will be local variables
-    context->beginScope();
-    for (auto &param : node->params) {
-        defineParam(param);
-    }
+    // 寄存器后端不支持的函数照常生成栈式字节码
+    if (backend != CodeBackend::REGISTER || !RegisterGenerator{context}.generate(node)) {
+        // Call beginScope() then all parameters will be local variables
+        context->beginScope();
+        for (auto &param : node->params) {
+            defineParam(param);
+        }
 
-    node->body->accept(*this);
-    context->chunk->emit_fun_end_ret(context->chunk->line_of_last_code());
+        node->body->accept(*this);
+        context->chunk->emit_fun_end_ret(context->chunk->line_of_last_code());
+        fun->lazy_varargs_ = context->restSlot >= 0 && !context->restEscapes;
+    }
     emitClosure(outerCtxChunk, fun, node->endLine);
 
 #ifdef DEBUG_PRINT_COMPILED_CODE
@@ -165,6 +208,7 @@ void ByteCodeGenerator::visitFunDeclNode(FunDeclNode *node)
 
     context = context->enclosing;
     delete innerCtx;
+    defineFunction(fun, node->endLine);
 }
 
 void ByteCodeGenerator::genInheritCode(const Token &superClassNameToken)
@@ -188,7 +232,6 @@ ObjString *ByteCodeGenerator::genMethodCode(ASTNode *node)
     FunctionContext *innerCtx = createLocalFunctionContext(method, methodType);
     context = innerCtx;
     ObjFunction *function = context->fun;
-    chunk->emit_op_value(opCode::LOAD_CONST, NanBox::fromObj(function), chunk->line_of_last_code());
 
     context->beginScope();
 
@@ -199,6 +242,7 @@ ObjString *ByteCodeGenerator::genMethodCode(ASTNode *node)
     method->body->accept(*this);
 
     context->chunk->emit_fun_end_ret(endLine, isInit);
+    function->lazy_varargs_ = context->restSlot >= 0 && !context->restEscapes;
 
     emitClosure(chunk, function, endLine);
 
@@ -223,10 +267,8 @@ void ByteCodeGenerator::defineAndLoadClass(const Token &className)
         chunk->emit_op_arg16(
             opCode::LOAD_LOCAL, static_cast<uint16_t>(localSlot), chunk->line_of_last_code());
     } else {
-        chunk->emit_op_value(
-            opCode::DEF_GLOBAL, NanBox::fromObj(classNameObj), chunk->line_of_last_code());
-        chunk->emit_op_value(
-            opCode::LOAD_GLOBAL, NanBox::fromObj(classNameObj), chunk->line_of_last_code());
+        chunk->emit_global(opCode::DEF_GLOBAL, classNameObj, chunk->line_of_last_code());
+        chunk->emit_global(opCode::LOAD_GLOBAL, classNameObj, chunk->line_of_last_code());
     }
 }
 
@@ -284,8 +326,8 @@ void ByteCodeGenerator::defineGlobalVar(const VarDeclNode *node, int index)
 
     node->exprs[index]->accept(*this);
 
-    const Value name_obj = NanBox::fromObj(new_ObjString(varName, context->gc));
-    context->chunk->emit_op_value(opCode::DEF_GLOBAL, name_obj, varLine);
+    ObjString *name_obj = new_ObjString(varName, context->gc);
+    context->chunk->emit_global(opCode::DEF_GLOBAL, name_obj, varLine);
 }
 
 void ByteCodeGenerator::visitVarDeclNode(VarDeclNode *node)
@@ -385,29 +427,52 @@ void ByteCodeGenerator::visitForStmtNode(ForStmtNode *node)
 
     setupLoopContext();
 
-    auto loopStart = chunk->count_;
-
-    int64_t exitJump = -1;
-    if (node->condition != nullptr) {
+    if (node->increment != nullptr && isCountedLoopCondition(node->condition.get())) {
+        // counted loops are rotated: the condition is checked once before entering and again
+        // after the increment, so the peephole pass can fuse the increment, the comparison
+        // and the back-edge into a single FOR_RANGE
         node->condition->accept(*this);
-        exitJump = chunk->emit_jump(opCode::JUMP_FALSE, chunk->line_of_last_code());
-    }
+        uint32_t entryJump = chunk->emit_jump(opCode::JUMP_FALSE, chunk->line_of_last_code());
+        uint32_t bodyStart = chunk->count_;
 
-    node->body->accept(*this);
+        node->body->accept(*this);
 
-    auto incrementStart = chunk->count_;
-    if (node->increment != nullptr) {
+        auto incrementStart = chunk->count_;
         node->increment->accept(*this);
         chunk->emit_op(opCode::POP);
-    }
-
-    uint32_t loopEnd = chunk->emit_jump(opCode::JUMP_FWD, chunk->line_of_last_code());
-    chunk->patch_jump(loopEnd, loopStart);
-    if (exitJump != -1) {
+        node->condition->accept(*this);
+        uint32_t exitJump = chunk->emit_jump(opCode::JUMP_FALSE, chunk->line_of_last_code());
+        uint32_t loopEnd = chunk->emit_jump(opCode::JUMP_FWD, chunk->line_of_last_code());
+        chunk->patch_jump(loopEnd, bodyStart);
         chunk->patch_jump(exitJump);
-    }
+        chunk->patch_jump(entryJump);
+
+        patchLoopControlJumps(incrementStart);
+    } else {
+        auto loopStart = chunk->count_;
+
+        int64_t exitJump = -1;
+        if (node->condition != nullptr) {
+            node->condition->accept(*this);
+            exitJump = chunk->emit_jump(opCode::JUMP_FALSE, chunk->line_of_last_code());
+        }
+
+        node->body->accept(*this);
 
-    patchLoopControlJumps(incrementStart);
+        auto incrementStart = chunk->count_;
+        if (node->increment != nullptr) {
+            node->increment->accept(*this);
+            chunk->emit_op(opCode::POP);
+        }
+
+        uint32_t loopEnd = chunk->emit_jump(opCode::JUMP_FWD, chunk->line_of_last_code());
+        chunk->patch_jump(loopEnd, loopStart);
+        if (exitJump != -1) {
+            chunk->patch_jump(exitJump);
+        }
+
+        patchLoopControlJumps(incrementStart);
+    }
 
     teardownLoopContext();
 
@@ -420,14 +485,26 @@ void ByteCodeGenerator::visitForInStmtNode(ForInStmtNode *node)
     Token tk_loop_var_name = node->iterNameToken;
     Token tk_iter_name = node->iterNameToken;
     tk_iter_name.text = "__" + tk_iter_name.text + "__ITER__";
+    Token tk_cursor_name = node->iterNameToken;
+    tk_cursor_name.text = "__" + tk_cursor_name.text + "__CURSOR__";
 
     Chunk *chunk = context->chunk;
     context->beginScope();
 
-    // init iterator and loopVar
+    // three consecutive slots: the iterated object, the cursor and the loop variable,
+    // GET_ITER pushes the first two
     declareLocalVariable(context, tk_iter_name);
-    node->expr->accept(*this);
-    chunk->emit_op(opCode::GET_ITER);
+    int restSlot = restSlotOf(node->expr.get());
+    if (restSlot >= 0) {
+        // iterate the rest parameter without materializing its list
+        chunk->emit_op_arg16(
+            opCode::LOAD_REST_ITER, static_cast<uint16_t>(restSlot), node->iterNameToken.line);
+    } else {
+        node->expr->accept(*this);
+        chunk->emit_op(opCode::GET_ITER);
+    }
+    context->finalizeLocal();
+    declareLocalVariable(context, tk_cursor_name);
     context->finalizeLocal();
     declareLocalVariable(context, tk_loop_var_name);
     chunk->emit_op(opCode::LOAD_NIL);
@@ -435,34 +512,18 @@ void ByteCodeGenerator::visitForInStmtNode(ForInStmtNode *node)
 
     setupLoopContext();
 
-    uint32_t loopStart = chunk->count_;
-
-    // get iterator.hasNext
-    int iterSlot = context->findLocalVariable(tk_iter_name.text);
-    chunk->emit_op_arg16(
-        opCode::LOAD_LOCAL, static_cast<uint16_t>(iterSlot), chunk->line_of_last_code());
-    chunk->emit_op(opCode::ITER_HAS_NEXT);
-    uint32_t exitJump = chunk->emit_jump(opCode::JUMP_FALSE, chunk->line_of_last_code());
-
-    // store loopVar
-    int loopVarSlot = context->findLocalVariable(tk_loop_var_name.text);
-    chunk->emit_op_arg16(
-        opCode::LOAD_LOCAL, static_cast<uint16_t>(iterSlot), chunk->line_of_last_code());
-    chunk->emit_op(opCode::ITER_GET_NEXT);
-    chunk->emit_op_arg16(
-        opCode::STORE_LOCAL, static_cast<uint16_t>(loopVarSlot), chunk->line_of_last_code());
-    chunk->emit_op(opCode::POP);
+    // the condition is at the bottom of the loop: each iteration dispatches a single FOR_ITER
+    uint32_t entryJump = chunk->emit_jump(opCode::JUMP_BWD, chunk->line_of_last_code());
+    uint32_t bodyStart = chunk->count_;
 
     node->body->accept(*this);
 
-    uint32_t incrementStart = chunk->count_;
-
-    uint32_t loopEnd = chunk->emit_jump(opCode::JUMP_FWD, chunk->line_of_last_code());
-    chunk->patch_jump(loopEnd, loopStart);
-
-    chunk->patch_jump(exitJump);
+    uint32_t forIterStart = chunk->count_;
+    chunk->patch_jump(entryJump);
+    int iterSlot = context->findLocalVariable(tk_iter_name.text);
+    chunk->emit_for_iter(static_cast<uint16_t>(iterSlot), bodyStart, chunk->line_of_last_code());
 
-    patchLoopControlJumps(incrementStart);
+    patchLoopControlJumps(forIterStart);
 
     teardownLoopContext();
 
@@ -514,7 +575,20 @@ void ByteCodeGenerator::visitReturnStmtNode(ReturnStmtNode *node)
             "Can't return a value from an initializer.\n{}", node->returnToken.info());
         throw ariaCompilingException{ErrorCode::SEMANTIC_INVALID_RETURN, msg};
     }
-    node->expr->accept(*this);
+    // return f(args) 编译为 TAIL_CALL，复用当前栈帧；try/catch 块内的异常帧引用着当前栈帧，照常调用
+    auto call = dynamic_cast<CallExprNode *>(node->expr.get());
+    if (call != nullptr && !isInvokeCall(call) && context->tryDepth == 0) {
+        call->callee->accept(*this);
+        for (const auto &arg : call->args) {
+            arg->accept(*this);
+        }
+        context->chunk->emit_call(
+            opCode::TAIL_CALL,
+            static_cast<uint8_t>(call->args.size()),
+            context->chunk->line_of_last_code());
+    } else {
+        node->expr->accept(*this);
+    }
     context->chunk->emit_op(opCode::RETURN);
 }
 
@@ -532,7 +606,7 @@ void ByteCodeGenerator::visitImportStmtNode(ImportStmtNode *node)
         context->finalizeLocal();
     } else {
         ObjString *name = new_ObjString(tk_name.text, context->gc);
-        chunk->emit_op_value(opCode::DEF_GLOBAL, NanBox::fromObj(name), line);
+        chunk->emit_global(opCode::DEF_GLOBAL, name, line);
     }
 }
 
@@ -540,20 +614,23 @@ void ByteCodeGenerator::visitTryCatchStmtNode(TryCatchStmtNode *node)
 {
     Chunk *chunk = context->chunk;
 
-    uint32_t begin = chunk->emit_jump(opCode::SETUP_EXCEPT, node->tryToken.line);
+    // try 块本身不生成任何指令，只在异常处理表中登记它的范围和进入时的栈深度
+    uint32_t start = chunk->count_;
+    auto stackDepth = static_cast<uint32_t>(context->locals.size());
+    context->tryDepth++;
     node->tryBody->accept(*this);
-    chunk->emit_op(opCode::END_EXCEPT);
+    uint32_t end = chunk->count_;
 
     uint32_t exitJump = chunk->emit_jump(opCode::JUMP_BWD, node->catchToken.line);
-    chunk->patch_jump(begin);
+    chunk->handlers_.push_back({start, end, chunk->count_, stackDepth});
 
     context->beginScope();
     declareLocalVariable(context, node->errToken);
     context->finalizeLocal();
     node->catchBody->accept(*this);
+    context->tryDepth--;
     auto ops = context->endScope();
     context->chunk->emit_scope_cleanup(ops, chunk->line_of_last_code());
-    chunk->emit_op(opCode::END_EXCEPT);
     chunk->patch_jump(exitJump);
 }
 
@@ -603,7 +680,7 @@ void ByteCodeGenerator::visitIncExprNode(IncExprNode *node)
     auto &expr = node->operand;
     Token op = node->opToken;
     expr->accept(*this);
-    chunk->emit_op_value(opCode::LOAD_CONST, NanBox::fromNumber(1), op.line);
+    chunk->emit_op_value(opCode::LOAD_CONST, NanBox::fromInt(1), op.line);
     chunk->emit_op(tokenToBinaryOpCode[op.type], op.line);
     try {
         expr->asLvalue = true;
@@ -656,12 +733,26 @@ void ByteCodeGenerator::visitCallExprNode(CallExprNode *node)
 {
     checkAssignFlag(node);
     Chunk *chunk = context->chunk;
+
+    // obj.method(args) 编译为 INVOKE_METHOD，查找和调用一步完成，不创建绑定方法
+    if (isInvokeCall(node)) {
+        auto field = static_cast<FieldExprNode *>(node->callee.get());
+        field->receiver->accept(*this);
+        for (const auto &arg : node->args) {
+            arg->accept(*this);
+        }
+        Token tk_fieldName = field->fieldNameToken;
+        Value name = NanBox::fromObj(new_ObjString(tk_fieldName.text, context->gc));
+        chunk->emit_invoke(name, static_cast<uint8_t>(node->args.size()), tk_fieldName.line);
+        return;
+    }
+
     node->callee->accept(*this);
     for (const auto &arg : node->args) {
         arg->accept(*this);
     }
-    chunk->emit_op(opCode::CALL);
-    chunk->emit_byte(static_cast<uint8_t>(node->args.size()));
+    chunk->emit_call(
+        opCode::CALL, static_cast<uint8_t>(node->args.size()), chunk->line_of_last_code());
 }
 
 void ByteCodeGenerator::genLoadFieldNodeCode(FieldExprNode *node)
@@ -678,7 +769,7 @@ void ByteCodeGenerator::genLoadFieldNodeCode(FieldExprNode *node)
         return;
     }
 
-    chunk->emit_op_value(opCode::LOAD_FIELD, name, tk_fieldName.line);
+    chunk->emit_field_op(opCode::LOAD_FIELD, name, tk_fieldName.line);
 }
 
 void ByteCodeGenerator::genStoreFieldNodeCode(FieldExprNode *node)
@@ -695,7 +786,7 @@ void ByteCodeGenerator::genStoreFieldNodeCode(FieldExprNode *node)
     node->receiver->accept(*this);
 
     Value name = NanBox::fromObj(new_ObjString(tk_fieldName.text, context->gc));
-    chunk->emit_op_value(opCode::STORE_FIELD, name, tk_fieldName.line);
+    chunk->emit_field_op(opCode::STORE_FIELD, name, tk_fieldName.line);
 }
 
 void ByteCodeGenerator::visitFieldExprNode(FieldExprNode *node)
@@ -709,11 +800,29 @@ void ByteCodeGenerator::visitFieldExprNode(FieldExprNode *node)
 
 void ByteCodeGenerator::genLoadIndexNodeCode(IndexExprNode *node)
 {
+    int restSlot = restSlotOf(node->receiver.get());
+    if (restSlot >= 0) {
+        // rest[i] reads the extra arguments in place
+        node->index->accept(*this);
+        context->chunk->emit_op_arg16(
+            opCode::LOAD_REST_ITEM, static_cast<uint16_t>(restSlot), context->chunk->line_of_last_code());
+        return;
+    }
     node->receiver->accept(*this);
     node->index->accept(*this);
     context->chunk->emit_op(opCode::LOAD_SUBSCR);
 }
 
+int ByteCodeGenerator::restSlotOf(ASTNode *node) const
+{
+    auto *var = dynamic_cast<VarNode *>(node);
+    if (var == nullptr || var->tag != VarTag::VAR || context->restSlot < 0) {
+        return -1;
+    }
+    int localOffset = context->findLocalVariable(var->varNameToken.text);
+    return localOffset == context->restSlot ? localOffset : -1;
+}
+
 void ByteCodeGenerator::genStoreIndexNodeCode(IndexExprNode *node)
 {
     node->receiver->accept(*this);
@@ -778,6 +887,10 @@ void ByteCodeGenerator::genStoreVarNodeCode(const VarNode *node) const
     uint32_t line = node->varNameToken.line;
     int localOffset = context->findLocalVariable(varName);
     if (localOffset >= 0) {
+        if (localOffset == context->restSlot) {
+            // an assigned rest parameter must always hold its list
+            context->restEscapes = true;
+        }
         chunk->emit_op_arg16(opCode::STORE_LOCAL, static_cast<uint16_t>(localOffset), line);
         return;
     }
@@ -793,8 +906,8 @@ void ByteCodeGenerator::genStoreVarNodeCode(const VarNode *node) const
             return;
         }
         if (upvalueSlot == -1) {
-            Value name = NanBox::fromObj(new_ObjString(varName, chunk->gc_));
-            chunk->emit_op_value(opCode::STORE_GLOBAL, name, line);
+            ObjString *name = new_ObjString(varName, chunk->gc_);
+            chunk->emit_global(opCode::STORE_GLOBAL, name, line);
             return;
         }
         if (upvalueSlot == -2) {
@@ -824,6 +937,7 @@ void ByteCodeGenerator::genLoadVarNodeCode(const VarNode *node) const
                 node->varNameToken.pos_info());
             throw ariaCompilingException{ErrorCode::SEMANTIC_INVALID_SUPER, msg};
         }
+        context->usesSuper = true;
         context->chunk->emit_op_arg16(opCode::LOAD_LOCAL, 0, line);
         return;
     }
@@ -836,7 +950,8 @@ void ByteCodeGenerator::genLoadVarNodeCode(const VarNode *node) const
 
     int localOffset = context->findLocalVariable(varName);
     if (localOffset >= 0) {
-        chunk->emit_op_arg16(opCode::LOAD_LOCAL, static_cast<uint16_t>(localOffset), line);
+        const opCode op = localOffset == context->restSlot ? opCode::LOAD_REST : opCode::LOAD_LOCAL;
+        chunk->emit_op_arg16(op, static_cast<uint16_t>(localOffset), line);
         return;
     }
     if (localOffset == -1) {
@@ -851,8 +966,8 @@ void ByteCodeGenerator::genLoadVarNodeCode(const VarNode *node) const
             return;
         }
         if (upvalueSlot == -1) {
-            Value name = NanBox::fromObj(new_ObjString(varName, context->gc));
-            chunk->emit_op_value(opCode::LOAD_GLOBAL, name, line);
+            ObjString *name = new_ObjString(varName, context->gc);
+            chunk->emit_global(opCode::LOAD_GLOBAL, name, line);
             return;
         }
         if (upvalueSlot == -2) {
@@ -888,7 +1003,7 @@ void ByteCodeGenerator::visitNumberNode(NumberNode *node)
         String msg = semantic_error("Number out of range.\n{}", num.info());
         throw ariaCompilingException(ErrorCode::SEMANTIC_LITERAL_OVERFLOW, msg);
     }
-    context->chunk->emit_op_value(opCode::LOAD_CONST, NanBox::fromNumber(value), num.line);
+    context->chunk->emit_op_value(opCode::LOAD_CONST, NanBox::packNumber(value), num.line);
 }
 
 void ByteCodeGenerator::visitStringNode(StringNode *node)
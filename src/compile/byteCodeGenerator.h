@@ -17,7 +17,11 @@ class ByteCodeGenerator : public AstVisitor
 {
 public:
     ByteCodeGenerator(
-        const String &_moduleName, const String &_moduleLocation, ValueHashTable *_globals, GC *_gc);
+        const String &_moduleName,
+        const String &_moduleLocation,
+        GlobalTable *_globals,
+        GC *_gc,
+        CodeBackend _backend = CodeBackend::STACK);
 
     ~ByteCodeGenerator() override;
 
@@ -25,6 +29,7 @@ public:
 
 private:
     FunctionContext *context;
+    CodeBackend backend;
 
     void genInheritCode(const Token &superClassNameToken);
 
@@ -42,6 +47,9 @@ private:
 
     void genLoadIndexNodeCode(IndexExprNode *node);
 
+    // 表达式是当前函数的剩余参数时返回它的槽位，否则返回 -1
+    int restSlotOf(ASTNode *node) const;
+
     void genStoreIndexNodeCode(IndexExprNode *node);
 
     void genStoreVarNodeCode(const VarNode *node) const;
@@ -50,7 +58,9 @@ private:
 
     FunctionContext *createLocalFunctionContext(const FunDeclNode *node, FunctionType type) const;
 
-    void defineFunction(ObjFunction *fun, const Token &funNameToken, uint32_t line) const;
+    void declareFunction(const Token &funNameToken) const;
+
+    void defineFunction(ObjFunction *fun, uint32_t line) const;
 
     void defineParam(const Token &paramNameToken) const;
 
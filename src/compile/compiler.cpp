@@ -1,4 +1,5 @@
 #include "compile/compiler.h"
+#include "chunk/peephole.h"
 #include "compile/byteCodeGenerator.h"
 #include "compile/functionContext.h"
 #include "compile/lexer.h"
@@ -13,13 +14,19 @@
 
 namespace aria {
 
-ObjFunction *Compiler::compile(String sourceLocation, String source, GC *gc, ValueHashTable *globals)
+ObjFunction *Compiler::compile(
+    String sourceLocation, String source, GC *gc, GlobalTable *globals, CodeBackend backend)
 {
-    return compile(std::move(sourceLocation), "anonymous", std::move(source), gc, globals);
+    return compile(std::move(sourceLocation), "anonymous", std::move(source), gc, globals, backend);
 }
 
 ObjFunction *Compiler::compile(
-    String moduleLocation, String moduleName, String source, GC *gc, ValueHashTable *globals)
+    String moduleLocation,
+    String moduleName,
+    String source,
+    GC *gc,
+    GlobalTable *globals,
+    CodeBackend backend)
 {
     try {
 #ifdef DEBUG_PRINT_SRC_CODE
@@ -39,8 +46,13 @@ ObjFunction *Compiler::compile(
         ast->display();
 #endif
 
-        auto generator = ByteCodeGenerator{moduleName, moduleLocation, globals, gc};
+        auto generator = ByteCodeGenerator{moduleName, moduleLocation, globals, gc, backend};
         auto fn = generator.generateCode(ast);
+#if ARIA_SUPERINSTRUCTIONS
+        if (fn) {
+            Peephole::optimize(fn);
+        }
+#endif
 
 #ifdef DEBUG_PRINT_COMPILED_CODE
         fn->chunk_->disassemble(moduleName);
@@ -2,19 +2,24 @@
 #define ARIA_COMPILER_H
 
 #include "common.h"
+#include "object/funDef.h"
 
 namespace aria {
 
 class GC;
 class ObjFunction;
-class ValueHashTable;
+class GlobalTable;
 
 class Compiler
 {
 public:
     // in interpret
     static ObjFunction *compile(
-        String sourceLocation, String sources, GC *gc, ValueHashTable *global);
+        String sourceLocation,
+        String sources,
+        GC *gc,
+        GlobalTable *global,
+        CodeBackend backend = CodeBackend::STACK);
 
     // in compile and loadModule
     static ObjFunction *compile(
@@ -22,7 +27,8 @@ public:
         String moduleName,
         String source,
         GC *gc,
-        ValueHashTable *globals = nullptr);
+        GlobalTable *globals = nullptr,
+        CodeBackend backend = CodeBackend::STACK);
 };
 
 } // namespace aria
@@ -5,12 +5,16 @@
 namespace aria {
 
 FunctionContext::FunctionContext(
-    const String &_fnName, const String &_fnLocation, ValueHashTable *_globals, GC *_gc)
+    const String &_fnName, const String &_fnLocation, GlobalTable *_globals, GC *_gc)
     : gc{_gc}
     , enclosing{nullptr}
     , currentClass{nullptr}
     , fun{nullptr}
     , scopeDepth{0}
+    , tryDepth{0}
+    , restSlot{-1}
+    , restEscapes{false}
+    , usesSuper{false}
 {
     auto fnNameObj = new_ObjString(_fnName, gc);
     GcTempRootGuard guard{gc};
@@ -38,11 +42,19 @@ FunctionContext::FunctionContext(
     , currentClass{_enclosing->currentClass}
     , fun{nullptr}
     , scopeDepth{0}
+    , tryDepth{0}
+    , restSlot{-1}
+    , restEscapes{false}
+    , usesSuper{false}
 {
     auto globals = enclosing->fun->chunk_->globals_;
     auto fnNameObj = new_ObjString(_fnName, gc);
     GcTempRootGuard guard{gc, NanBox::fromObj(fnNameObj)};
     _arity = _acceptsVarargs ? _arity - 1 : _arity;
+    if (_acceptsVarargs) {
+        // 0 号槽位是被调用者/this，剩余参数紧跟在固定参数之后
+        restSlot = _arity + 1;
+    }
     fun = new_ObjFunction(
         _type, enclosing->fun->location_, fnNameObj, _arity, globals, _acceptsVarargs, gc);
     chunk = fun->chunk_;
@@ -146,6 +158,10 @@ int FunctionContext::findUpvalueVariable(StringView name)
     int localIndex = enclosing->findLocalVariable(name);
     if (localIndex >= 0) {
         enclosing->locals[localIndex].isCaptured = true;
+        enclosing->fun->captures_locals_ = true;
+        if (localIndex == enclosing->restSlot) {
+            enclosing->restEscapes = true;
+        }
         return addUpvalue(static_cast<uint16_t>(localIndex), true);
     }
 
@@ -63,7 +63,7 @@ class FunctionContext
 public:
     // for global start up, compile a script
     FunctionContext(
-        const String &_fnName, const String &_fnLocation, ValueHashTable *_globals, GC *_gc);
+        const String &_fnName, const String &_fnLocation, GlobalTable *_globals, GC *_gc);
 
     // for local start up, compile a function
     FunctionContext(
@@ -127,6 +127,14 @@ public:
     Chunk *chunk;
 
     int scopeDepth;
+    // try/catch 块的嵌套层数，块内的 return f(args) 不能复用栈帧（异常处理表属于当前函数）
+    int tryDepth;
+    // 剩余参数的槽位，没有时为 -1；它被赋值或被闭包捕获时 restEscapes 为 true，
+    // 此时调用方照常把多余的参数打包成列表
+    int restSlot;
+    bool restEscapes;
+    // 函数体中使用了 super：方法总是生成闭包，由闭包记录定义它的类
+    bool usesSuper;
     List<Local> locals;
     List<Upvalue> upvalues;
 
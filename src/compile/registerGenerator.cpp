@@ -0,0 +1,738 @@
+#include "compile/registerGenerator.h"
+#include "compile/ast.h"
+#include "compile/functionContext.h"
+#include "object/objFunction.h"
+#include "object/objString.h"
+#include "value/globalTable.h"
+
+#include <cmath>
+
+namespace aria {
+
+namespace {
+
+// 生成过程中遇到不支持的语法时抛出，由 generate() 捕获后退回栈式字节码
+struct Unsupported
+{};
+
+// 虚拟寄存器编号：0..paramCount 是被调用者和参数，其后是局部变量与临时值，
+// k_const_reg 及以上表示第 (vreg - k_const_reg) 个常量。物理编号在 finish() 中确定
+constexpr int k_const_reg = 0x10000;
+
+constexpr int k_max_registers = UINT8_MAX + 1;
+
+opCode binaryOpCode(TokenType type)
+{
+    switch (type) {
+    case TokenType::PLUS:
+    case TokenType::PLUS_EQUAL:
+        return opCode::REG_ADD;
+    case TokenType::MINUS:
+    case TokenType::MINUS_EQUAL:
+        return opCode::REG_SUBTRACT;
+    case TokenType::STAR:
+    case TokenType::STAR_EQUAL:
+        return opCode::REG_MULTIPLY;
+    case TokenType::SLASH:
+    case TokenType::SLASH_EQUAL:
+        return opCode::REG_DIVIDE;
+    case TokenType::PERCENT:
+    case TokenType::PERCENT_EQUAL:
+        return opCode::REG_MOD;
+    case TokenType::EQUAL_EQUAL:
+        return opCode::REG_EQUAL;
+    case TokenType::NOT_EQUAL:
+        return opCode::REG_NOT_EQUAL;
+    case TokenType::GREATER:
+        return opCode::REG_GREATER;
+    case TokenType::GREATER_EQUAL:
+        return opCode::REG_GREATER_EQUAL;
+    case TokenType::LESS:
+        return opCode::REG_LESS;
+    case TokenType::LESS_EQUAL:
+        return opCode::REG_LESS_EQUAL;
+    default:
+        throw Unsupported{};
+    }
+}
+
+// 条件中的比较直接生成比较并跳转的指令，每种比较一个操作码，避免在指令内再做一次分支
+bool compareJumpOpCode(TokenType type, opCode &op)
+{
+    switch (type) {
+    case TokenType::EQUAL_EQUAL:
+        op = opCode::REG_EQUAL_JUMP;
+        return true;
+    case TokenType::NOT_EQUAL:
+        op = opCode::REG_NOT_EQUAL_JUMP;
+        return true;
+    case TokenType::GREATER:
+        op = opCode::REG_GREATER_JUMP;
+        return true;
+    case TokenType::GREATER_EQUAL:
+        op = opCode::REG_GREATER_EQUAL_JUMP;
+        return true;
+    case TokenType::LESS:
+        op = opCode::REG_LESS_JUMP;
+        return true;
+    case TokenType::LESS_EQUAL:
+        op = opCode::REG_LESS_EQUAL_JUMP;
+        return true;
+    default:
+        return false;
+    }
+}
+
+const VarNode *asPlainVar(const ASTNode *node)
+{
+    auto var = dynamic_cast<const VarNode *>(node);
+    if (var != nullptr && var->tag != VarTag::VAR) {
+        throw Unsupported{};
+    }
+    return var;
+}
+
+// 表达式中是否含有赋值或自增，含有时左操作数若是局部变量需要先复制出来，保持从左到右的求值顺序
+bool hasAssignment(const ASTNode *node)
+{
+    if (node == nullptr) {
+        return false;
+    }
+    if (dynamic_cast<const AssignExprNode *>(node) || dynamic_cast<const IncExprNode *>(node)) {
+        return true;
+    }
+    if (auto binary = dynamic_cast<const BinaryExprNode *>(node)) {
+        return hasAssignment(binary->lhs.get()) || hasAssignment(binary->rhs.get());
+    }
+    if (auto unary = dynamic_cast<const UnaryExprNode *>(node)) {
+        return hasAssignment(unary->operand.get());
+    }
+    if (auto call = dynamic_cast<const CallExprNode *>(node)) {
+        for (const auto &arg : call->args) {
+            if (hasAssignment(arg.get())) {
+                return true;
+            }
+        }
+        return hasAssignment(call->callee.get());
+    }
+    return false;
+}
+
+} // namespace
+
+RegisterGenerator::RegisterGenerator(FunctionContext *context)
+    : context{context}
+    , paramCount{0}
+    , scopeDepth{0}
+    , top{0}
+    , maxTop{0}
+    , line{0}
+{}
+
+bool RegisterGenerator::generate(const FunDeclNode *node)
+{
+    try {
+        line = node->funNameToken.line;
+        locals.push_back({"", 0});
+        scopeDepth = 1;
+        for (const auto &param : node->params) {
+            if (findLocal(param.text) >= 0) {
+                throw Unsupported{};
+            }
+            locals.push_back({param.text, scopeDepth});
+        }
+        paramCount = static_cast<int>(node->params.size());
+        top = maxTop = static_cast<int>(locals.size());
+        if (top >= k_max_registers) {
+            throw Unsupported{};
+        }
+
+        statement(node->body.get());
+
+        line = node->endLine;
+        emitOp(opCode::REG_RETURN);
+        emitReg(constReg(NanBox::NilValue));
+        finish();
+        return true;
+    } catch ([[maybe_unused]] const Unsupported &e) {
+        context->chunk->consts_.clear();
+        return false;
+    }
+}
+
+void RegisterGenerator::emitByte(uint8_t byte)
+{
+    code.push_back(byte);
+    lines.push_back(line);
+}
+
+void RegisterGenerator::emitOp(opCode op)
+{
+    emitByte(static_cast<uint8_t>(op));
+}
+
+void RegisterGenerator::emitReg(int reg)
+{
+    operands.push_back({static_cast<uint32_t>(code.size()), reg});
+    emitByte(0);
+}
+
+void RegisterGenerator::emitWord(uint16_t word)
+{
+    auto [low, high] = split_word(word);
+    emitByte(low);
+    emitByte(high);
+}
+
+uint32_t RegisterGenerator::emitJumpOffset()
+{
+    emitWord(0xFFFF);
+    return static_cast<uint32_t>(code.size() - 2);
+}
+
+uint32_t RegisterGenerator::emitJump(opCode op)
+{
+    emitOp(op);
+    return emitJumpOffset();
+}
+
+void RegisterGenerator::rewriteWord(uint32_t pos, uint64_t word)
+{
+    if (word > UINT16_MAX) {
+        throw Unsupported{};
+    }
+    auto [low, high] = split_word(static_cast<uint16_t>(word));
+    code[pos] = low;
+    code[pos + 1] = high;
+}
+
+void RegisterGenerator::patchJump(uint32_t pos)
+{
+    rewriteWord(pos, code.size() - (pos + 2));
+}
+
+void RegisterGenerator::patchJump(uint32_t pos, uint32_t dest)
+{
+    // 与 Chunk::patch_jump 相同：JUMP_FWD 向回跳，JUMP_BWD 向前跳
+    if (dest < pos) {
+        code[pos - 1] = static_cast<uint8_t>(opCode::JUMP_FWD);
+        rewriteWord(pos, pos + 2 - dest);
+    } else {
+        code[pos - 1] = static_cast<uint8_t>(opCode::JUMP_BWD);
+        rewriteWord(pos, dest - (pos + 2));
+    }
+}
+
+void RegisterGenerator::emitLoop(uint32_t dest)
+{
+    patchJump(emitJump(opCode::JUMP_FWD), dest);
+}
+
+int RegisterGenerator::allocTemp()
+{
+    if (top + 1 >= k_max_registers) {
+        throw Unsupported{};
+    }
+    int reg = top++;
+    if (top > maxTop) {
+        maxTop = top;
+    }
+    return reg;
+}
+
+int RegisterGenerator::constReg(Value value)
+{
+    ValueArray &consts = context->chunk->consts_;
+    for (uint32_t i = 0; i < consts.size(); i++) {
+        if (consts[i] == value) {
+            return k_const_reg + static_cast<int>(i);
+        }
+    }
+    if (consts.size() + 1 >= k_max_registers) {
+        throw Unsupported{};
+    }
+    GcTempRootGuard guard{context->gc, value};
+    consts.push(value);
+    return k_const_reg + static_cast<int>(consts.size() - 1);
+}
+
+bool RegisterGenerator::literal(const ASTNode *node, int &reg)
+{
+    if (auto num = dynamic_cast<const NumberNode *>(node)) {
+        double value;
+        try {
+            value = std::stod(num->numToken.text);
+        } catch ([[maybe_unused]] const std::exception &e) {
+            // 让栈式生成器报告编译错误
+            throw Unsupported{};
+        }
+        reg = constReg(NanBox::packNumber(value));
+        return true;
+    }
+    if (auto str = dynamic_cast<const StringNode *>(node)) {
+        reg = constReg(NanBox::fromObj(new_ObjString(str->strToken.text, context->gc)));
+        return true;
+    }
+    if (dynamic_cast<const TrueNode *>(node)) {
+        reg = constReg(NanBox::TrueValue);
+        return true;
+    }
+    if (dynamic_cast<const FalseNode *>(node)) {
+        reg = constReg(NanBox::FalseValue);
+        return true;
+    }
+    if (dynamic_cast<const NilNode *>(node)) {
+        reg = constReg(NanBox::NilValue);
+        return true;
+    }
+    return false;
+}
+
+int RegisterGenerator::findLocal(const String &name) const
+{
+    for (int i = static_cast<int>(locals.size() - 1); i >= 0; i--) {
+        if (locals[i].name == name) {
+            if (locals[i].depth == kUnsetDepth) {
+                // 在自己的初始化表达式中读取，交给栈式生成器报错
+                throw Unsupported{};
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint16_t RegisterGenerator::globalSlot(const String &name) const
+{
+    // 外层函数的局部变量需要捕获为 upvalue，寄存器后端不支持
+    for (auto ctx = context->enclosing; ctx != nullptr; ctx = ctx->enclosing) {
+        if (ctx->findLocalVariable(name) != -2) {
+            throw Unsupported{};
+        }
+    }
+    uint32_t slot = context->chunk->globals_->slot_of(new_ObjString(name, context->gc));
+    if (slot > UINT16_MAX) {
+        throw Unsupported{};
+    }
+    return static_cast<uint16_t>(slot);
+}
+
+void RegisterGenerator::beginScope()
+{
+    scopeDepth++;
+}
+
+void RegisterGenerator::endScope()
+{
+    scopeDepth--;
+    while (!locals.empty() && locals.back().depth > scopeDepth) {
+        locals.pop_back();
+    }
+    top = static_cast<int>(locals.size());
+}
+
+void RegisterGenerator::statement(ASTNode *node)
+{
+    if (auto block = dynamic_cast<BlockNode *>(node)) {
+        beginScope();
+        for (const auto &decl : block->decls) {
+            statement(decl.get());
+        }
+        endScope();
+    } else if (auto decl = dynamic_cast<VarDeclNode *>(node)) {
+        varDecl(decl);
+    } else if (auto ifStmt = dynamic_cast<IfStmtNode *>(node)) {
+        List<uint32_t> exits;
+        jumpIfFalse(ifStmt->condition.get(), exits);
+        statement(ifStmt->body.get());
+        if (ifStmt->elseBody != nullptr) {
+            uint32_t endJump = emitJump(opCode::JUMP_BWD);
+            for (auto exit : exits) {
+                patchJump(exit);
+            }
+            statement(ifStmt->elseBody.get());
+            patchJump(endJump);
+        } else {
+            for (auto exit : exits) {
+                patchJump(exit);
+            }
+        }
+    } else if (auto whileStmt = dynamic_cast<WhileStmtNode *>(node)) {
+        loop(whileStmt->condition.get(), nullptr, whileStmt->body.get());
+    } else if (auto forStmt = dynamic_cast<ForStmtNode *>(node)) {
+        beginScope();
+        if (forStmt->varInit != nullptr) {
+            statement(forStmt->varInit.get());
+        }
+        loop(forStmt->condition.get(), forStmt->increment.get(), forStmt->body.get());
+        endScope();
+    } else if (auto breakStmt = dynamic_cast<BreakStmtNode *>(node)) {
+        line = breakStmt->breakToken.line;
+        loopControl(true);
+    } else if (auto continueStmt = dynamic_cast<ContinueStmtNode *>(node)) {
+        line = continueStmt->continueToken.line;
+        loopControl(false);
+    } else if (auto returnStmt = dynamic_cast<ReturnStmtNode *>(node)) {
+        line = returnStmt->returnToken.line;
+        int reg = exprAny(returnStmt->expr.get());
+        emitOp(opCode::REG_RETURN);
+        emitReg(reg);
+        top = static_cast<int>(locals.size());
+    } else if (auto printStmt = dynamic_cast<PrintStmtNode *>(node)) {
+        int reg = exprAny(printStmt->expr.get());
+        emitOp(opCode::REG_PRINT);
+        emitReg(reg);
+        top = static_cast<int>(locals.size());
+    } else if (auto exprStmt = dynamic_cast<ExprStmtNode *>(node)) {
+        exprTo(exprStmt->expr.get(), -1);
+    } else {
+        throw Unsupported{};
+    }
+}
+
+void RegisterGenerator::varDecl(VarDeclNode *node)
+{
+    for (size_t i = 0; i < node->names.size(); i++) {
+        const Token &name = node->names[i];
+        line = name.line;
+        for (int j = static_cast<int>(locals.size() - 1); j >= 0 && locals[j].depth >= scopeDepth;
+             j--) {
+            if (locals[j].name == name.text) {
+                throw Unsupported{};
+            }
+        }
+        // 语句之间没有临时值，新局部变量的寄存器就是 locals 的下一个槽位
+        int reg = allocTemp();
+        locals.push_back({name.text, kUnsetDepth});
+        exprTo(node->exprs[i].get(), reg);
+        locals.back().depth = scopeDepth;
+    }
+}
+
+// for 循环的 continue 跳到 increment，没有 increment 时（包括 while）回到条件判断
+void RegisterGenerator::loop(ASTNode *condition, ASTNode *increment, ASTNode *body)
+{
+    loops.emplace_back();
+    auto loopStart = static_cast<uint32_t>(code.size());
+    List<uint32_t> exits;
+    if (condition != nullptr) {
+        jumpIfFalse(condition, exits);
+    }
+
+    statement(body);
+
+    auto continueDest = loopStart;
+    if (increment != nullptr) {
+        continueDest = static_cast<uint32_t>(code.size());
+        exprTo(increment, -1);
+    }
+    emitLoop(loopStart);
+
+    for (auto exit : exits) {
+        patchJump(exit);
+    }
+    for (auto breakJump : loops.back().breaks) {
+        patchJump(breakJump, static_cast<uint32_t>(code.size()));
+    }
+    for (auto continueJump : loops.back().continues) {
+        patchJump(continueJump, continueDest);
+    }
+    loops.pop_back();
+}
+
+void RegisterGenerator::loopControl(bool isBreak)
+{
+    if (loops.empty()) {
+        throw Unsupported{};
+    }
+    // 寄存器帧中的局部变量不需要出栈，直接跳转
+    uint32_t jump = emitJump(opCode::JUMP_BWD);
+    if (isBreak) {
+        loops.back().breaks.push_back(jump);
+    } else {
+        loops.back().continues.push_back(jump);
+    }
+}
+
+void RegisterGenerator::jumpIfFalse(ASTNode *node, List<uint32_t> &exits)
+{
+    const int saved = top;
+    auto binary = dynamic_cast<BinaryExprNode *>(node);
+    opCode compare;
+    if (binary != nullptr && binary->opToken.type == TokenType::AND) {
+        jumpIfFalse(binary->lhs.get(), exits);
+        jumpIfFalse(binary->rhs.get(), exits);
+    } else if (binary != nullptr && compareJumpOpCode(binary->opToken.type, compare)) {
+        int lhs = operand(binary->lhs.get(), binary->rhs.get());
+        int rhs = exprAny(binary->rhs.get());
+        line = binary->opToken.line;
+        emitOp(compare);
+        emitReg(lhs);
+        emitReg(rhs);
+        exits.push_back(emitJumpOffset());
+    } else {
+        int reg = exprAny(node);
+        emitOp(opCode::REG_JUMP_FALSE);
+        emitReg(reg);
+        exits.push_back(emitJumpOffset());
+    }
+    top = saved;
+}
+
+int RegisterGenerator::operand(ASTNode *node, const ASTNode *rest)
+{
+    if (auto var = asPlainVar(node); var != nullptr && hasAssignment(rest)) {
+        int reg = allocTemp();
+        exprTo(node, reg);
+        return reg;
+    }
+    return exprAny(node);
+}
+
+int RegisterGenerator::exprAny(ASTNode *node)
+{
+    if (auto var = asPlainVar(node)) {
+        int local = findLocal(var->varNameToken.text);
+        if (local >= 0) {
+            return local;
+        }
+    }
+    int reg;
+    if (literal(node, reg)) {
+        return reg;
+    }
+    reg = allocTemp();
+    exprTo(node, reg);
+    return reg;
+}
+
+void RegisterGenerator::exprTo(ASTNode *node, int dst)
+{
+    const int saved = top;
+    exprToImpl(node, dst);
+    top = saved;
+}
+
+void RegisterGenerator::emitMove(int dst, int src)
+{
+    if (dst >= 0 && dst != src) {
+        emitOp(opCode::REG_MOVE);
+        emitReg(dst);
+        emitReg(src);
+    }
+}
+
+// dst < 0 表示结果不再使用（表达式语句）
+void RegisterGenerator::exprToImpl(ASTNode *node, int dst)
+{
+    if (auto assign = dynamic_cast<AssignExprNode *>(node)) {
+        assignExpr(assign, dst);
+        return;
+    }
+    if (auto inc = dynamic_cast<IncExprNode *>(node)) {
+        incExpr(inc, dst);
+        return;
+    }
+    if (auto call = dynamic_cast<CallExprNode *>(node)) {
+        callExpr(call, dst);
+        return;
+    }
+    int reg;
+    if (literal(node, reg)) {
+        emitMove(dst, reg);
+        return;
+    }
+    if (dst < 0) {
+        dst = allocTemp();
+    }
+
+    if (auto var = asPlainVar(node)) {
+        line = var->varNameToken.line;
+        int local = findLocal(var->varNameToken.text);
+        if (local >= 0) {
+            emitMove(dst, local);
+        } else {
+            uint16_t slot = globalSlot(var->varNameToken.text);
+            emitOp(opCode::REG_LOAD_GLOBAL);
+            emitReg(dst);
+            emitWord(slot);
+        }
+    } else if (auto binary = dynamic_cast<BinaryExprNode *>(node)) {
+        binaryExpr(binary, dst);
+    } else if (auto unary = dynamic_cast<UnaryExprNode *>(node)) {
+        const auto type = unary->opToken.type;
+        if (type != TokenType::NOT && type != TokenType::MINUS) {
+            throw Unsupported{};
+        }
+        int src = exprAny(unary->operand.get());
+        line = unary->opToken.line;
+        emitOp(type == TokenType::NOT ? opCode::REG_NOT : opCode::REG_NEGATE);
+        emitReg(dst);
+        emitReg(src);
+    } else {
+        throw Unsupported{};
+    }
+}
+
+// 写入全局变量前先在临时寄存器中算出新值；dst 是局部变量时不能直接使用，否则复合赋值的右侧会读到被改写的值
+int RegisterGenerator::globalTarget(int dst)
+{
+    return dst >= static_cast<int>(locals.size()) ? dst : allocTemp();
+}
+
+void RegisterGenerator::assignExpr(AssignExprNode *node, int dst)
+{
+    auto var = asPlainVar(node->lhs.get());
+    if (var == nullptr) {
+        throw Unsupported{};
+    }
+    const auto type = node->opToken.type;
+    int local = findLocal(var->varNameToken.text);
+    if (local >= 0) {
+        if (type == TokenType::EQUAL) {
+            exprTo(node->rhs.get(), local);
+        } else {
+            int rhs = exprAny(node->rhs.get());
+            line = node->opToken.line;
+            emitOp(binaryOpCode(type));
+            emitReg(local);
+            emitReg(local);
+            emitReg(rhs);
+        }
+        emitMove(dst, local);
+        return;
+    }
+
+    uint16_t slot = globalSlot(var->varNameToken.text);
+    int value = globalTarget(dst);
+    if (type == TokenType::EQUAL) {
+        exprTo(node->rhs.get(), value);
+    } else {
+        line = var->varNameToken.line;
+        emitOp(opCode::REG_LOAD_GLOBAL);
+        emitReg(value);
+        emitWord(slot);
+        int rhs = exprAny(node->rhs.get());
+        line = node->opToken.line;
+        emitOp(binaryOpCode(type));
+        emitReg(value);
+        emitReg(value);
+        emitReg(rhs);
+    }
+    line = node->opToken.line;
+    emitOp(opCode::REG_STORE_GLOBAL);
+    emitReg(value);
+    emitWord(slot);
+    emitMove(dst, value);
+}
+
+void RegisterGenerator::incExpr(IncExprNode *node, int dst)
+{
+    auto var = asPlainVar(node->operand.get());
+    if (var == nullptr) {
+        throw Unsupported{};
+    }
+    const opCode op = node->opToken.type == TokenType::PLUS_PLUS ? opCode::REG_ADD
+                                                                   : opCode::REG_SUBTRACT;
+    const int one = constReg(NanBox::fromInt(1));
+    line = node->opToken.line;
+    int local = findLocal(var->varNameToken.text);
+    if (local >= 0) {
+        emitOp(op);
+        emitReg(local);
+        emitReg(local);
+        emitReg(one);
+        emitMove(dst, local);
+        return;
+    }
+
+    uint16_t slot = globalSlot(var->varNameToken.text);
+    int value = globalTarget(dst);
+    emitOp(opCode::REG_LOAD_GLOBAL);
+    emitReg(value);
+    emitWord(slot);
+    emitOp(op);
+    emitReg(value);
+    emitReg(value);
+    emitReg(one);
+    emitOp(opCode::REG_STORE_GLOBAL);
+    emitReg(value);
+    emitWord(slot);
+    emitMove(dst, value);
+}
+
+void RegisterGenerator::binaryExpr(BinaryExprNode *node, int dst)
+{
+    const auto type = node->opToken.type;
+    if (type == TokenType::AND || type == TokenType::OR) {
+        // 结果先写入临时寄存器：dst 若是局部变量，右侧表达式可能还要读取它的旧值
+        int value = dst >= static_cast<int>(locals.size()) ? dst : allocTemp();
+        exprTo(node->lhs.get(), value);
+        line = node->opToken.line;
+        emitOp(type == TokenType::AND ? opCode::REG_JUMP_FALSE : opCode::REG_JUMP_TRUE);
+        emitReg(value);
+        uint32_t endJump = emitJumpOffset();
+        exprTo(node->rhs.get(), value);
+        patchJump(endJump);
+        emitMove(dst, value);
+        return;
+    }
+    const opCode op = binaryOpCode(type);
+    int lhs = operand(node->lhs.get(), node->rhs.get());
+    int rhs = exprAny(node->rhs.get());
+    line = node->opToken.line;
+    emitOp(op);
+    emitReg(dst);
+    emitReg(lhs);
+    emitReg(rhs);
+}
+
+void RegisterGenerator::callExpr(CallExprNode *node, int dst)
+{
+    if (node->args.size() > UINT8_MAX) {
+        throw Unsupported{};
+    }
+    // 被调用者和参数放在连续的寄存器中，被调用函数的栈帧从 base 开始，返回值写回 base；
+    // dst 是最后分配的临时寄存器时直接把它作为 base，省去一次 REG_MOVE
+    const bool inPlace = dst == top - 1 && dst >= static_cast<int>(locals.size());
+    int base = inPlace ? dst : allocTemp();
+    exprTo(node->callee.get(), base);
+    for (const auto &arg : node->args) {
+        exprTo(arg.get(), allocTemp());
+    }
+    emitOp(opCode::REG_CALL);
+    emitReg(base);
+    emitByte(static_cast<uint8_t>(node->args.size()));
+    emitMove(dst, base);
+}
+
+// 寄存器重新编号并写入 chunk：常量寄存器紧跟在参数之后，局部变量和临时值整体后移。
+// 常量放在低处是因为被调用函数的栈帧从调用处的 base 开始，会覆盖 base 以上的寄存器
+void RegisterGenerator::finish()
+{
+    Chunk *chunk = context->chunk;
+    const int constCount = static_cast<int>(chunk->consts_.size());
+    const int frameSize = maxTop + constCount;
+    if (frameSize > k_max_registers) {
+        throw Unsupported{};
+    }
+    const int firstConst = paramCount + 1;
+    for (const auto &[pos, reg] : operands) {
+        int physical;
+        if (reg >= k_const_reg) {
+            physical = firstConst + (reg - k_const_reg);
+        } else if (reg >= firstConst) {
+            physical = reg + constCount;
+        } else {
+            physical = reg;
+        }
+        code[pos] = static_cast<uint8_t>(physical);
+    }
+
+    for (size_t i = 0; i < code.size(); i++) {
+        chunk->emit_byte(code[i], lines[i]);
+    }
+    context->fun->frame_size_ = frameSize;
+}
+
+} // namespace aria
@@ -0,0 +1,137 @@
+#ifndef ARIA_REGISTERGENERATOR_H
+#define ARIA_REGISTERGENERATOR_H
+
+#include "chunk/code.h"
+#include "common.h"
+#include "value/value.h"
+
+namespace aria {
+
+struct ASTNode;
+struct AssignExprNode;
+struct BinaryExprNode;
+struct CallExprNode;
+struct FunDeclNode;
+struct IncExprNode;
+struct VarDeclNode;
+class FunctionContext;
+
+// 可选的寄存器后端代码生成器（见 CodeBackend::REGISTER）。
+// 寄存器就是函数栈帧里的槽位：0 号是被调用者本身，随后依次是参数、字面量、局部变量和临时值；
+// 字面量寄存器在创建栈帧时由 VM 从常量表装入。
+// 只支持由局部/全局变量、字面量、算术比较逻辑运算、函数调用和基本控制流组成的函数；
+// 函数体用到闭包、类、字段、下标、容器、迭代器或异常处理时 generate() 返回 false，
+// 调用者照常为该函数生成栈式字节码。两种函数可以互相调用。
+class RegisterGenerator
+{
+public:
+    explicit RegisterGenerator(FunctionContext *context);
+
+    // compile the function of context into context->chunk, return false if unsupported
+    bool generate(const FunDeclNode *node);
+
+private:
+    struct RegLocal
+    {
+        String name;
+        int depth;
+    };
+
+    struct Loop
+    {
+        List<uint32_t> breaks;
+        List<uint32_t> continues;
+    };
+
+    struct RegOperand
+    {
+        uint32_t pos;
+        int reg;
+    };
+
+    FunctionContext *context;
+    List<uint8_t> code;
+    List<uint32_t> lines;
+    // 所有寄存器操作数的位置和虚拟编号，finish() 中统一改写为物理编号
+    List<RegOperand> operands;
+    List<RegLocal> locals;
+    List<Loop> loops;
+    int paramCount;
+    int scopeDepth;
+    int top;
+    int maxTop;
+    uint32_t line;
+
+    void emitByte(uint8_t byte);
+
+    void emitOp(opCode op);
+
+    void emitReg(int reg);
+
+    void emitWord(uint16_t word);
+
+    void emitMove(int dst, int src);
+
+    // placeholder jump offset (2 bytes), return its position
+    uint32_t emitJumpOffset();
+
+    uint32_t emitJump(opCode op);
+
+    void rewriteWord(uint32_t pos, uint64_t word);
+
+    // patch forward jump offset to the current position
+    void patchJump(uint32_t pos);
+
+    // patch unconditional jump to dest, the direction is chosen like Chunk::patch_jump
+    void patchJump(uint32_t pos, uint32_t dest);
+
+    void emitLoop(uint32_t dest);
+
+    int allocTemp();
+
+    int constReg(Value value);
+
+    bool literal(const ASTNode *node, int &reg);
+
+    [[nodiscard]] int findLocal(const String &name) const;
+
+    [[nodiscard]] uint16_t globalSlot(const String &name) const;
+
+    int globalTarget(int dst);
+
+    void beginScope();
+
+    void endScope();
+
+    void statement(ASTNode *node);
+
+    void varDecl(VarDeclNode *node);
+
+    void loop(ASTNode *condition, ASTNode *increment, ASTNode *body);
+
+    void loopControl(bool isBreak);
+
+    void jumpIfFalse(ASTNode *node, List<uint32_t> &exits);
+
+    int operand(ASTNode *node, const ASTNode *rest);
+
+    int exprAny(ASTNode *node);
+
+    void exprTo(ASTNode *node, int dst);
+
+    void exprToImpl(ASTNode *node, int dst);
+
+    void assignExpr(AssignExprNode *node, int dst);
+
+    void incExpr(IncExprNode *node, int dst);
+
+    void binaryExpr(BinaryExprNode *node, int dst);
+
+    void callExpr(CallExprNode *node, int dst);
+
+    void finish();
+};
+
+} // namespace aria
+
+#endif //ARIA_REGISTERGENERATOR_H
@@ -1,6 +1,7 @@
 #include "debugger/debugger.h"
 #include "chunk/chunk.h"
 #include "chunk/disassembler.h"
+#include "object/objFunction.h"
 #include "runtime/vm.h"
 #include <ranges>
 #include <sstream>
@@ -28,23 +29,42 @@ void AriaDebugger::runScript(const String &path)
     println("Program finished.");
 }
 
+void AriaDebugger::hookModuleLoaded(ObjFunction *module)
+{
+    const String location = module->location_->c_str();
+    loadedModules[location] = module;
+    bindPendingBreakpoints(location);
+}
+
 void AriaDebugger::hookBeforeExec(CallFrame *frame, uint32_t offset)
 {
-    checkAndBindBreakpoint(frame, offset);
-    const auto line = frame->function->chunk_->lines_[offset];
-    const auto ins = frame->function->chunk_->codes_ + offset;
-    const auto module = frame->function->location_->c_str();
-    if (activeBreakpoints[module].contains(line) && activeBreakpoints[module][line].ins == ins) {
-        println("[*] Breakpoint hit at line {}", line);
-        stepping = false;
-        repl();
-    } else if (stepping) {
-        println("[*] Step at line {}", line);
+    uint8_t *ins = frame->function->chunk_->codes_ + offset;
+    if (repatchIns != nullptr) {
+        if (ins == repatchIns) {
+            return;
+        }
+        // 原指令可能在执行时被改写（快速化），补回断点前重新记录
+        originals[repatchIns] = *repatchIns;
+        *repatchIns = static_cast<uint8_t>(opCode::BREAKPOINT);
+        repatchIns = nullptr;
+    }
+    // 单步到断点上时交给 hookBreakpoint 处理，避免暂停两次
+    if (stepping && *ins != static_cast<uint8_t>(opCode::BREAKPOINT)) {
+        println("[*] Step at line {}", frame->function->chunk_->lines_[offset]);
         stepping = false;
         repl();
     }
 }
 
+void AriaDebugger::hookBreakpoint(CallFrame *frame, uint32_t offset)
+{
+    uint8_t *ins = frame->function->chunk_->codes_ + offset;
+    *ins = originalByte(ins);
+    repatchIns = ins;
+    println("[*] Breakpoint hit at line {}", frame->function->chunk_->lines_[offset]);
+    repl();
+}
+
 void AriaDebugger::repl()
 {
     clearFlags();
@@ -125,85 +145,86 @@ void AriaDebugger::addPendingBreakpoint(Breakpoint bp)
 {
     pendingBreakpoints[bp.path][bp.line] = bp;
     println("Breakpoint set at:\n{}:{}", bp.path, bp.line);
+    bindPendingBreakpoints(bp.path);
 }
 
-void AriaDebugger::checkAndBindBreakpoint(CallFrame *frame, uint32_t offset)
+uint8_t *AriaDebugger::findInstruction(ObjFunction *module, uint32_t line)
 {
-    auto line = frame->function->chunk_->lines_[offset];
-    auto ins = frame->function->chunk_->codes_ + offset;
-    auto module = frame->function->location_->c_str();
-
-    if (isActiveBreakpoint(module, line)) {
-        return;
+    uint8_t *best = nullptr;
+    uint32_t bestLine = UINT32_MAX;
+    Set<ObjFunction *> visited;
+    List<ObjFunction *> work{module};
+    while (!work.empty()) {
+        ObjFunction *function = work.back();
+        work.pop_back();
+        if (!visited.insert(function).second) {
+            continue;
+        }
+        Chunk *chunk = function->chunk_;
+        uint32_t offset = 0;
+        while (offset < chunk->count_) {
+            const uint32_t insLine = chunk->lines_[offset];
+            if (insLine >= line && insLine < bestLine) {
+                best = chunk->codes_ + offset;
+                bestLine = insLine;
+            }
+            // 指令长度按原字节计算
+            uint8_t &op = chunk->codes_[offset];
+            const uint8_t patched = op;
+            op = originalByte(&op);
+            const uint32_t next = Disassembler::readInstruction(chunk, offset);
+            op = patched;
+            if (next <= offset) {
+                break;
+            }
+            offset = next;
+        }
+        for (uint32_t i = 0; i < chunk->consts_.size(); i++) {
+            if (is_obj_function(chunk->consts_[i])) {
+                work.push_back(as_obj_function(chunk->consts_[i]));
+            }
+        }
     }
+    return best;
+}
 
-    auto bpIter = pendingBreakpoints[module].find(line);
-    if (bpIter != pendingBreakpoints[module].end()) {
-        bindBreakpoint(bpIter->second, ins);
+void AriaDebugger::bindPendingBreakpoints(const String &module)
+{
+    auto moduleIt = loadedModules.find(module);
+    auto pendingIt = pendingBreakpoints.find(module);
+    if (moduleIt == loadedModules.end() || pendingIt == pendingBreakpoints.end()) {
         return;
     }
-
-    auto nextOffset = Disassembler::readInstruction(frame->function->chunk_, offset);
-    if (nextOffset == 0) {
-        return;
+    List<Breakpoint> bps;
+    for (const auto &bp : pendingIt->second | std::views::values) {
+        bps.push_back(bp);
     }
-    auto nextLine = frame->function->chunk_->lines_[nextOffset];
-    // find breakpoint in empty or comment lines
-    auto bpLines = findPendingBreakpoints(module, line, nextLine);
-
-    if (!bpLines.empty()) {
-        // just need to set one breakpoint
-        bindBreakpoint(Breakpoint{module, line}, ins);
-        for (auto bpLine : bpLines) {
-            pendingBreakpoints[module].erase(bpLine);
+    for (auto &bp : bps) {
+        if (uint8_t *ins = findInstruction(moduleIt->second, bp.line)) {
+            bindBreakpoint(bp, ins);
         }
     }
 }
 
-bool AriaDebugger::isActiveBreakpoint(const String &module, uint32_t line)
-{
-    if (activeBreakpoints[module].contains(line)) {
-        return true;
-    }
-    return false;
-}
-
 void AriaDebugger::bindBreakpoint(Breakpoint bp, uint8_t *ins)
 {
+    // 同一条指令上可能绑定多个断点（空行上的断点落到后面的指令），只覆盖一次
+    if (!originals.contains(ins)) {
+        originals[ins] = *ins;
+        *ins = static_cast<uint8_t>(opCode::BREAKPOINT);
+    }
     bp.ins = ins;
     activeBreakpoints[bp.path][bp.line] = bp;
     pendingBreakpoints[bp.path].erase(bp.line);
 }
 
-List<uint32_t> AriaDebugger::findPendingBreakpoints(
-    const String &module, uint32_t startLine, uint32_t endLine)
-{
-    List<uint32_t> result;
-    if (startLine >= endLine || startLine + 1 == endLine) {
-        return result;
-    }
-
-    for (const auto &[a, _] : pendingBreakpoints[module]) {
-        if (a > startLine && a < endLine) {
-            result.push_back(a);
-        }
-    }
-
-    return result;
-}
-
-uint32_t AriaDebugger::findNearestPendingBefore(const String &module, uint32_t line)
+uint8_t AriaDebugger::originalByte(const uint8_t *ins) const
 {
-    auto modIt = pendingBreakpoints.find(module);
-    if (modIt == pendingBreakpoints.end())
-        return UINT32_MAX;
-
-    uint32_t nearest = UINT32_MAX;
-    for (const auto &l : modIt->second | std::views::keys) {
-        if (l < line && (nearest == UINT32_MAX || l > nearest))
-            nearest = l;
+    if (ins == repatchIns) {
+        return *ins;
     }
-    return nearest;
+    auto it = originals.find(const_cast<uint8_t *>(ins));
+    return it != originals.end() ? it->second : *ins;
 }
 
 void AriaDebugger::clearFlags()
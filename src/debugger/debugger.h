@@ -9,6 +9,7 @@ namespace aria {
 
 class AriaVM;
 struct CallFrame;
+class ObjFunction;
 enum class OpCode : uint8_t;
 
 class AriaDebugger
@@ -20,8 +21,17 @@ public:
 
     void runScript(const String &path);
 
+    // 模块的函数对象创建后、开始执行前调用，把该模块上待定的断点绑定到指令上
+    void hookModuleLoaded(ObjFunction *module);
+
+    // 单步或有断点等待补回时，解释器在每条指令分发前调用
     void hookBeforeExec(CallFrame *frame, uint32_t offset);
 
+    // 解释器执行到 BREAKPOINT 时调用，恢复原指令字节后进入命令行
+    void hookBreakpoint(CallFrame *frame, uint32_t offset);
+
+    [[nodiscard]] bool wantsHook() const { return stepping || repatchIns != nullptr; }
+
 private:
     void repl(); // 命令行交互
 
@@ -29,16 +39,15 @@ private:
 
     void addPendingBreakpoint(Breakpoint bp);
 
-    void checkAndBindBreakpoint(CallFrame *frame, uint32_t offset);
+    // 在模块及其嵌套函数的字节码中找行号不小于 line 的第一条指令（断点可能设在空行或注释行上）
+    uint8_t *findInstruction(ObjFunction *module, uint32_t line);
 
-    bool isActiveBreakpoint(const String &module, uint32_t line);
+    void bindPendingBreakpoints(const String &module);
 
     void bindBreakpoint(Breakpoint bp, uint8_t *ins);
 
-    // find bp between startLine and endLine in module
-    List<uint32_t> findPendingBreakpoints(const String &module, uint32_t startLine, uint32_t endLine);
-
-    uint32_t findNearestPendingBefore(const String &module, uint32_t line);
+    // 断点位置上被 BREAKPOINT 覆盖的原字节
+    uint8_t originalByte(const uint8_t *ins) const;
 
     void clearFlags();
 
@@ -48,6 +57,10 @@ private:
     String srcPath;
     Map<String, Map<uint32_t, Breakpoint>> activeBreakpoints;
     Map<String, Map<uint32_t, Breakpoint>> pendingBreakpoints;
+    Map<String, ObjFunction *> loadedModules;
+    Map<uint8_t *, uint8_t> originals;
+    // 刚恢复原字节的断点指令，它执行完后（下一次分发前）再写回 BREAKPOINT
+    uint8_t *repatchIns = nullptr;
     bool running = false;
     bool stepping = false;
 };
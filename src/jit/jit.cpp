@@ -0,0 +1,1022 @@
+#include "jit/jit.h"
+
+#if ARIA_JIT
+#include "chunk/chunk.h"
+#include "chunk/code.h"
+#include "chunk/disassembler.h"
+#include "jit/x64Assembler.h"
+#include "object/objException.h"
+#include "object/objFunction.h"
+#include "object/objString.h"
+#include "runtime/vm.h"
+#include "value/globalTable.h"
+
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace aria {
+
+struct JitCode
+{
+    void *memory;
+    size_t size;
+    // 字节码偏移 -> 机器码偏移，只记录函数入口和跳转目标
+    List<uint32_t> entries;
+};
+
+#if ARIA_JIT
+
+namespace {
+
+using namespace X64;
+
+// 机器码入口：JitResult (AriaVM *vm, Value *slots, Value *sp, const Value *consts, const void *target)
+using JitEntry = JitResult (*)(AriaVM *, Value *, Value *, const Value *, const void *);
+
+constexpr uint32_t k_no_entry = UINT32_MAX;
+
+// 机器码中常驻的状态，都是 callee-saved 寄存器，调用慢路径前后不需要保存
+constexpr Reg k_vm = RBX;
+constexpr Reg k_slots = R12;
+constexpr Reg k_sp = R13;
+constexpr Reg k_int_tag = R14;
+constexpr Reg k_consts = R15;
+
+// int32 的 NanBox 高 32 位
+constexpr int32_t k_int_tag_high = static_cast<int32_t>((NanBox::QNaN | NanBox::TagInt) >> 32);
+
+// 慢路径中抛出的 C++ 异常（致命运行时错误）不能穿过没有展开信息的机器码栈帧，
+// 先暂存起来，机器码返回到 Jit::run 之后再重新抛出
+thread_local std::exception_ptr pendingException;
+
+// 机器码经由 Jit::call 嵌套执行的层数，用来限制占用的 C++ 栈
+thread_local int nestDepth = 0;
+
+uint16_t wordAt(const uint8_t *codes, uint32_t offset)
+{
+    return static_cast<uint16_t>(codes[offset] | (codes[offset + 1] << 8));
+}
+
+Cond compareCond(opCode op)
+{
+    switch (op) {
+    case opCode::EQUAL:
+        return E;
+    case opCode::NOT_EQUAL:
+        return NE;
+    case opCode::GREATER:
+    case opCode::GREATER_NUM:
+        return G;
+    case opCode::GREATER_EQUAL:
+    case opCode::GREATER_EQUAL_NUM:
+        return GE;
+    case opCode::LESS:
+    case opCode::LESS_NUM:
+        return L;
+    default:
+        return LE;
+    }
+}
+
+Cond negateCond(Cond cond)
+{
+    return static_cast<Cond>(cond ^ 1);
+}
+
+} // namespace
+
+class JitCompiler
+{
+public:
+    JitCompiler(AriaVM *vm, ObjFunction *function)
+        : vm{vm}
+        , function{function}
+        , chunk{function->chunk_}
+        , codes{function->chunk_->codes_}
+        , exitLabel{as.newLabel()}
+        , leaveLabel{as.newLabel()}
+    {}
+
+    // return nullptr if the function uses unsupported instructions
+    JitCode *compile();
+
+private:
+    using Label = Assembler::Label;
+
+    static constexpr Label k_no_label = UINT32_MAX;
+
+    Assembler as;
+    AriaVM *vm;
+    ObjFunction *function;
+    Chunk *chunk;
+    uint8_t *codes;
+    // 跳转目标处的标签，按字节码偏移索引
+    List<Label> labels;
+    // 慢路径在所有指令之后统一生成，快速路径保持顺序执行
+    List<std::function<void()>> slowPaths;
+    Label exitLabel;
+    Label leaveLabel;
+
+    bool scan();
+
+    void prologue();
+
+    void epilogue();
+
+    void instruction(uint32_t offset, uint32_t next);
+
+    template<typename Helper>
+    void callHelper(Helper helper, const uint8_t *ip, uint32_t arg = 0);
+
+    template<typename Helper>
+    void callStackHelper(Helper helper, const uint8_t *ip, uint32_t arg = 0);
+
+    template<typename Helper>
+    void callValue(Helper helper, const uint8_t *ip, uint8_t argCount);
+
+    void exitAt(const uint8_t *ip);
+
+    void push(Reg reg);
+
+    void guardInt(Reg reg, Label slow);
+
+    void boxBool(Cond cond);
+
+    void branch(bool pop, bool jumpIfTrue, Label target);
+
+    void arithmetic(opCode op, const uint8_t *ip);
+
+    void compare(opCode op, const uint8_t *ip);
+
+    void loadGlobal(uint16_t slot, const uint8_t *ip);
+
+    void storeGlobal(uint16_t slot, const uint8_t *ip);
+
+    void incLocal(uint32_t offset);
+
+    void compareJump(uint32_t offset);
+
+    void loopBackEdge(uint32_t target);
+
+    void tailCall(uint32_t offset, const uint8_t *ip);
+};
+
+JitCode *JitCompiler::compile()
+{
+    if (!scan()) {
+        return nullptr;
+    }
+    prologue();
+    auto entries = List<uint32_t>(chunk->count_, k_no_entry);
+    for (uint32_t offset = 0; offset < chunk->count_;) {
+        if (labels[offset] != k_no_label) {
+            as.bind(labels[offset]);
+            entries[offset] = as.size();
+        }
+        uint32_t next = Disassembler::readInstruction(chunk, offset);
+        instruction(offset, next);
+        offset = next;
+    }
+    for (const auto &slowPath : slowPaths) {
+        slowPath();
+    }
+    epilogue();
+    as.finalize();
+
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t size = (as.size() + pageSize - 1) / pageSize * pageSize;
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    std::memcpy(memory, as.data(), as.size());
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return nullptr;
+    }
+    return new JitCode{memory, size, std::move(entries)};
+}
+
+// 检查所有指令是否都有模板，并为函数入口和跳转目标创建标签
+bool JitCompiler::scan()
+{
+    // 异常展开后由解释器跳到 handler 继续执行，含 try 块的函数不编译
+    if (!chunk->handlers_.empty()) {
+        return false;
+    }
+    labels.assign(chunk->count_ + 1, k_no_label);
+    labels[0] = as.newLabel();
+    auto target = [this](uint32_t offset) {
+        if (labels[offset] == k_no_label) {
+            labels[offset] = as.newLabel();
+        }
+    };
+    for (uint32_t offset = 0; offset < chunk->count_;) {
+        switch (static_cast<opCode>(codes[offset])) {
+        case opCode::LOAD_CONST:
+        case opCode::LOAD_NIL:
+        case opCode::LOAD_TRUE:
+        case opCode::LOAD_FALSE:
+        case opCode::LOAD_LOCAL:
+        case opCode::STORE_LOCAL:
+        case opCode::DEF_GLOBAL:
+        case opCode::LOAD_GLOBAL:
+        case opCode::STORE_GLOBAL:
+        case opCode::EQUAL:
+        case opCode::NOT_EQUAL:
+        case opCode::GREATER:
+        case opCode::GREATER_EQUAL:
+        case opCode::LESS:
+        case opCode::LESS_EQUAL:
+        case opCode::ADD:
+        case opCode::SUBTRACT:
+        case opCode::MULTIPLY:
+        case opCode::DIVIDE:
+        case opCode::MOD:
+        case opCode::NOT:
+        case opCode::NEGATE:
+        case opCode::POP:
+        case opCode::POP_N:
+        case opCode::PRINT:
+        case opCode::NOP:
+        case opCode::CALL:
+        case opCode::TAIL_CALL:
+        case opCode::RETURN:
+        case opCode::INC_LOCAL:
+        case opCode::ADD_NUM:
+        case opCode::SUBTRACT_NUM:
+        case opCode::MULTIPLY_NUM:
+        case opCode::DIVIDE_NUM:
+        case opCode::MOD_NUM:
+        case opCode::GREATER_NUM:
+        case opCode::GREATER_EQUAL_NUM:
+        case opCode::LESS_NUM:
+        case opCode::LESS_EQUAL_NUM:
+            break;
+        case opCode::JUMP_FWD:
+            target(offset + 3 - wordAt(codes, offset + 1));
+            break;
+        case opCode::JUMP_BWD:
+        case opCode::JUMP_TRUE:
+        case opCode::JUMP_TRUE_NOPOP:
+        case opCode::JUMP_FALSE:
+        case opCode::JUMP_FALSE_NOPOP:
+            target(offset + 3 + wordAt(codes, offset + 1));
+            break;
+        case opCode::LOCAL_LOCAL_CMP_JUMP:
+        case opCode::LOCAL_CONST_CMP_JUMP:
+            target(offset + 10 + wordAt(codes, offset + 8));
+            break;
+        case opCode::FOR_RANGE:
+            target(offset + 24);
+            target(offset + 24 - wordAt(codes, offset + 22));
+            break;
+        default:
+            return false;
+        }
+        offset = Disassembler::readInstruction(chunk, offset);
+    }
+    // 跳转目标必须落在某条指令上
+    return labels[chunk->count_] == k_no_label;
+}
+
+void JitCompiler::prologue()
+{
+    as.push(RBX);
+    as.push(R12);
+    as.push(R13);
+    as.push(R14);
+    as.push(R15);
+    as.movRR(k_vm, RDI);
+    as.movRR(k_slots, RSI);
+    as.movRR(k_sp, RDX);
+    as.movRR(k_consts, RCX);
+    as.movRI(k_int_tag, NanBox::QNaN | NanBox::TagInt);
+    as.jmpR(R8);
+}
+
+// exitLabel：状态已由慢路径保存，返回 {0, ?}；leaveLabel：rax:rdx 中已是 JitResult
+void JitCompiler::epilogue()
+{
+    as.bind(exitLabel);
+    as.xorRR32(RAX, RAX);
+    as.bind(leaveLabel);
+    as.pop(R15);
+    as.pop(R14);
+    as.pop(R13);
+    as.pop(R12);
+    as.pop(RBX);
+    as.ret();
+}
+
+// helper(vm, sp, ip, arg)
+template<typename Helper>
+void JitCompiler::callHelper(Helper helper, const uint8_t *ip, uint32_t arg)
+{
+    as.movRR(RDI, k_vm);
+    as.movRR(RSI, k_sp);
+    as.movRI(RDX, reinterpret_cast<uint64_t>(ip));
+    as.movRI(RCX, arg);
+    as.movRI(RAX, reinterpret_cast<uint64_t>(helper));
+    as.callR(RAX);
+}
+
+// 返回新栈顶的慢路径，返回 nullptr 时离开机器码
+template<typename Helper>
+void JitCompiler::callStackHelper(Helper helper, const uint8_t *ip, uint32_t arg)
+{
+    callHelper(helper, ip, arg);
+    as.testRR(RAX, RAX);
+    as.jcc(E, exitLabel);
+    as.movRR(k_sp, RAX);
+}
+
+// CALL 类慢路径：被调用函数建立栈帧时值栈可能扩容搬迁，k_slots 随之失效。
+// 调用前把 k_slots 换成相对栈顶的偏移，返回后按新栈顶恢复（被调用者和参数已换成返回值）
+template<typename Helper>
+void JitCompiler::callValue(Helper helper, const uint8_t *ip, uint8_t argCount)
+{
+    as.subRR(k_slots, k_sp);
+    callStackHelper(helper, ip, argCount);
+    as.addRR(k_slots, k_sp);
+    as.addRI(k_slots, argCount * static_cast<int32_t>(sizeof(Value)));
+}
+
+// 保存状态后退回解释器，从 ip 处继续执行
+void JitCompiler::exitAt(const uint8_t *ip)
+{
+    callHelper(&Jit::sync, ip);
+    as.jmp(exitLabel);
+}
+
+void JitCompiler::push(Reg reg)
+{
+    as.store(k_sp, 0, reg);
+    as.addRI(k_sp, 8);
+}
+
+// 只接受规范的 int32 表示（高 32 位恰好是标签），其余数字交给慢路径
+void JitCompiler::guardInt(Reg reg, Label slow)
+{
+    as.movRR(RDX, reg);
+    as.shrRI(RDX, 32);
+    as.cmpRI32(RDX, k_int_tag_high);
+    as.jcc(NE, slow);
+}
+
+// rax = cond ? true : false，TrueValue 紧跟在 FalseValue 之后
+void JitCompiler::boxBool(Cond cond)
+{
+    as.setcc(cond, RAX);
+    as.movzxRR8(RAX, RAX);
+    as.movRI(RDX, NanBox::FalseValue);
+    as.addRR(RAX, RDX);
+}
+
+// nil 和 false 为假，它们的 NanBox 相邻：v - nil <= 1
+void JitCompiler::branch(bool pop, bool jumpIfTrue, Label target)
+{
+    as.load(RAX, k_sp, -8);
+    if (pop) {
+        as.subRI(k_sp, 8);
+    }
+    as.movRI(RDX, NanBox::NilValue);
+    as.subRR(RAX, RDX);
+    as.cmpRI(RAX, 1);
+    as.jcc(jumpIfTrue ? A : BE, target);
+}
+
+void JitCompiler::arithmetic(opCode op, const uint8_t *ip)
+{
+    const Label slow = as.newLabel();
+    const Label done = as.newLabel();
+    as.load(RAX, k_sp, -16);
+    as.load(RCX, k_sp, -8);
+    guardInt(RAX, slow);
+    guardInt(RCX, slow);
+    switch (op) {
+    case opCode::ADD:
+    case opCode::ADD_NUM:
+        as.addRR32(RAX, RCX);
+        as.jcc(O, slow);
+        break;
+    case opCode::SUBTRACT:
+    case opCode::SUBTRACT_NUM:
+        as.subRR32(RAX, RCX);
+        as.jcc(O, slow);
+        break;
+    default:
+        // 结果为 0 时可能是 -0，交给慢路径
+        as.imulRR32(RAX, RCX);
+        as.jcc(O, slow);
+        as.testRR32(RAX, RAX);
+        as.jcc(E, slow);
+        break;
+    }
+    as.orRR(RAX, k_int_tag);
+    as.store(k_sp, -16, RAX);
+    as.subRI(k_sp, 8);
+    as.bind(done);
+    slowPaths.emplace_back([=, this] {
+        as.bind(slow);
+        callStackHelper(&Jit::binary_op, ip, static_cast<uint32_t>(op));
+        as.jmp(done);
+    });
+}
+
+void JitCompiler::compare(opCode op, const uint8_t *ip)
+{
+    const Label slow = as.newLabel();
+    const Label done = as.newLabel();
+    as.load(RAX, k_sp, -16);
+    as.load(RCX, k_sp, -8);
+    guardInt(RAX, slow);
+    guardInt(RCX, slow);
+    as.cmpRR32(RAX, RCX);
+    boxBool(compareCond(op));
+    as.store(k_sp, -16, RAX);
+    as.subRI(k_sp, 8);
+    as.bind(done);
+    slowPaths.emplace_back([=, this] {
+        as.bind(slow);
+        callStackHelper(&Jit::binary_op, ip, static_cast<uint32_t>(op));
+        as.jmp(done);
+    });
+}
+
+// 槽位一旦有值就不会再变回未定义，编译时已有值（或绑定了内置函数）的全局变量直接读写。
+// 槽位数组在新增全局变量时可能搬移，因此经由 values_address() 间接访问
+void JitCompiler::loadGlobal(uint16_t slot, const uint8_t *ip)
+{
+    GlobalTable *globals = chunk->globals_;
+    if (globals->value(slot) == GlobalTable::k_undefined) {
+        callStackHelper(&Jit::load_global, ip, slot);
+        return;
+    }
+    as.movRI(RAX, reinterpret_cast<uint64_t>(globals->values_address()));
+    as.load(RAX, RAX, 0);
+    as.load(RAX, RAX, slot * static_cast<int32_t>(sizeof(Value)));
+    push(RAX);
+}
+
+void JitCompiler::storeGlobal(uint16_t slot, const uint8_t *ip)
+{
+    GlobalTable *globals = chunk->globals_;
+    if (!globals->is_defined(slot)) {
+        callStackHelper(&Jit::store_global, ip, slot);
+        return;
+    }
+    as.movRI(RAX, reinterpret_cast<uint64_t>(globals->values_address()));
+    as.load(RAX, RAX, 0);
+    as.load(RCX, k_sp, -8);
+    as.store(RAX, slot * static_cast<int32_t>(sizeof(Value)), RCX);
+}
+
+// LOAD_LOCAL a; LOAD_CONST k; ADD|SUBTRACT; STORE_LOCAL a; POP
+void JitCompiler::incLocal(uint32_t offset)
+{
+    const int32_t local = wordAt(codes, offset + 1) * static_cast<int32_t>(sizeof(Value));
+    const int32_t step = wordAt(codes, offset + 4) * static_cast<int32_t>(sizeof(Value));
+    const auto op = static_cast<opCode>(codes[offset + 6]);
+    const bool add = op == opCode::ADD || op == opCode::ADD_NUM;
+    const Label slow = as.newLabel();
+    const Label done = as.newLabel();
+    as.load(RAX, k_slots, local);
+    as.load(RCX, k_consts, step);
+    guardInt(RAX, slow);
+    guardInt(RCX, slow);
+    if (add) {
+        as.addRR32(RAX, RCX);
+    } else {
+        as.subRR32(RAX, RCX);
+    }
+    as.jcc(O, slow);
+    as.orRR(RAX, k_int_tag);
+    as.store(k_slots, local, RAX);
+    as.bind(done);
+    // 守卫失败：按原始指令序列执行
+    slowPaths.emplace_back([=, this] {
+        as.bind(slow);
+        as.load(RAX, k_slots, local);
+        as.load(RCX, k_consts, step);
+        push(RAX);
+        push(RCX);
+        callStackHelper(&Jit::binary_op, codes + offset + 7, static_cast<uint32_t>(op));
+        as.load(RAX, k_sp, -8);
+        as.store(k_slots, local, RAX);
+        as.subRI(k_sp, 8);
+        as.jmp(done);
+    });
+}
+
+// LOAD_LOCAL a; LOAD_LOCAL b | LOAD_CONST k; compare; JUMP_FALSE
+void JitCompiler::compareJump(uint32_t offset)
+{
+    const int32_t lhs = wordAt(codes, offset + 1) * static_cast<int32_t>(sizeof(Value));
+    const int32_t rhs = wordAt(codes, offset + 4) * static_cast<int32_t>(sizeof(Value));
+    const Reg rhsBase = static_cast<opCode>(codes[offset + 3]) == opCode::LOAD_LOCAL ? k_slots
+                                                                                     : k_consts;
+    const auto op = static_cast<opCode>(codes[offset + 6]);
+    const Label target = labels[offset + 10 + wordAt(codes, offset + 8)];
+    const Label slow = as.newLabel();
+    const Label done = as.newLabel();
+    as.load(RAX, k_slots, lhs);
+    as.load(RCX, rhsBase, rhs);
+    guardInt(RAX, slow);
+    guardInt(RCX, slow);
+    as.cmpRR32(RAX, RCX);
+    as.jcc(negateCond(compareCond(op)), target);
+    as.bind(done);
+    slowPaths.emplace_back([=, this] {
+        as.bind(slow);
+        as.load(RAX, k_slots, lhs);
+        as.load(RCX, rhsBase, rhs);
+        push(RAX);
+        push(RCX);
+        callStackHelper(&Jit::binary_op, codes + offset + 7, static_cast<uint32_t>(op));
+        branch(true, false, target);
+        as.jmp(done);
+    });
+}
+
+// 循环回边：调试器附加后退回解释器
+void JitCompiler::loopBackEdge(uint32_t target)
+{
+    const Label deopt = as.newLabel();
+    as.movRI(RAX, reinterpret_cast<uint64_t>(&vm->debugger_));
+    as.cmpMI8(RAX, 0, 0);
+    as.jcc(NE, deopt);
+    as.jmp(labels[target]);
+    slowPaths.emplace_back([=, this] {
+        as.bind(deopt);
+        exitAt(codes + target);
+    });
+}
+
+// 被调用者就是当前函数时复用栈帧后跳回函数入口，常量表不变，栈帧基址按新栈顶重新计算；
+// 其余被调用者交给 Jit::tail_call
+void JitCompiler::tailCall(uint32_t offset, const uint8_t *ip)
+{
+    const uint8_t argCount = codes[offset + 1];
+    if (!function->accepts_varargs_ && function->arity_ == argCount) {
+        const Label other = as.newLabel();
+        as.load(RAX, k_sp, -(argCount + 1) * static_cast<int32_t>(sizeof(Value)));
+        as.movRI(RDX, NanBox::fromObj(function));
+        as.cmpRR(RAX, RDX);
+        as.jcc(NE, other);
+        callStackHelper(&Jit::self_tail_call, ip, argCount);
+        as.movRR(k_slots, k_sp);
+        as.subRI(k_slots, (argCount + 1) * static_cast<int32_t>(sizeof(Value)));
+        as.jmp(labels[0]);
+        as.bind(other);
+    }
+    callValue(&Jit::tail_call, ip, argCount);
+}
+
+void JitCompiler::instruction(uint32_t offset, uint32_t next)
+{
+    const uint8_t *ip = codes + next;
+    const auto op = static_cast<opCode>(codes[offset]);
+    switch (op) {
+    case opCode::LOAD_CONST:
+        as.load(RAX, k_consts, wordAt(codes, offset + 1) * static_cast<int32_t>(sizeof(Value)));
+        push(RAX);
+        break;
+    case opCode::LOAD_NIL:
+        as.movRI(RAX, NanBox::NilValue);
+        push(RAX);
+        break;
+    case opCode::LOAD_TRUE:
+        as.movRI(RAX, NanBox::TrueValue);
+        push(RAX);
+        break;
+    case opCode::LOAD_FALSE:
+        as.movRI(RAX, NanBox::FalseValue);
+        push(RAX);
+        break;
+    case opCode::LOAD_LOCAL:
+        as.load(RAX, k_slots, wordAt(codes, offset + 1) * static_cast<int32_t>(sizeof(Value)));
+        push(RAX);
+        break;
+    case opCode::STORE_LOCAL:
+        as.load(RAX, k_sp, -8);
+        as.store(k_slots, wordAt(codes, offset + 1) * static_cast<int32_t>(sizeof(Value)), RAX);
+        break;
+    case opCode::DEF_GLOBAL:
+        callStackHelper(&Jit::def_global, ip, wordAt(codes, offset + 1));
+        break;
+    case opCode::LOAD_GLOBAL:
+        loadGlobal(wordAt(codes, offset + 1), ip);
+        break;
+    case opCode::STORE_GLOBAL:
+        storeGlobal(wordAt(codes, offset + 1), ip);
+        break;
+    case opCode::EQUAL:
+    case opCode::NOT_EQUAL:
+    case opCode::GREATER:
+    case opCode::GREATER_EQUAL:
+    case opCode::LESS:
+    case opCode::LESS_EQUAL:
+    case opCode::GREATER_NUM:
+    case opCode::GREATER_EQUAL_NUM:
+    case opCode::LESS_NUM:
+    case opCode::LESS_EQUAL_NUM:
+        compare(op, ip);
+        break;
+    case opCode::ADD:
+    case opCode::SUBTRACT:
+    case opCode::MULTIPLY:
+    case opCode::ADD_NUM:
+    case opCode::SUBTRACT_NUM:
+    case opCode::MULTIPLY_NUM:
+        arithmetic(op, ip);
+        break;
+    case opCode::DIVIDE:
+    case opCode::MOD:
+    case opCode::DIVIDE_NUM:
+    case opCode::MOD_NUM:
+        callStackHelper(&Jit::binary_op, ip, static_cast<uint32_t>(op));
+        break;
+    case opCode::NOT:
+        as.load(RAX, k_sp, -8);
+        as.movRI(RDX, NanBox::NilValue);
+        as.subRR(RAX, RDX);
+        as.cmpRI(RAX, 1);
+        boxBool(BE);
+        as.store(k_sp, -8, RAX);
+        break;
+    case opCode::NEGATE:
+        callStackHelper(&Jit::negate, ip);
+        break;
+    case opCode::POP:
+        as.subRI(k_sp, 8);
+        break;
+    case opCode::POP_N:
+        as.subRI(k_sp, codes[offset + 1] * static_cast<int32_t>(sizeof(Value)));
+        break;
+    case opCode::PRINT:
+        callStackHelper(&Jit::print, ip);
+        break;
+    case opCode::NOP:
+        break;
+    case opCode::JUMP_FWD:
+        loopBackEdge(next - wordAt(codes, offset + 1));
+        break;
+    case opCode::JUMP_BWD:
+        as.jmp(labels[next + wordAt(codes, offset + 1)]);
+        break;
+    case opCode::JUMP_TRUE:
+        branch(true, true, labels[next + wordAt(codes, offset + 1)]);
+        break;
+    case opCode::JUMP_TRUE_NOPOP:
+        branch(false, true, labels[next + wordAt(codes, offset + 1)]);
+        break;
+    case opCode::JUMP_FALSE:
+        branch(true, false, labels[next + wordAt(codes, offset + 1)]);
+        break;
+    case opCode::JUMP_FALSE_NOPOP:
+        branch(false, false, labels[next + wordAt(codes, offset + 1)]);
+        break;
+    case opCode::CALL:
+        callValue(&Jit::call, ip, codes[offset + 1]);
+        break;
+    case opCode::TAIL_CALL:
+        tailCall(offset, ip);
+        break;
+    case opCode::RETURN:
+        callHelper(&Jit::ret, ip);
+        as.jmp(leaveLabel);
+        break;
+    case opCode::INC_LOCAL:
+        incLocal(offset);
+        break;
+    case opCode::LOCAL_LOCAL_CMP_JUMP:
+    case opCode::LOCAL_CONST_CMP_JUMP:
+        compareJump(offset);
+        break;
+    case opCode::FOR_RANGE:
+        incLocal(offset);
+        compareJump(offset + 11);
+        loopBackEdge(next - wordAt(codes, offset + 22));
+        break;
+    default:
+        break;
+    }
+}
+
+bool Jit::run(AriaVM *vm, uint32_t offset, Value &result)
+{
+    if (vm->debugger_ != nullptr) {
+        return false;
+    }
+    ObjFunction *function = vm->frame_->function;
+    if (function->jit_code_ == nullptr) {
+        function->jit_code_ = JitCompiler{vm, function}.compile();
+        if (function->jit_code_ == nullptr) {
+            return false;
+        }
+    }
+    if (function->jit_code_->entries[offset] == k_no_entry) {
+        return false;
+    }
+    JitResult r = invoke(vm, function->jit_code_, offset);
+    if (pendingException) {
+        std::rethrow_exception(std::exchange(pendingException, nullptr));
+    }
+    result = r.value;
+    return r.returned != 0;
+}
+
+void Jit::release(JitCode *code)
+{
+    if (code != nullptr) {
+        munmap(code->memory, code->size);
+        delete code;
+    }
+}
+
+JitResult Jit::invoke(AriaVM *vm, const JitCode *code, uint32_t offset)
+{
+    const CallFrame *frame = vm->frame_;
+    const auto entry = reinterpret_cast<JitEntry>(code->memory);
+    const void *target = static_cast<uint8_t *>(code->memory) + code->entries[offset];
+    ++nestDepth;
+    JitResult r = entry(
+        vm,
+        frame->stakBase,
+        vm->stack_.get_top_ptr(),
+        frame->function->chunk_->consts_.data(),
+        target);
+    --nestDepth;
+    return r;
+}
+
+void Jit::sync(AriaVM *vm, Value *sp, uint8_t *ip)
+{
+    vm->frame_->ip = ip;
+    vm->stack_.set_top_ptr(sp);
+}
+
+Value *Jit::binary_op(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t op)
+{
+    try {
+        sync(vm, sp, ip);
+        const CallFrame *frame = vm->frame_;
+        const Value a = sp[-2];
+        const Value b = sp[-1];
+        switch (static_cast<opCode>(op)) {
+        case opCode::EQUAL:
+            sp[-2] = NanBox::fromBool(values_same(a, b));
+            return sp - 1;
+        case opCode::NOT_EQUAL:
+            sp[-2] = NanBox::fromBool(!values_same(a, b));
+            return sp - 1;
+        case opCode::ADD:
+        case opCode::ADD_NUM:
+            if (NanBox::isNumbers(a, b)) {
+                sp[-2] = NanBox::add(a, b);
+                return sp - 1;
+            }
+            vm->add_objects();
+            break;
+        case opCode::SUBTRACT:
+        case opCode::SUBTRACT_NUM:
+            vm->numeric_bin_op<NumericBinOp::SUB>();
+            break;
+        case opCode::MULTIPLY:
+        case opCode::MULTIPLY_NUM:
+            vm->numeric_bin_op<NumericBinOp::MUL>();
+            break;
+        case opCode::DIVIDE:
+        case opCode::DIVIDE_NUM:
+            vm->numeric_bin_op<NumericBinOp::DIV>();
+            break;
+        case opCode::MOD:
+        case opCode::MOD_NUM:
+            vm->numeric_bin_op<NumericBinOp::MOD>();
+            break;
+        case opCode::GREATER:
+        case opCode::GREATER_NUM:
+            vm->numeric_bin_op<NumericBinOp::GT>();
+            break;
+        case opCode::GREATER_EQUAL:
+        case opCode::GREATER_EQUAL_NUM:
+            vm->numeric_bin_op<NumericBinOp::GE>();
+            break;
+        case opCode::LESS:
+        case opCode::LESS_NUM:
+            vm->numeric_bin_op<NumericBinOp::LT>();
+            break;
+        default:
+            vm->numeric_bin_op<NumericBinOp::LE>();
+            break;
+        }
+        return vm->frame_ == frame ? vm->stack_.get_top_ptr() : nullptr;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+Value *Jit::negate(AriaVM *vm, Value *sp, uint8_t *ip)
+{
+    try {
+        sync(vm, sp, ip);
+        if (!NanBox::isNumber(sp[-1])) {
+            vm->throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Operand must be number.");
+            return nullptr;
+        }
+        sp[-1] = NanBox::negate(sp[-1]);
+        return sp;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+Value *Jit::def_global(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t slot)
+{
+    try {
+        sync(vm, sp, ip);
+        GlobalTable *globals = vm->chunk_->globals_;
+        if (!globals->define(slot, sp[-1])) {
+            String msg = format("Existed variable '{}'.", globals->name(slot)->c_str());
+            vm->throw_exception(ErrorCode::RUNTIME_EXISTED_VARIABLE, msg);
+            return nullptr;
+        }
+        return sp - 1;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+Value *Jit::load_global(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t slot)
+{
+    try {
+        sync(vm, sp, ip);
+        GlobalTable *globals = vm->chunk_->globals_;
+        Value value = globals->value(slot);
+        if (value == GlobalTable::k_undefined) {
+            String msg = format("Undefined variable '{}'.", globals->name(slot)->c_str());
+            vm->throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
+            return nullptr;
+        }
+        *sp = value;
+        return sp + 1;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+Value *Jit::store_global(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t slot)
+{
+    try {
+        sync(vm, sp, ip);
+        GlobalTable *globals = vm->chunk_->globals_;
+        if (!globals->is_defined(slot)) {
+            String msg = format("Undefined variable '{}'.", globals->name(slot)->c_str());
+            vm->throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
+            return nullptr;
+        }
+        globals->value(slot) = sp[-1];
+        return sp;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+// 被调用的是已编译（或刚好变热）的函数时在机器码中递归执行，
+// 否则当前帧退出，解释器执行被调用函数并在其返回后继续执行当前帧
+Value *Jit::call(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t argCount)
+{
+    try {
+        sync(vm, sp, ip);
+        const int count = static_cast<int>(argCount);
+        Value callee = sp[-1 - count];
+        // 已编译函数的直接调用：参数个数精确匹配时跳过 call_value
+        if (is_obj_function(callee)) {
+            ObjFunction *function = as_obj_function(callee);
+            if (function->jit_code_ != nullptr && !function->accepts_varargs_
+                && function->arity_ == count && nestDepth < k_max_nest_depth
+                && vm->c_frame_count_ < AriaVM::k_max_frames && vm->debugger_ == nullptr
+                && vm->reserve_stack(function->chunk_->count_ + AriaVM::k_stack_slack)) {
+                // 值栈可能已经扩容，sp 不再有效
+                vm->push_call_frame(
+                    function, function->chunk_->codes_, vm->stack_.get_top_ptr() - 1 - count);
+                JitResult r = invoke(vm, function->jit_code_, 0);
+                if (r.returned == 0) {
+                    return nullptr;
+                }
+                vm->stack_.push(r.value);
+                return vm->stack_.get_top_ptr();
+            }
+        }
+        Value result = vm->call_value(callee, count);
+        if (vm->get_err_flag()) {
+            if (!is_obj_exception(result)) {
+                vm->report_runtime_fatal_error(ErrorCode::RUNTIME_UNKNOWN, "Invalid return value");
+            }
+            vm->throw_exception(as_obj_exception(result));
+            return nullptr;
+        }
+        // 原生函数等已经执行完毕
+        if (vm->frame_->ip != vm->chunk_->codes_) {
+            return vm->stack_.get_top_ptr();
+        }
+        ObjFunction *function = vm->frame_->function;
+        if (nestDepth >= k_max_nest_depth) {
+            return nullptr;
+        }
+        if (function->jit_code_ == nullptr && ++function->hotness_ != k_hot_threshold) {
+            return nullptr;
+        }
+        if (!run(vm, 0, result)) {
+            return nullptr;
+        }
+        vm->stack_.push(result);
+        return vm->stack_.get_top_ptr();
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+// 复用栈帧后退出机器码，解释器从被调用函数的开头继续执行；
+// 被调用者不是 Aria 函数时按 CALL 执行，之后的 RETURN 返回其结果
+Value *Jit::tail_call(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t argCount)
+{
+    try {
+        sync(vm, sp, ip);
+        if (vm->tail_call(static_cast<int>(argCount))) {
+            return nullptr;
+        }
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+    // tail_call 预留栈帧时值栈可能已经扩容，sp 不再有效
+    return call(vm, vm->stack_.get_top_ptr(), ip, argCount);
+}
+
+Value *Jit::self_tail_call(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t argCount)
+{
+    try {
+        sync(vm, sp, ip);
+        if (!vm->tail_call(static_cast<int>(argCount))) {
+            // 新栈帧的槽位预留失败：按 CALL 执行并抛出栈溢出异常，回到解释器
+            call(vm, vm->stack_.get_top_ptr(), ip, argCount);
+            return nullptr;
+        }
+        // 调试器附加后从函数开头回到解释器
+        return vm->debugger_ == nullptr ? vm->stack_.get_top_ptr() : nullptr;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+Value *Jit::print(AriaVM *vm, Value *sp, uint8_t *ip)
+{
+    try {
+        sync(vm, sp, ip);
+        write_value(sp[-1], vm->output_);
+        vm->output_.end_line();
+        return sp - 1;
+    } catch (...) {
+        pendingException = std::current_exception();
+        return nullptr;
+    }
+}
+
+JitResult Jit::ret(AriaVM *vm, Value *sp, uint8_t *ip)
+{
+    try {
+        sync(vm, sp, ip);
+        Value result = vm->stack_.pop();
+        vm->stack_.resize(static_cast<uint32_t>(vm->frame_->stakBase - vm->stack_.base()));
+        return {1, vm->return_from_current_frame(result)};
+    } catch (...) {
+        pendingException = std::current_exception();
+        return {0, NanBox::NilValue};
+    }
+}
+
+#else
+
+void Jit::release(JitCode *code)
+{
+    delete code;
+}
+
+#endif
+
+} // namespace aria
@@ -0,0 +1,74 @@
+#ifndef ARIA_JIT_H
+#define ARIA_JIT_H
+
+#include "common.h"
+#include "value/value.h"
+
+namespace aria {
+class AriaVM;
+class ObjFunction;
+struct JitCode;
+
+// 机器码的返回值（rax:rdx）：returned 为 0 表示中途退出，由解释器从 VM 当前状态继续执行
+struct JitResult
+{
+    uint64_t returned;
+    Value value;
+};
+
+// 基线模板 JIT（x86-64 Linux，CMake 选项 ENABLE_JIT / 宏 ARIA_JIT）。
+// 调用次数与循环回边次数之和达到 k_hot_threshold 的函数整体编译为机器码：
+// 每条字节码对应一段固定的指令模板，按字节码顺序拼接到可执行内存中。
+// 机器码直接读写 VM 的值栈和栈帧，只内联 int32 快速路径、局部变量、字面量、全局变量和跳转，
+// 其余情况调用 VM 已有的实现（call_value、numeric_bin_op、throw_exception 等）。
+// 在调用慢路径的指令边界上 VM 状态与解释器完全一致，因此可以随时退出（去优化）：
+// 异常展开到其他栈帧、被调用函数未编译、调试器附加时保存 ip 和栈顶后返回，解释器接着执行。
+// 只编译由局部/全局变量、字面量、算术比较、函数调用和基本控制流组成的栈式字节码函数
+class Jit
+{
+public:
+    static constexpr uint32_t k_hot_threshold = 1000;
+
+    // 机器码之间直接调用会在 C++ 栈上嵌套，超过这个深度后退回解释器执行被调用函数
+    static constexpr int k_max_nest_depth = 256;
+
+    // 在 vm 的栈顶帧上从字节码偏移 offset 处执行编译后的代码（0 为函数入口，其余为循环回边的目标），
+    // 函数尚未编译时先编译。该帧执行到 RETURN 时返回 true 并给出返回值，此时栈帧已弹出；
+    // 无法编译或中途退出时返回 false
+    static bool run(AriaVM *vm, uint32_t offset, Value &result);
+
+    static void release(JitCode *code);
+
+private:
+    friend class JitCompiler;
+
+    static JitResult invoke(AriaVM *vm, const JitCode *code, uint32_t offset);
+
+    // 以下由机器码调用：sp 为机器码中的栈顶，ip 为当前指令之后的位置。
+    // 返回新的栈顶；返回 nullptr 表示异常已展开到其他栈帧，或者需要退回解释器
+    static void sync(AriaVM *vm, Value *sp, uint8_t *ip);
+
+    static Value *binary_op(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t op);
+
+    static Value *negate(AriaVM *vm, Value *sp, uint8_t *ip);
+
+    static Value *def_global(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t slot);
+
+    static Value *load_global(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t slot);
+
+    static Value *store_global(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t slot);
+
+    static Value *call(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t argCount);
+
+    static Value *tail_call(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t argCount);
+
+    static Value *self_tail_call(AriaVM *vm, Value *sp, uint8_t *ip, uint32_t argCount);
+
+    static Value *print(AriaVM *vm, Value *sp, uint8_t *ip);
+
+    static JitResult ret(AriaVM *vm, Value *sp, uint8_t *ip);
+};
+
+} // namespace aria
+
+#endif //ARIA_JIT_H
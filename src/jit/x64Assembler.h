@@ -0,0 +1,295 @@
+#ifndef ARIA_X64ASSEMBLER_H
+#define ARIA_X64ASSEMBLER_H
+
+#include "common.h"
+
+#include <cstring>
+
+namespace aria {
+
+namespace X64 {
+
+enum Reg : uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+// 条件码，对应 Jcc / SETcc 操作码的低 4 位
+enum Cond : uint8_t {
+    O = 0x0,
+    NO = 0x1,
+    B = 0x2,
+    AE = 0x3,
+    E = 0x4,
+    NE = 0x5,
+    BE = 0x6,
+    A = 0x7,
+    L = 0xc,
+    GE = 0xd,
+    LE = 0xe,
+    G = 0xf,
+};
+
+// 模板 JIT 用到的 x86-64 指令编码。
+// 只覆盖 Jit 生成的几种形式：寄存器、[base + disp] 内存操作数、立即数和 rel32 跳转；
+// 名字中的 32 表示 32 位操作数，其余为 64 位
+class Assembler
+{
+public:
+    using Label = uint32_t;
+
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(code_.size()); }
+
+    [[nodiscard]] const uint8_t *data() const { return code_.data(); }
+
+    Label newLabel()
+    {
+        labels_.push_back(k_unbound);
+        return static_cast<Label>(labels_.size() - 1);
+    }
+
+    void bind(Label label) { labels_[label] = size(); }
+
+    [[nodiscard]] uint32_t offset(Label label) const { return labels_[label]; }
+
+    // 回填所有跳转，所有标签都已绑定后调用
+    void finalize()
+    {
+        for (const auto &[pos, label] : fixups_) {
+            patch32(pos, static_cast<int32_t>(labels_[label] - (pos + 4)));
+        }
+        fixups_.clear();
+    }
+
+    void movRR(Reg dst, Reg src) { emitRR(true, 0x89, src, dst); }
+
+    void movRR32(Reg dst, Reg src) { emitRR(false, 0x89, src, dst); }
+
+    void movRI(Reg dst, uint64_t imm)
+    {
+        if (imm <= UINT32_MAX) {
+            rex(false, 0, dst);
+            emit8(0xb8 + (dst & 7));
+            emit32(static_cast<uint32_t>(imm));
+            return;
+        }
+        rex(true, 0, dst);
+        emit8(0xb8 + (dst & 7));
+        emit64(imm);
+    }
+
+    // mov dst, [base + disp]
+    void load(Reg dst, Reg base, int32_t disp)
+    {
+        rex(true, dst, base);
+        emit8(0x8b);
+        emitMem(dst, base, disp);
+    }
+
+    // mov [base + disp], src
+    void store(Reg base, int32_t disp, Reg src)
+    {
+        rex(true, src, base);
+        emit8(0x89);
+        emitMem(src, base, disp);
+    }
+
+    void addRI(Reg dst, int32_t imm) { emitRI(true, 0, dst, imm); }
+
+    void subRI(Reg dst, int32_t imm) { emitRI(true, 5, dst, imm); }
+
+    void cmpRI(Reg dst, int32_t imm) { emitRI(true, 7, dst, imm); }
+
+    void cmpRI32(Reg dst, int32_t imm) { emitRI(false, 7, dst, imm); }
+
+    // cmp qword [base + disp], imm8
+    void cmpMI8(Reg base, int32_t disp, int8_t imm)
+    {
+        rex(true, 0, base);
+        emit8(0x83);
+        emitMem(7, base, disp);
+        emit8(static_cast<uint8_t>(imm));
+    }
+
+    void addRR(Reg dst, Reg src) { emitRR(true, 0x01, src, dst); }
+
+    void subRR(Reg dst, Reg src) { emitRR(true, 0x29, src, dst); }
+
+    void orRR(Reg dst, Reg src) { emitRR(true, 0x09, src, dst); }
+
+    void addRR32(Reg dst, Reg src) { emitRR(false, 0x01, src, dst); }
+
+    void subRR32(Reg dst, Reg src) { emitRR(false, 0x29, src, dst); }
+
+    void cmpRR(Reg a, Reg b) { emitRR(true, 0x39, b, a); }
+
+    void cmpRR32(Reg a, Reg b) { emitRR(false, 0x39, b, a); }
+
+    void testRR(Reg a, Reg b) { emitRR(true, 0x85, b, a); }
+
+    void testRR32(Reg a, Reg b) { emitRR(false, 0x85, b, a); }
+
+    void xorRR32(Reg dst, Reg src) { emitRR(false, 0x31, src, dst); }
+
+    void imulRR32(Reg dst, Reg src)
+    {
+        rex(false, dst, src);
+        emit8(0x0f);
+        emit8(0xaf);
+        emit8(modrm(dst, src));
+    }
+
+    void shrRI(Reg dst, uint8_t imm)
+    {
+        rex(true, 0, dst);
+        emit8(0xc1);
+        emit8(modrm(5, dst));
+        emit8(imm);
+    }
+
+    // setcc 的目标只能是 al/cl/dl/bl
+    void setcc(Cond cond, Reg dst)
+    {
+        emit8(0x0f);
+        emit8(0x90 + cond);
+        emit8(modrm(0, dst));
+    }
+
+    // movzx dst32, src8（src 只能是 al/cl/dl/bl）
+    void movzxRR8(Reg dst, Reg src)
+    {
+        rex(false, dst, src);
+        emit8(0x0f);
+        emit8(0xb6);
+        emit8(modrm(dst, src));
+    }
+
+    void push(Reg reg)
+    {
+        rex(false, 0, reg);
+        emit8(0x50 + (reg & 7));
+    }
+
+    void pop(Reg reg)
+    {
+        rex(false, 0, reg);
+        emit8(0x58 + (reg & 7));
+    }
+
+    void ret() { emit8(0xc3); }
+
+    void callR(Reg reg)
+    {
+        rex(false, 0, reg);
+        emit8(0xff);
+        emit8(modrm(2, reg));
+    }
+
+    void jmpR(Reg reg)
+    {
+        rex(false, 0, reg);
+        emit8(0xff);
+        emit8(modrm(4, reg));
+    }
+
+    void jmp(Label label)
+    {
+        emit8(0xe9);
+        emitRel32(label);
+    }
+
+    void jcc(Cond cond, Label label)
+    {
+        emit8(0x0f);
+        emit8(0x80 + cond);
+        emitRel32(label);
+    }
+
+private:
+    static constexpr uint32_t k_unbound = UINT32_MAX;
+
+    List<uint8_t> code_;
+    List<uint32_t> labels_;
+    List<Pair<uint32_t, Label>> fixups_;
+
+    void emit8(uint8_t byte) { code_.push_back(byte); }
+
+    void emit32(uint32_t value)
+    {
+        for (int i = 0; i < 4; i++) {
+            emit8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void emit64(uint64_t value)
+    {
+        emit32(static_cast<uint32_t>(value));
+        emit32(static_cast<uint32_t>(value >> 32));
+    }
+
+    void patch32(uint32_t pos, int32_t value) { std::memcpy(&code_[pos], &value, sizeof(value)); }
+
+    static uint8_t modrm(uint8_t reg, uint8_t rm)
+    {
+        return static_cast<uint8_t>(0xc0 | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    // REX 前缀：W 位选择 64 位操作数，R/B 位扩展 ModRM 的 reg/rm 字段，全为 0 时省略
+    void rex(bool wide, uint8_t reg, uint8_t rm)
+    {
+        const uint8_t prefix = 0x40 | (wide << 3) | (((reg >> 3) & 1) << 2) | ((rm >> 3) & 1);
+        if (prefix != 0x40) {
+            emit8(prefix);
+        }
+    }
+
+    void emitRR(bool wide, uint8_t opcode, uint8_t reg, uint8_t rm)
+    {
+        rex(wide, reg, rm);
+        emit8(opcode);
+        emit8(modrm(reg, rm));
+    }
+
+    // 81 /ext imm32，能用 imm8 表示时用 83 /ext imm8
+    void emitRI(bool wide, uint8_t ext, Reg dst, int32_t imm)
+    {
+        rex(wide, 0, dst);
+        if (imm >= INT8_MIN && imm <= INT8_MAX) {
+            emit8(0x83);
+            emit8(modrm(ext, dst));
+            emit8(static_cast<uint8_t>(imm));
+        } else {
+            emit8(0x81);
+            emit8(modrm(ext, dst));
+            emit32(static_cast<uint32_t>(imm));
+        }
+    }
+
+    // [base + disp8/disp32]，rsp/r12 作为基址时需要 SIB 字节
+    void emitMem(uint8_t reg, Reg base, int32_t disp)
+    {
+        const bool small = disp >= INT8_MIN && disp <= INT8_MAX;
+        emit8(static_cast<uint8_t>((small ? 0x40 : 0x80) | ((reg & 7) << 3) | (base & 7)));
+        if ((base & 7) == RSP) {
+            emit8(0x24);
+        }
+        if (small) {
+            emit8(static_cast<uint8_t>(disp));
+        } else {
+            emit32(static_cast<uint32_t>(disp));
+        }
+    }
+
+    void emitRel32(Label label)
+    {
+        if (labels_[label] != k_unbound) {
+            emit32(static_cast<uint32_t>(labels_[label] - (size() + 4)));
+            return;
+        }
+        fixups_.emplace_back(size(), label);
+        emit32(0);
+    }
+};
+
+} // namespace X64
+
+} // namespace aria
+
+#endif //ARIA_X64ASSEMBLER_H
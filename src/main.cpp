@@ -1,12 +1,67 @@
 #include "ariaApi.h"
+#include "runtime/opProfiler.h"
+
+#include <fstream>
+
 #if ENABLE_READLINE
 #include "readline/history.h"
 #include "readline/readline.h"
 #endif
 
-static void repl()
+struct Options
+{
+    aria::CodeBackend backend = aria::CodeBackend::STACK;
+    bool profileOps = false;
+    // 为空时把统计报告打印到 stderr
+    std::string profilePath;
+    bool profileStacks = false;
+    // 为空时把折叠栈打印到 stderr
+    std::string stacksPath;
+};
+
+static void startSampling(aria::AriaVM &vm, const Options &options)
 {
+    if (options.profileStacks && !vm.start_sampling()) {
+        std::cerr << "Stack sampling is not supported on this platform\n";
+    }
+}
+
+static void writeSamples(aria::AriaVM &vm, const Options &options)
+{
+    if (!options.profileStacks) {
+        return;
+    }
+    const std::string folded = vm.stop_sampling();
+    if (options.stacksPath.empty()) {
+        std::cerr << folded;
+        return;
+    }
+    std::ofstream file{options.stacksPath};
+    if (!(file << folded)) {
+        std::cerr << aria::format("Cannot write stack samples to '{}'\n", options.stacksPath);
+    }
+}
+
+static void reportProfile(aria::OpProfiler &profiler, const Options &options)
+{
+    if (!options.profileOps) {
+        return;
+    }
+    profiler.finish();
+    if (options.profilePath.empty()) {
+        profiler.report(std::cerr);
+    } else if (!profiler.write_json(options.profilePath)) {
+        std::cerr << aria::format("Cannot write profile to '{}'\n", options.profilePath);
+    }
+}
+
+static void repl(const Options &options)
+{
+    aria::OpProfiler profiler;
     aria::AriaVM vm;
+    vm.set_backend(options.backend);
+    vm.set_op_profiler(options.profileOps ? &profiler : nullptr);
+    startSampling(vm, options);
     for (;;) {
 #if ENABLE_READLINE
         char *line_c_str = readline("> ");
@@ -29,9 +84,11 @@ static void repl()
 #endif
         vm.interpret(line);
     }
+    reportProfile(profiler, options);
+    writeSamples(vm, options);
 }
 
-static void runFile(const char *path)
+static void runFile(const char *path, const Options &options)
 {
     std::string source;
     try {
@@ -41,8 +98,14 @@ static void runFile(const char *path)
         exit(EXIT_FAILURE);
     }
 
+    aria::OpProfiler profiler;
     aria::AriaVM vm;
+    vm.set_backend(options.backend);
+    vm.set_op_profiler(options.profileOps ? &profiler : nullptr);
+    startSampling(vm, options);
     aria::InterpretResult result = vm.interpret(path, source);
+    reportProfile(profiler, options);
+    writeSamples(vm, options);
     if (result != aria::InterpretResult::SUCCESS) {
         exit(EXIT_FAILURE);
     }
@@ -50,12 +113,40 @@ static void runFile(const char *path)
 
 int main(int argc, const char *argv[])
 {
+    // --register-vm: 用可选的寄存器后端编译函数
+    // --profile-ops[=file.json]: 统计操作码执行次数、耗时和相邻指令组合，退出时打印报告或写入 JSON
+    // --profile-stacks[=file]: 每毫秒对 Aria 调用栈采样，退出时输出 flamegraph.pl 可读的折叠栈
+    const auto usage = aria::format(
+        "Usage: {} [--register-vm] [--profile-ops[=file.json]] [--profile-stacks[=file]] [path]\n",
+        aria::k_aria_program_name);
+    Options options;
+    while (argc > 1 && std::string_view{argv[1]}.starts_with("--")) {
+        const std::string_view option{argv[1]};
+        if (option == "--register-vm") {
+            options.backend = aria::CodeBackend::REGISTER;
+        } else if (option == "--profile-ops") {
+            options.profileOps = true;
+        } else if (option.starts_with("--profile-ops=")) {
+            options.profileOps = true;
+            options.profilePath = option.substr(std::string_view{"--profile-ops="}.size());
+        } else if (option == "--profile-stacks") {
+            options.profileStacks = true;
+        } else if (option.starts_with("--profile-stacks=")) {
+            options.profileStacks = true;
+            options.stacksPath = option.substr(std::string_view{"--profile-stacks="}.size());
+        } else {
+            std::cerr << usage;
+            exit(EXIT_FAILURE);
+        }
+        argc--;
+        argv++;
+    }
     if (argc == 1) {
-        repl();
+        repl(options);
     } else if (argc == 2) {
-        runFile(argv[1]);
+        runFile(argv[1], options);
     } else {
-        std::cerr << aria::format("Usage: {} [path]\n", aria::k_aria_program_name);
+        std::cerr << usage;
         exit(EXIT_FAILURE);
     }
     return 0;
@@ -1,5 +1,6 @@
 #include "memory/gc.h"
 
+#include "chunk/chunk.h"
 #include "compile/functionContext.h"
 #include "memory/stringPool.h"
 #include "object/objFunction.h"
@@ -9,6 +10,7 @@
 #include "object/objString.h"
 #include "object/objUpvalue.h"
 #include "object/object.h"
+#include "object/shape.h"
 #include "runtime/vm.h"
 #include "value/valueArray.h"
 #include "value/valueHashTable.h"
@@ -24,6 +26,7 @@ GC::GC()
     , object_list_{nullptr}
     , interned_string_list_{nullptr}
     , temp_root_stack_{new ValueStack{}}
+    , root_shape_{new Shape{}}
     , string_op_buffer_{new char[k_gc_buffer_size]}
     , in_gc_{false}
     , running_vm_{nullptr}
@@ -53,6 +56,7 @@ GC::~GC()
     delete iterator_methods_;
     delete intern_pool_;
     free_all_objects();
+    delete root_shape_;
 #ifdef DEBUG_LOG_GC
     println("=== shut down GC ===");
 #endif
@@ -87,6 +91,20 @@ void GC::trace_references()
     }
 }
 
+void GC::clear_dead_call_caches()
+{
+    for (Obj *object = object_list_; object != nullptr; object = object->next_) {
+        if (!object->is_marked_ || object->type_ != ObjType::FUNCTION) {
+            continue;
+        }
+        for (auto &cache : static_cast<ObjFunction *>(object)->chunk_->call_caches_) {
+            if (NanBox::isObj(cache.callee) && !NanBox::toObj(cache.callee)->is_marked_) {
+                cache = CallCache{};
+            }
+        }
+    }
+}
+
 void GC::sweep()
 {
     Obj *previous = nullptr;
@@ -126,6 +144,8 @@ void GC::collect_garbage()
 
     trace_references();
 
+    clear_dead_call_caches();
+
     sweep();
 
     next_gc_ = bytes_allocated_ * k_gc_heap_grow_factor;
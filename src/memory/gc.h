@@ -19,6 +19,7 @@ class ValueHashTable;
 class ValueStack;
 class ObjString;
 class FunctionContext;
+class Shape;
 
 template<typename T>
 concept DerivedFromObj = std::is_base_of_v<Obj, T>;
@@ -39,6 +40,10 @@ public:
 
     void trace_references();
 
+    // 标记结束、清扫之前调用：被调用者没有被标记的调用点缓存随之清空，
+    // 调用点缓存不会让被调用者存活，也不会在其内存被复用后误命中
+    void clear_dead_call_caches();
+
     void sweep();
 
     void collect_garbage();
@@ -121,7 +126,13 @@ public:
 
     ObjString *find_interned_string(const char *chars, size_t length, uint32_t hash);
 
-    void push_temp_root(Value v) const { temp_root_stack_->push(v); }
+    void push_temp_root(Value v) const
+    {
+        if (!temp_root_stack_->reserve(1)) {
+            fatal_error(ErrorCode::RESOURCE_MEMORY_EXHAUSTED, "Too many temporary GC roots");
+        }
+        temp_root_stack_->push(v);
+    }
 
     void pop_temp_root(int n = 1) const { temp_root_stack_->pop_n(n); }
 
@@ -147,6 +158,7 @@ public:
     ValueHashTable *map_methods_;
     ValueHashTable *string_methods_;
     ValueHashTable *iterator_methods_;
+    Shape *root_shape_;
 
     char *string_op_buffer_;
 
@@ -10,8 +10,15 @@ enum class FunctionType { FUNCTION, METHOD, INIT_METHOD, SCRIPT };
 
 enum class BoundMethodType { FUNCTION, NATIVE_FN };
 
+// 函数体的代码生成后端：默认生成栈式字节码，REGISTER 为可选的寄存器后端
+enum class CodeBackend { STACK, REGISTER };
+
 using NativeFn_t = Value (*)(AriaEnv *env, int argCount, Value *args);
 
+// 可变参数原生函数的参数传递方式：LIST 把多余的参数打包成 ObjList 放在 args[arity]；
+// STACK 让 args 直接指向值栈上的全部 argCount 个参数，调用时不分配任何对象
+enum class VarargsConvention : uint8_t { LIST, STACK };
+
 } // namespace aria
 
 #endif //ARIA_FUNDEF_H
@@ -26,7 +26,7 @@ String ListIterator::typeString()
 
 bool ListIterator::hasNext()
 {
-    return obj_->list_->size() > next_index_;
+    return obj_->list_.size() > next_index_;
 }
 
 Value ListIterator::next()
@@ -34,7 +34,7 @@ Value ListIterator::next()
     if (!hasNext()) {
         return NanBox::NilValue;
     }
-    return (*obj_->list_)[next_index_++];
+    return obj_->list_[next_index_++];
 }
 
 MapIterator::MapIterator(ObjMap *map)
@@ -100,4 +100,44 @@ Value StringIterator::next()
     return NanBox::fromObj(new_ObjString(obj_->c_str()[next_index_++], obj_->gc_));
 }
 
+RangeIterator::RangeIterator(int64_t start, int64_t stop, int64_t step)
+    : start_{start}
+    , stop_{stop}
+    , step_{step}
+    , next_{start}
+{}
+RangeIterator::~RangeIterator() = default;
+
+void RangeIterator::blacken() {}
+
+String RangeIterator::typeString()
+{
+    return format("range({}, {}, {})", start_, stop_, step_);
+}
+
+bool RangeIterator::hasNext()
+{
+    return step_ > 0 ? next_ < stop_ : next_ > stop_;
+}
+
+Value RangeIterator::next()
+{
+    if (!hasNext()) {
+        return NanBox::NilValue;
+    }
+    Value value = NanBox::fromInteger(next_);
+    next_ += step_;
+    return value;
+}
+
+bool RangeIterator::at(int64_t index, Value &value) const
+{
+    const int64_t current = start_ + index * step_;
+    if (step_ > 0 ? current >= stop_ : current <= stop_) {
+        return false;
+    }
+    value = NanBox::fromInteger(current);
+    return true;
+}
+
 } // namespace aria
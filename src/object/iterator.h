@@ -20,6 +20,9 @@ public:
     virtual size_t getSize() { return sizeof(Iterator); }
     virtual bool hasNext() { return false; }
     virtual Value next() = 0;
+    // 可按下标取值的迭代器由 FOR_ITER 用游标遍历，不改变自身状态；下标越界时返回 false
+    virtual bool indexed() const { return false; }
+    virtual bool at(int64_t index, Value &value) const { return false; }
 };
 
 class ListIterator : public Iterator
@@ -76,6 +79,28 @@ public:
     int next_index_;
 };
 
+// range(start, stop, step)：按需计算每个值，不生成列表
+class RangeIterator : public Iterator
+{
+public:
+    RangeIterator() = delete;
+    RangeIterator(int64_t start, int64_t stop, int64_t step);
+    ~RangeIterator() override;
+
+    void blacken() override;
+    String typeString() override;
+    size_t getSize() override { return sizeof(RangeIterator); }
+    bool hasNext() override;
+    Value next() override;
+    bool indexed() const override { return true; }
+    bool at(int64_t index, Value &value) const override;
+
+    int64_t start_;
+    int64_t stop_;
+    int64_t step_;
+    int64_t next_;
+};
+
 } // namespace aria
 
 #endif //ARIA_ITERATOR_H
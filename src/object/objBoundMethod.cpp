@@ -1,6 +1,7 @@
 #include "object/objBoundMethod.h"
 
 #include "memory/gc.h"
+#include "objClosure.h"
 #include "objFunction.h"
 #include "objNativeFn.h"
 #include "util/hash.h"
@@ -12,6 +13,16 @@ ObjBoundMethod::ObjBoundMethod(Value receiver, ObjFunction *method, GC *gc)
     , receiver_{receiver}
     , method_type_{BoundMethodType::FUNCTION}
     , method_{method}
+    , closure_{nullptr}
+    , native_method_{nullptr}
+{}
+
+ObjBoundMethod::ObjBoundMethod(Value receiver, ObjClosure *method, GC *gc)
+    : Obj{ObjType::BOUND_METHOD, hash_obj(this, ObjType::BOUND_METHOD), gc}
+    , receiver_{receiver}
+    , method_type_{BoundMethodType::FUNCTION}
+    , method_{method->function_}
+    , closure_{method}
     , native_method_{nullptr}
 {}
 
@@ -20,6 +31,7 @@ ObjBoundMethod::ObjBoundMethod(Value receiver, ObjNativeFn *method, GC *gc)
     , receiver_{receiver}
     , method_type_{BoundMethodType::NATIVE_FN}
     , method_{nullptr}
+    , closure_{nullptr}
     , native_method_{method}
 {}
 
@@ -45,6 +57,9 @@ void ObjBoundMethod::blacken()
     if (method_ != nullptr) {
         method_->mark();
     }
+    if (closure_ != nullptr) {
+        closure_->mark();
+    }
     if (native_method_ != nullptr) {
         native_method_->mark();
     }
@@ -64,4 +79,22 @@ ObjBoundMethod *new_ObjBoundMethod(Value receiver, ObjNativeFn *method, GC *gc)
     return obj;
 }
 
+ObjBoundMethod *new_ObjBoundMethod(Value receiver, ObjClosure *method, GC *gc)
+{
+    auto obj = gc->allocate_object<ObjBoundMethod>(receiver, method, gc);
+    log_obj_allocation(obj);
+    return obj;
+}
+
+ObjBoundMethod *new_ObjBoundMethod(Value receiver, Value method, GC *gc)
+{
+    if (is_obj_native_fn(method)) {
+        return new_ObjBoundMethod(receiver, as_obj_native_fn(method), gc);
+    }
+    if (is_obj_closure(method)) {
+        return new_ObjBoundMethod(receiver, as_obj_closure(method), gc);
+    }
+    return new_ObjBoundMethod(receiver, as_obj_function(method), gc);
+}
+
 } // namespace aria
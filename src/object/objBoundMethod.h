@@ -8,6 +8,7 @@ namespace aria {
 
 class ObjNativeFn;
 class ObjFunction;
+class ObjClosure;
 
 class ObjBoundMethod : public Obj
 {
@@ -16,6 +17,8 @@ public:
 
     ObjBoundMethod(Value receiver, ObjFunction *method, GC *gc);
 
+    ObjBoundMethod(Value receiver, ObjClosure *method, GC *gc);
+
     ObjBoundMethod(Value receiver, ObjNativeFn *method, GC *gc);
 
     ~ObjBoundMethod() override;
@@ -29,6 +32,8 @@ public:
     Value receiver_;
     BoundMethodType method_type_;
     ObjFunction *method_;
+    // 方法捕获了变量时是它的闭包，调用时提供 upvalue
+    ObjClosure *closure_;
     ObjNativeFn *native_method_;
 };
 
@@ -46,6 +51,9 @@ ObjBoundMethod *new_ObjBoundMethod(Value receiver, ObjFunction *method, GC *gc);
 
 ObjBoundMethod *new_ObjBoundMethod(Value receiver, ObjNativeFn *method, GC *gc);
 
+// method 是类中的方法：ObjFunction、ObjClosure 或 ObjNativeFn
+ObjBoundMethod *new_ObjBoundMethod(Value receiver, Value method, GC *gc);
+
 } // namespace aria
 
 #endif //ARIA_OBJBOUNDMETHOD_H
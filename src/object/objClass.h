@@ -28,7 +28,8 @@ public:
     ObjString *name_;
     ValueHashTable methods_;
     ObjClass *super_klass_;
-    ObjFunction *init_method_;
+    // ObjFunction，或捕获了变量的 ObjClosure
+    Obj *init_method_;
 };
 
 inline bool is_obj_class(Value value)
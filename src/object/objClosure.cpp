@@ -0,0 +1,61 @@
+#include "object/objClosure.h"
+
+#include <algorithm>
+
+#include "memory/gc.h"
+#include "object/objClass.h"
+#include "object/objFunction.h"
+#include "object/objUpvalue.h"
+#include "runtime/vm.h"
+#include "util/hash.h"
+
+namespace aria {
+
+ObjClosure::ObjClosure(ObjFunction *function, GC *gc)
+    : Obj{ObjType::CLOSURE, hash_obj(this, ObjType::CLOSURE), gc}
+    , function_{function}
+    , enclosing_class_{nullptr}
+    , upvalues_{nullptr}
+    , upvalue_count_{function->upvalue_count_}
+{
+    // 先分配数组再由 CLOSURE 逐个填入，填入前可能触发 GC，未填的槽位为空
+    upvalues_ = gc_->allocate_array<ObjUpvalue *>(upvalue_count_);
+    std::fill_n(upvalues_, upvalue_count_, nullptr);
+}
+
+ObjClosure::~ObjClosure()
+{
+    gc_->free_array<ObjUpvalue *>(upvalues_, upvalue_count_);
+}
+
+String ObjClosure::to_string()
+{
+    return function_->to_string();
+}
+
+void ObjClosure::blacken()
+{
+    function_->mark();
+    if (enclosing_class_ != nullptr) {
+        enclosing_class_->mark();
+    }
+    for (int i = 0; i < upvalue_count_; i++) {
+        if (upvalues_[i] != nullptr) {
+            upvalues_[i]->mark();
+        }
+    }
+}
+
+Value ObjClosure::op_call(AriaEnv *env, int argCount)
+{
+    return env->call_closure(this, argCount);
+}
+
+ObjClosure *new_ObjClosure(ObjFunction *function, GC *gc)
+{
+    auto obj = gc->allocate_object<ObjClosure>(function, gc);
+    log_obj_allocation(obj);
+    return obj;
+}
+
+} // namespace aria
@@ -0,0 +1,51 @@
+#ifndef ARIA_OBJCLOSURE_H
+#define ARIA_OBJCLOSURE_H
+
+#include "object/objFunction.h"
+
+namespace aria {
+class ObjClass;
+class ObjUpvalue;
+
+// CLOSURE 创建的运行时闭包：持有捕获的 upvalue，函数原型 ObjFunction 本身保持不变。
+// 不捕获变量、也不使用 super 的函数直接以 ObjFunction 作为函数值，不需要闭包
+class ObjClosure : public Obj
+{
+public:
+    ObjClosure() = delete;
+
+    ObjClosure(ObjFunction *function, GC *gc);
+
+    ~ObjClosure() override;
+
+    String to_string() override;
+
+    size_t obj_size() override { return sizeof(ObjClosure); }
+
+    void blacken() override;
+
+    Value op_call(AriaEnv *env, int argCount) override;
+
+    ObjFunction *function_;
+    // 方法所在的类，由 MAKE_METHOD/MAKE_INIT_METHOD 设置，LOAD_SUPER_METHOD 从它的父类查找方法。
+    // 每次执行类声明都会创建新的闭包，同一原型在不同的类中互不影响
+    ObjClass *enclosing_class_;
+    ObjUpvalue **upvalues_;
+    int upvalue_count_;
+};
+
+inline bool is_obj_closure(Value value)
+{
+    return is_obj_type(value, ObjType::CLOSURE);
+}
+
+inline ObjClosure *as_obj_closure(Value value)
+{
+    return as_Obj<ObjClosure>(value);
+}
+
+ObjClosure *new_ObjClosure(ObjFunction *function, GC *gc);
+
+} // namespace aria
+
+#endif //ARIA_OBJCLOSURE_H
@@ -1,12 +1,12 @@
 #include "object/objFunction.h"
 
 #include "chunk/chunk.h"
-#include "objUpvalue.h"
+#include "jit/jit.h"
 #include "object/objList.h"
 #include "object/objString.h"
 #include "runtime/vm.h"
 #include "util/hash.h"
-#include "value/valueHashTable.h"
+#include "value/globalTable.h"
 #include "value/valueStack.h"
 
 namespace aria {
@@ -16,54 +16,61 @@ ObjFunction::ObjFunction(
     ObjString *location,
     ObjString *name,
     int arity,
-    ValueHashTable *globals,
+    GlobalTable *globals,
     bool acceptsVarargs,
     GC *gc)
     : Obj{ObjType::FUNCTION, hash_obj(this, ObjType::FUNCTION), gc}
     , location_{location}
-    , enclosing_class_{nullptr}
     , name_{name}
     , chunk_{new Chunk{globals, gc}}
     , arity_{arity}
     , type_{type}
-    , upvalues_{nullptr}
     , upvalue_count_{0}
+    , captures_locals_{false}
     , accepts_varargs_{acceptsVarargs}
+    , lazy_varargs_{false}
+    , frame_size_{0}
+    , hotness_{0}
+    , jit_code_{nullptr}
 {}
 
 ObjFunction::ObjFunction(FunctionType type, ObjString *location, ObjString *name, GC *gc)
     : Obj{ObjType::FUNCTION, hash_obj(this, ObjType::FUNCTION), gc}
     , location_{location}
-    , enclosing_class_{nullptr}
     , name_{name}
     , chunk_{new Chunk{gc}}
     , arity_{0}
     , type_{type}
-    , upvalues_{nullptr}
     , upvalue_count_{0}
+    , captures_locals_{false}
     , accepts_varargs_{false}
+    , lazy_varargs_{false}
+    , frame_size_{0}
+    , hotness_{0}
+    , jit_code_{nullptr}
 {}
 
 ObjFunction::ObjFunction(
-    FunctionType type, ObjString *location, ObjString *name, ValueHashTable *globals, GC *gc)
+    FunctionType type, ObjString *location, ObjString *name, GlobalTable *globals, GC *gc)
     : Obj{ObjType::FUNCTION, hash_obj(this, ObjType::FUNCTION), gc}
     , location_{location}
-    , enclosing_class_{nullptr}
     , name_{name}
     , chunk_{new Chunk{globals, gc}}
     , arity_{0}
     , type_{type}
-    , upvalues_{nullptr}
     , upvalue_count_{0}
+    , captures_locals_{false}
     , accepts_varargs_{false}
+    , lazy_varargs_{false}
+    , frame_size_{0}
+    , hotness_{0}
+    , jit_code_{nullptr}
 {}
 
 ObjFunction::~ObjFunction()
 {
     delete chunk_;
-    if (upvalues_ != nullptr) {
-        gc_->free_array<ObjUpvalue *>(upvalues_, upvalue_count_);
-    }
+    Jit::release(jit_code_);
 }
 
 String ObjFunction::to_string()
@@ -78,44 +85,20 @@ String ObjFunction::to_string()
 void ObjFunction::blacken()
 {
     location_->mark();
-    if (enclosing_class_ != nullptr) {
-        enclosing_class_->mark();
-    }
     name_->mark();
     chunk_->consts_.mark();
     chunk_->globals_->mark();
-    if (upvalues_ != nullptr) {
-        for (int i = 0; i < upvalue_count_; i++) {
-            if (upvalues_[i] == nullptr) {
-                continue;
-            }
-            upvalues_[i]->mark();
+    for (const auto &cache : chunk_->method_caches_) {
+        if (cache.klass != nullptr) {
+            cache.klass->mark();
+            mark_value(cache.method);
         }
     }
 }
 
 Value ObjFunction::op_call(AriaEnv *env, int argCount)
 {
-    if (accepts_varargs_ && argCount >= arity_) {
-        env->pack_varargs(argCount, arity_);
-    } else if (argCount == arity_) {
-        // pass
-    } else {
-        String msg = format("Expected {} arguments but got {}.", arity_, argCount);
-        return env->new_exception(ErrorCode::RUNTIME_MISMATCH_ARG_COUNT, msg.c_str());
-    }
-    return env->create_call_frame(this);
-}
-
-void ObjFunction::initUpvalues()
-{
-    if (upvalue_count_ == 0) {
-        return;
-    }
-    upvalues_ = gc_->allocate_array<ObjUpvalue *>(upvalue_count_);
-    for (int i = 0; i < upvalue_count_; i++) {
-        upvalues_[i] = nullptr;
-    }
+    return env->call_function(this, argCount);
 }
 
 ObjFunction *new_ObjFunction(FunctionType type, ObjString *location, ObjString *name, GC *gc)
@@ -126,7 +109,7 @@ ObjFunction *new_ObjFunction(FunctionType type, ObjString *location, ObjString *
 }
 
 ObjFunction *new_ObjFunction(
-    FunctionType type, ObjString *location, ObjString *name, ValueHashTable *globals, GC *gc)
+    FunctionType type, ObjString *location, ObjString *name, GlobalTable *globals, GC *gc)
 {
     auto obj = gc->allocate_object<ObjFunction>(type, location, name, globals, gc);
     log_obj_allocation(obj);
@@ -138,7 +121,7 @@ ObjFunction *new_ObjFunction(
     ObjString *location,
     ObjString *name,
     int arity,
-    ValueHashTable *globals,
+    GlobalTable *globals,
     bool acceptsVarargs,
     GC *gc)
 {
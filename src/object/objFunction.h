@@ -7,9 +7,9 @@
 namespace aria {
 class ObjClass;
 
-class ValueHashTable;
-class ObjUpvalue;
+class GlobalTable;
 class Chunk;
+struct JitCode;
 
 class ObjFunction : public Obj
 {
@@ -19,7 +19,7 @@ public:
         ObjString *location,
         ObjString *name,
         int arity,
-        ValueHashTable *globals,
+        GlobalTable *globals,
         bool acceptsVarargs,
         GC *gc);
 
@@ -29,7 +29,7 @@ public:
         FunctionType type,
         ObjString *location,
         ObjString *name,
-        ValueHashTable *globals,
+        GlobalTable *globals,
         GC *gc);
 
     ~ObjFunction() override;
@@ -42,17 +42,23 @@ public:
 
     Value op_call(AriaEnv *env, int argCount) override;
 
-    void initUpvalues();
-
     ObjString *location_;
-    ObjClass *enclosing_class_;
     ObjString *name_;
     Chunk *chunk_;
     int arity_;
     FunctionType type_;
-    ObjUpvalue **upvalues_;
+    // 捕获的变量个数，大于 0 时 CLOSURE 为每次求值创建一个 ObjClosure 保存这些 upvalue
     int upvalue_count_;
+    // 有局部变量被内层函数捕获，返回时才需要关闭栈帧中的 open upvalue
+    bool captures_locals_;
     bool accepts_varargs_;
+    // 剩余参数只被下标访问或遍历：调用时多余的参数留在 AriaVM::rest_args_ 中，用作值时才生成列表
+    bool lazy_varargs_;
+    // 寄存器后端生成的函数在栈帧中占用的寄存器个数（含 0 号被调用者），栈式字节码为 0
+    int frame_size_;
+    // 调用次数与循环回边次数之和，达到 Jit::k_hot_threshold 时尝试编译为机器码
+    uint32_t hotness_;
+    JitCode *jit_code_;
 };
 
 inline bool is_obj_function(Value value)
@@ -70,7 +76,7 @@ ObjFunction *new_ObjFunction(FunctionType type, ObjString *location, ObjString *
 
 // function object for repl mode
 ObjFunction *new_ObjFunction(
-    FunctionType type, ObjString *location, ObjString *name, ValueHashTable *globals, GC *gc);
+    FunctionType type, ObjString *location, ObjString *name, GlobalTable *globals, GC *gc);
 
 // function object for normal function
 ObjFunction *new_ObjFunction(
@@ -78,7 +84,7 @@ ObjFunction *new_ObjFunction(
     ObjString *location,
     ObjString *name,
     int arity,
-    ValueHashTable *globals,
+    GlobalTable *globals,
     bool acceptsVarargs,
     GC *gc);
 
@@ -6,19 +6,29 @@
 #include "object/objFunction.h"
 #include "object/objNativeFn.h"
 #include "object/objString.h"
+#include "object/shape.h"
 #include "util/hash.h"
 #include "util/util.h"
 
+#include <algorithm>
+
 namespace aria {
 
 ObjInstance::ObjInstance(ObjClass *klass, GC *gc)
     : Obj{ObjType::INSTANCE, hash_obj(this, ObjType::INSTANCE), gc}
     , klass_{klass}
-    , fields_{gc}
-    , cached_methods_{gc}
+    , shape_{gc->root_shape_}
+    , slots_{inline_slots_}
+    , slot_capacity_{k_inline_slots}
+    , inline_slots_{}
 {}
 
-ObjInstance::~ObjInstance() = default;
+ObjInstance::~ObjInstance()
+{
+    if (slots_ != inline_slots_) {
+        gc_->free_array<Value>(slots_, slot_capacity_);
+    }
+}
 
 String ObjInstance::to_string()
 {
@@ -33,28 +43,20 @@ String ObjInstance::representation()
 void ObjInstance::blacken()
 {
     klass_->mark();
-    fields_.mark();
-    cached_methods_.mark();
+    for (uint32_t i = 0; i < shape_->field_count(); i++) {
+        mark_value(slots_[i]);
+    }
 }
 
 Value ObjInstance::get_by_field(ObjString *name, Value &value)
 {
-    if (fields_.get(NanBox::fromObj(name), value)) {
-        return NanBox::TrueValue;
-    }
-    if (cached_methods_.get(NanBox::fromObj(name), value)) {
+    if (int32_t slot = shape_->lookup(name); slot >= 0) {
+        value = slots_[slot];
         return NanBox::TrueValue;
     }
     if (klass_->methods_.get(NanBox::fromObj(name), value)) {
-        ObjBoundMethod *boundMethod = nullptr;
-        if (is_obj_native_fn(value)) {
-            boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), as_obj_native_fn(value), gc_);
-        } else {
-            boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), as_obj_function(value), gc_);
-        }
+        ObjBoundMethod *boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), value, gc_);
         value = NanBox::fromObj(boundMethod);
-        GcTempRootGuard guard{gc_, value};
-        cached_methods_.insert(NanBox::fromObj(name), value);
         return NanBox::TrueValue;
     }
     return NanBox::FalseValue;
@@ -62,15 +64,65 @@ Value ObjInstance::get_by_field(ObjString *name, Value &value)
 
 Value ObjInstance::set_by_field(ObjString *name, Value value)
 {
-    fields_.insert(NanBox::fromObj(name), value);
+    if (int32_t slot = shape_->lookup(name); slot >= 0) {
+        slots_[slot] = value;
+        return NanBox::TrueValue;
+    }
+    add_field(shape_->add_field(name), value);
     return NanBox::TrueValue;
 }
 
+void ObjInstance::add_field(Shape *new_shape, Value value)
+{
+    uint32_t slot = shape_->field_count();
+    if (slot >= slot_capacity_) {
+        GcTempRootGuard guard{gc_, value};
+        reserve_slots(slot + 1);
+    }
+    slots_[slot] = value;
+    shape_ = new_shape;
+}
+
+void ObjInstance::reserve_slots(uint32_t count)
+{
+    if (count <= slot_capacity_) {
+        return;
+    }
+    uint32_t capacity = slot_capacity_;
+    while (capacity < count) {
+        capacity = static_cast<uint32_t>(GC::grow_capacity(capacity));
+    }
+    // 分配可能触发 GC，期间 slots_ 和 shape_ 保持一致
+    Value *slots = gc_->allocate_array<Value>(capacity);
+    std::copy_n(slots_, shape_->field_count(), slots);
+    if (slots_ != inline_slots_) {
+        gc_->free_array<Value>(slots_, slot_capacity_);
+    }
+    slots_ = slots;
+    slot_capacity_ = capacity;
+}
+
+bool ObjInstance::fields_equal(const ObjInstance *other) const
+{
+    if (shape_->field_count() != other->shape_->field_count()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < shape_->field_count(); i++) {
+        int32_t slot = other->shape_->lookup(shape_->field_name(i));
+        if (slot < 0 || !values_equal(slots_[i], other->slots_[slot])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 Value ObjInstance::copy(GC *gc)
 {
     ObjInstance *newObj = new_ObjInstance(klass_, gc);
     GcTempRootGuard guard{gc, NanBox::fromObj(newObj)};
-    newObj->fields_.copy(&fields_);
+    newObj->reserve_slots(shape_->field_count());
+    std::copy_n(slots_, shape_->field_count(), newObj->slots_);
+    newObj->shape_ = shape_;
     return NanBox::fromObj(newObj);
 }
 
@@ -80,8 +132,7 @@ Value ObjInstance::getSuperMethod(ObjClass *methodKlass, ObjString *methodName,
     if (!methodKlass->getSuperMethod(methodName, superMethod)) [[unlikely]] {
         return NanBox::FalseValue;
     }
-    ObjBoundMethod *boundMethod
-        = new_ObjBoundMethod(NanBox::fromObj(this), as_obj_function(superMethod), gc_);
+    ObjBoundMethod *boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), superMethod, gc_);
     superMethod = NanBox::fromObj(boundMethod);
     return NanBox::TrueValue;
 }
@@ -7,6 +7,7 @@
 namespace aria {
 
 class ObjClass;
+class Shape;
 
 class ObjInstance : public Obj
 {
@@ -33,9 +34,21 @@ public:
 
     Value getSuperMethod(ObjClass *methodKlass, ObjString *methodName, Value &superMethod);
 
+    // 追加一个新字段：先保证槽位容量，再写入值并迁移到 new_shape
+    void add_field(Shape *new_shape, Value value);
+
+    [[nodiscard]] bool fields_equal(const ObjInstance *other) const;
+
+    static constexpr uint32_t k_inline_slots = 4;
+
     ObjClass *klass_;
-    ValueHashTable fields_;
-    ValueHashTable cached_methods_;
+    Shape *shape_;
+    Value *slots_; // 指向 inline_slots_，字段超过 k_inline_slots 个时指向堆上数组
+    uint32_t slot_capacity_;
+    Value inline_slots_[k_inline_slots];
+
+private:
+    void reserve_slots(uint32_t count);
 };
 
 inline bool is_obj_instance(Value value)
@@ -14,13 +14,11 @@ namespace aria {
 ObjIterator::ObjIterator(Iterator *iter, GC *gc)
     : Obj{ObjType::ITERATOR, hash_obj(this, ObjType::ITERATOR), gc}
     , iter_{iter}
-    , cached_methods_{new ValueHashTable{gc}}
 {}
 
 ObjIterator::~ObjIterator()
 {
     delete iter_;
-    delete cached_methods_;
 }
 
 String ObjIterator::to_string()
@@ -31,20 +29,14 @@ String ObjIterator::to_string()
 void ObjIterator::blacken()
 {
     iter_->blacken();
-    cached_methods_->mark();
 }
 
 Value ObjIterator::get_by_field(ObjString *name, Value &value)
 {
-    if (cached_methods_->get(NanBox::fromObj(name), value)) {
-        return NanBox::TrueValue;
-    }
     if (gc_->iterator_methods_->get(NanBox::fromObj(name), value)) {
         assert(is_obj_native_fn(value) && "iterator builtin method is nativeFn");
         auto boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), as_obj_native_fn(value), gc_);
         value = NanBox::fromObj(boundMethod);
-        GcTempRootGuard guard{gc_, value};
-        cached_methods_->insert(NanBox::fromObj(name), value);
         return NanBox::TrueValue;
     }
     return NanBox::FalseValue;
@@ -27,7 +27,6 @@ public:
     Value get_by_field(ObjString *name, Value &value) override;
 
     Iterator *iter_;
-    ValueHashTable *cached_methods_;
 
     static void init(GC *_gc, ValueHashTable *builtins);
 };
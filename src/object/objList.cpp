@@ -7,6 +7,7 @@
 #include "object/objString.h"
 #include "runtime/vm.h"
 #include "util/hash.h"
+#include "util/sink.h"
 #include "util/util.h"
 #include "value/valueArray.h"
 #include "value/valueHashTable.h"
@@ -18,26 +19,20 @@ namespace aria {
 
 ObjList::ObjList(GC *gc)
     : Obj{ObjType::LIST, hash_obj(this, ObjType::LIST), gc}
-    , list_{new ValueArray{gc}}
-    , cached_methods_{gc}
+    , list_{gc}
 {}
 
 ObjList::ObjList(Value *values, uint32_t count, GC *gc)
     : Obj{ObjType::LIST, hash_obj(this, ObjType::LIST), gc}
-    , list_{new ValueArray{values, count, gc}}
-    , cached_methods_{gc}
+    , list_{values, count, gc}
 {}
 
 ObjList::ObjList(uint32_t begin, uint32_t end, const ObjList *other, GC *gc)
     : Obj{ObjType::LIST, hash_obj(this, ObjType::LIST), gc}
-    , list_{new ValueArray{begin, end, other->list_, gc}}
-    , cached_methods_{gc}
+    , list_{begin, end, &other->list_, gc}
 {}
 
-ObjList::~ObjList()
-{
-    delete list_;
-}
+ObjList::~ObjList() = default;
 
 String ObjList::to_string()
 {
@@ -45,7 +40,7 @@ String ObjList::to_string()
         return "[...]";
     }
     PrintGuard guard(this);
-    return list_->to_string();
+    return list_.to_string();
 }
 
 String ObjList::representation()
@@ -53,23 +48,32 @@ String ObjList::representation()
     return to_string();
 }
 
+void ObjList::write_string(Sink &sink)
+{
+    if (PrintGuard::is_cycle(this)) {
+        sink.write("[...]");
+        return;
+    }
+    PrintGuard guard(this);
+    list_.write_to(sink);
+}
+
+void ObjList::write_representation(Sink &sink)
+{
+    write_string(sink);
+}
+
 void ObjList::blacken()
 {
-    list_->mark();
-    cached_methods_.mark();
+    list_.mark();
 }
 
 Value ObjList::get_by_field(ObjString *name, Value &value)
 {
-    if (cached_methods_.get(NanBox::fromObj(name), value)) {
-        return NanBox::TrueValue;
-    }
     if (gc_->list_methods_->get(NanBox::fromObj(name), value)) {
         assert(is_obj_native_fn(value) && "list builtin method is nativeFn");
         auto boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), as_obj_native_fn(value), gc_);
         value = NanBox::fromObj(boundMethod);
-        GcTempRootGuard guard{gc_, value};
-        cached_methods_.insert(NanBox::fromObj(name), value);
         return NanBox::TrueValue;
     }
     return NanBox::FalseValue;
@@ -77,33 +81,27 @@ Value ObjList::get_by_field(ObjString *name, Value &value)
 
 Value ObjList::get_by_index(Value k, Value &v)
 {
-    if (!NanBox::isNumber(k)) {
+    int32_t index;
+    if (!NanBox::toInteger(k, index)) {
         return new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "index of list must be a integer");
     }
-    int index = static_cast<int>(NanBox::toNumber(k));
-    if (index != NanBox::toNumber(k)) {
-        return new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "index of list must be a integer");
-    }
-    if (index < 0 || index >= list_->size()) {
+    if (index < 0 || index >= list_.size()) {
         return new_exception(ErrorCode::RUNTIME_OUT_OF_BOUNDS, "index out of range");
     }
-    v = (*list_)[index];
+    v = list_[index];
     return NanBox::TrueValue;
 }
 
 Value ObjList::set_by_index(Value k, Value v)
 {
-    if (!NanBox::isNumber(k)) {
-        return new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "index of list must be a integer");
-    }
-    int index = static_cast<int>(NanBox::toNumber(k));
-    if (index != NanBox::toNumber(k)) {
+    int32_t index;
+    if (!NanBox::toInteger(k, index)) {
         return new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "index of list must be a integer");
     }
-    if (index < 0 || index >= list_->size()) {
+    if (index < 0 || index >= list_.size()) {
         return new_exception(ErrorCode::RUNTIME_OUT_OF_BOUNDS, "index out of range");
     }
-    (*list_)[index] = v;
+    list_[index] = v;
     return NanBox::TrueValue;
 }
 
@@ -116,7 +114,7 @@ Value ObjList::copy(GC *gc)
 {
     ObjList *newObj = new_ObjList(gc);
     GcTempRootGuard guard{gc, NanBox::fromObj(newObj)};
-    newObj->list_->copy(list_);
+    newObj->list_.copy(&list_);
     return NanBox::fromObj(newObj);
 }
 
@@ -2,12 +2,11 @@
 #define ARIA_OBJLIST_H
 
 #include "object/object.h"
+#include "value/valueArray.h"
 #include "value/valueHashTable.h"
 
 namespace aria {
 
-class ValueArray;
-
 class ObjList : public Obj
 {
 public:
@@ -25,6 +24,10 @@ public:
 
     String representation() override;
 
+    void write_string(Sink &sink) override;
+
+    void write_representation(Sink &sink) override;
+
     size_t obj_size() override { return sizeof(ObjList); }
 
     void blacken() override;
@@ -39,8 +42,8 @@ public:
 
     Value copy(GC *gc) override;
 
-    ValueArray *list_;
-    ValueHashTable cached_methods_;
+    // 元素直接存放在列表对象中，短列表不另外分配数组
+    ValueArray list_;
 
     static void init(GC *_gc, ValueHashTable *builtins);
 };
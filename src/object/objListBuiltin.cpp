@@ -9,7 +9,7 @@ namespace aria {
 static Value builtin_append(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
-    self->list_->push(args[0]);
+    self->list_.push(args[0]);
     return NanBox::NilValue;
 }
 
@@ -18,29 +18,29 @@ static Value builtin_extend(AriaEnv *env, int argCount, Value *args)
     auto self = as_obj_list(args[-1]);
     CHECK_OBJLIST(args[0], Argument);
     GcTempRootGuard guard{env->gc_ ,args[0]};
-    self->list_->extend(as_obj_list(args[0])->list_);
+    self->list_.extend(&as_obj_list(args[0])->list_);
     return NanBox::NilValue;
 }
 
 static Value builtin_size(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
-    return NanBox::fromNumber(self->list_->size());
+    return NanBox::fromInteger(static_cast<int64_t>(self->list_.size()));
 }
 
 static Value builtin_empty(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
-    return NanBox::fromBool(self->list_->empty());
+    return NanBox::fromBool(self->list_.empty());
 }
 
 static Value builtin_pop(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
-    if (self->list_->empty()) {
+    if (self->list_.empty()) {
         return env->new_exception(ErrorCode::RUNTIME_OUT_OF_BOUNDS, "Pop from empty list");
     }
-    self->list_->pop();
+    self->list_.pop();
     return NanBox::NilValue;
 }
 
@@ -49,7 +49,7 @@ static Value builtin_insert(AriaEnv *env, int argCount, Value *args)
     auto self = as_obj_list(args[-1]);
     CHECK_INTEGER(args[0], index, Argument);
     Value value = args[1];
-    bool result = self->list_->insert(index, value);
+    bool result = self->list_.insert(index, value);
     return NanBox::fromBool(result);
 }
 
@@ -57,8 +57,8 @@ static Value builtin_remove(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
     CHECK_INTEGER(args[0], index, Argument);
-    CHECK_RANGE(index, 0, self->list_->size(), Index);
-    bool result = self->list_->remove(index);
+    CHECK_RANGE(index, 0, self->list_.size(), Index);
+    bool result = self->list_.remove(index);
     return NanBox::fromBool(result);
 }
 
@@ -66,14 +66,14 @@ static Value builtin_at(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
     CHECK_INTEGER(args[0], index, Argument);
-    CHECK_RANGE(index, 0, self->list_->size(), Index);
-    return (*self->list_)[index];
+    CHECK_RANGE(index, 0, self->list_.size(), Index);
+    return self->list_[index];
 }
 
 static Value builtin_clear(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
-    self->list_->clear();
+    self->list_.clear();
     return NanBox::NilValue;
 }
 
@@ -83,7 +83,7 @@ static Value builtin_slice(AriaEnv *env, int argCount, Value *args)
     CHECK_INTEGER(args[0], start, Start index);
     CHECK_INTEGER(args[1], end, End index);
 
-    auto size = self->list_->size();
+    auto size = self->list_.size();
     CHECK_RANGE(start, 0, size, Start index);
     CHECK_RANGE(end, 0, size, End index);
     if (end < start) {
@@ -97,7 +97,7 @@ static Value builtin_slice(AriaEnv *env, int argCount, Value *args)
 static Value builtin_reverse(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
-    self->list_->reverse();
+    self->list_.reverse();
     return NanBox::NilValue;
 }
 
@@ -105,7 +105,7 @@ static Value builtin_equals(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_list(args[-1]);
     CHECK_OBJLIST(args[0], Argument);
-    bool result = self->list_->equals(as_obj_list(args[0])->list_);
+    bool result = self->list_.equals(&as_obj_list(args[0])->list_);
     return NanBox::fromBool(result);
 }
 
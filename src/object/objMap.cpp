@@ -6,6 +6,7 @@
 #include "object/objString.h"
 #include "runtime/vm.h"
 #include "util/hash.h"
+#include "util/sink.h"
 #include "util/util.h"
 #include "value/valueHashTable.h"
 #include "value/valueStack.h"
@@ -17,13 +18,11 @@ namespace aria {
 ObjMap::ObjMap(GC *gc)
     : Obj{ObjType::MAP, hash_obj(this, ObjType::MAP), gc}
     , map_{new ValueHashTable{gc}}
-    , cached_methods_{gc}
 {}
 
 ObjMap::ObjMap(Value *values, uint32_t count, GC *gc)
     : Obj{ObjType::MAP, hash_obj(this, ObjType::MAP), gc}
     , map_{new ValueHashTable{values, count, gc}}
-    , cached_methods_{gc}
 {}
 
 ObjMap::~ObjMap()
@@ -45,17 +44,27 @@ String ObjMap::representation()
     return to_string();
 }
 
-Value ObjMap::get_by_field(ObjString *name, Value &value)
+void ObjMap::write_string(Sink &sink)
 {
-    if (cached_methods_.get(NanBox::fromObj(name), value)) {
-        return NanBox::TrueValue;
+    if (PrintGuard::is_cycle(this)) {
+        sink.write("{...}");
+        return;
     }
+    PrintGuard guard(this);
+    map_->write_to(sink);
+}
+
+void ObjMap::write_representation(Sink &sink)
+{
+    write_string(sink);
+}
+
+Value ObjMap::get_by_field(ObjString *name, Value &value)
+{
     if (gc_->map_methods_->get(NanBox::fromObj(name), value)) {
         assert(is_obj_native_fn(value) && "map builtin method is nativeFn");
         auto boundMethod = new_ObjBoundMethod(NanBox::fromObj(this), as_obj_native_fn(value), gc_);
         value = NanBox::fromObj(boundMethod);
-        GcTempRootGuard guard{gc_, value};
-        cached_methods_.insert(NanBox::fromObj(name), value);
         return NanBox::TrueValue;
     }
     return NanBox::FalseValue;
@@ -91,7 +100,6 @@ Value ObjMap::copy(GC *gc)
 void ObjMap::blacken()
 {
     map_->mark();
-    cached_methods_.mark();
 }
 
 ObjMap *new_ObjMap(GC *gc)
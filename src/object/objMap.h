@@ -21,6 +21,10 @@ public:
 
     String representation() override;
 
+    void write_string(Sink &sink) override;
+
+    void write_representation(Sink &sink) override;
+
     size_t obj_size() override { return sizeof(ObjMap); }
 
     Value get_by_field(ObjString *name, Value &value) override;
@@ -36,7 +40,6 @@ public:
     void blacken() override;
 
     ValueHashTable *map_;
-    ValueHashTable cached_methods_;
 
     static void init(GC *_gc, ValueHashTable *builtins);
 };
@@ -39,7 +39,7 @@ static Value builtin_has(AriaEnv *env, int argCount, Value *args)
 static Value builtin_size(AriaEnv *env, int argCount, Value *args)
 {
     auto self = as_obj_map(args[-1]);
-    return NanBox::fromNumber(self->map_->size());
+    return NanBox::fromInteger(self->map_->size());
 }
 
 static Value builtin_empty(AriaEnv *env, int argCount, Value *args)
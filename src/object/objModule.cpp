@@ -5,7 +5,7 @@
 #include "object/objString.h"
 #include "util/hash.h"
 #include "util/util.h"
-#include "value/valueHashTable.h"
+#include "value/globalTable.h"
 
 namespace aria {
 
@@ -27,7 +27,7 @@ String ObjModule::to_string()
 
 Value ObjModule::get_by_field(ObjString *name, Value &value)
 {
-    if (module_->get(NanBox::fromObj(name), value)) {
+    if (module_->get(name, value)) {
         return NanBox::TrueValue;
     }
     return NanBox::FalseValue;
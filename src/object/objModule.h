@@ -6,7 +6,7 @@
 namespace aria {
 
 class ObjFunction;
-class ValueHashTable;
+class GlobalTable;
 class ObjModule : public Obj
 {
 public:
@@ -25,7 +25,7 @@ public:
     void blacken() override;
 
     ObjString *name_;
-    ValueHashTable *module_;
+    GlobalTable *module_;
 };
 
 inline bool is_obj_module(Value value)
@@ -14,13 +14,15 @@ ObjNativeFn::ObjNativeFn(
     ObjString *name,
     int arity,
     bool acceptsVarargs,
-    GC *gc)
+    GC *gc,
+    VarargsConvention convention)
     : Obj{ObjType::NATIVE_FN, hash_obj(this, ObjType::NATIVE_FN), gc}
     , type_{type}
     , function_{function}
     , name_{name}
     , arity_{arity}
     , accepts_varargs_{acceptsVarargs}
+    , varargs_convention_{convention}
 {}
 
 ObjNativeFn::~ObjNativeFn() = default;
@@ -38,9 +40,16 @@ void ObjNativeFn::blacken()
 }
 
 ObjNativeFn *new_ObjNativeFn(
-    FunctionType type, NativeFn_t function, ObjString *name, int arity, bool acceptsVarargs, GC *gc)
+    FunctionType type,
+    NativeFn_t function,
+    ObjString *name,
+    int arity,
+    bool acceptsVarargs,
+    GC *gc,
+    VarargsConvention convention)
 {
-    auto obj = gc->allocate_object<ObjNativeFn>(type, function, name, arity, acceptsVarargs, gc);
+    auto obj = gc->allocate_object<ObjNativeFn>(
+        type, function, name, arity, acceptsVarargs, gc, convention);
     log_obj_allocation(obj);
     return obj;
 }
@@ -21,7 +21,8 @@ public:
         ObjString *name,
         int arity,
         bool acceptsVarargs,
-        GC *gc);
+        GC *gc,
+        VarargsConvention convention = VarargsConvention::LIST);
 
     ~ObjNativeFn() override;
 
@@ -36,6 +37,7 @@ public:
     ObjString *name_;
     int arity_;
     bool accepts_varargs_;
+    VarargsConvention varargs_convention_;
 };
 
 inline bool is_obj_native_fn(Value value)
@@ -54,7 +56,13 @@ inline NativeFn_t as_native_fn(Value value)
 }
 
 ObjNativeFn *new_ObjNativeFn(
-    FunctionType type, NativeFn_t function, ObjString *name, int arity, bool acceptsVarargs, GC *gc);
+    FunctionType type,
+    NativeFn_t function,
+    ObjString *name,
+    int arity,
+    bool acceptsVarargs,
+    GC *gc,
+    VarargsConvention convention = VarargsConvention::LIST);
 
 void bindBuiltinMethod(
     ValueHashTable *methodTab,
@@ -6,6 +6,7 @@
 #include "object/objNativeFn.h"
 #include "runtime/vm.h"
 #include "util/hash.h"
+#include "util/sink.h"
 #include "value/valueHashTable.h"
 
 #include <cassert>
@@ -68,6 +69,18 @@ String ObjString::representation()
     return String{format("'{}'", c_str())};
 }
 
+void ObjString::write_string(Sink &sink)
+{
+    sink.write(StringView{c_str(), length_});
+}
+
+void ObjString::write_representation(Sink &sink)
+{
+    sink.put('\'');
+    sink.write(StringView{c_str(), length_});
+    sink.put('\'');
+}
+
 Value ObjString::get_by_field(ObjString *name, Value &value)
 {
     if (gc_->string_methods_->get(NanBox::fromObj(name), value)) {
@@ -81,11 +94,8 @@ Value ObjString::get_by_field(ObjString *name, Value &value)
 
 Value ObjString::get_by_index(Value k, Value &v)
 {
-    if (!NanBox::isNumber(k)) {
-        return new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "index of string must be a integer");
-    }
-    int index = static_cast<int>(NanBox::toNumber(k));
-    if (index != NanBox::toNumber(k)) {
+    int32_t index;
+    if (!NanBox::toInteger(k, index)) {
         return new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "index of string must be a integer");
     }
     if (index < 0 || index >= length_) {
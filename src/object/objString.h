@@ -22,6 +22,10 @@ public:
 
     String representation() override;
 
+    void write_string(Sink &sink) override;
+
+    void write_representation(Sink &sink) override;
+
     size_t obj_size() override { return sizeof(ObjString); }
 
     Value get_by_field(ObjString *name, Value &value) override;
@@ -13,7 +13,7 @@ namespace aria {
 static Value builtin_length(AriaEnv *env, int argCount, Value *args)
 {
     ObjString *self = as_obj_string(args[-1]);
-    return NanBox::fromNumber(static_cast<double>(self->length_));
+    return NanBox::fromInteger(static_cast<int64_t>(self->length_));
 }
 
 static Value builtin_at(AriaEnv *env, int argCount, Value *args)
@@ -50,9 +50,9 @@ static Value builtin_findstr(AriaEnv *env, int argCount, Value *args)
     const ObjString *substr = as_obj_string(args[0]);
     const char *result = strstr(self->c_str(), substr->c_str());
     if (result == nullptr) {
-        return NanBox::fromNumber(-1);
+        return NanBox::fromInt(-1);
     }
-    return NanBox::fromNumber(static_cast<double>(result - self->c_str()));
+    return NanBox::fromInteger(result - self->c_str());
 }
 
 static Value builtin_concat(AriaEnv *env, int argCount, Value *args)
@@ -212,7 +212,7 @@ static Value builtin_split(AriaEnv *env, int argCount, Value *args)
             if (!isspace(srcStr[i])) {
                 ObjString *i_str = NEW_OBJSTRING(srcStr[i]);
                 guard.push(NanBox::fromObj(i_str));
-                objlist->list_->push(NanBox::fromObj(i_str));
+                objlist->list_.push(NanBox::fromObj(i_str));
             }
         }
     } else {
@@ -225,7 +225,7 @@ static Value builtin_split(AriaEnv *env, int argCount, Value *args)
             if (token_len > 0) {
                 ObjString *i_str = NEW_OBJSTRING(start, token_len);
                 guard.push(NanBox::fromObj(i_str));
-                objlist->list_->push(NanBox::fromObj(i_str));
+                objlist->list_.push(NanBox::fromObj(i_str));
             }
             start = end + delim_len;
             end = strstr(start, delimStr);
@@ -234,7 +234,7 @@ static Value builtin_split(AriaEnv *env, int argCount, Value *args)
         if (strlen(start) > 0) {
             ObjString *i_str = NEW_OBJSTRING(start, strlen(start));
             guard.push(NanBox::fromObj(i_str));
-            objlist->list_->push(NanBox::fromObj(i_str));
+            objlist->list_.push(NanBox::fromObj(i_str));
         }
     }
 
@@ -1,5 +1,6 @@
 #include "object/object.h"
 #include "runtime/vm.h"
+#include "util/sink.h"
 
 namespace aria {
 
@@ -16,7 +17,18 @@ const char *Obj::obj_type_str_[]
        "MAP",
        "MODULE",
        "ITERATOR",
-       "EXCEPTION"};
+       "EXCEPTION",
+       "CLOSURE"};
+
+void Obj::write_string(Sink &sink)
+{
+    sink.write(to_string());
+}
+
+void Obj::write_representation(Sink &sink)
+{
+    sink.write(representation());
+}
 
 void Obj::mark()
 {
@@ -12,6 +12,7 @@ namespace aria {
 class GC;
 class ObjString;
 class ObjFunction;
+class ObjClosure;
 class ObjNativeFn;
 class ObjUpvalue;
 class ObjClass;
@@ -37,6 +38,7 @@ enum class ObjType : uint8_t {
     MODULE,
     ITERATOR,
     EXCEPTION,
+    CLOSURE,
 };
 
 // RAII guard for cycle detection in to_string/repr
@@ -91,6 +93,11 @@ public:
 
     virtual String representation() { return this->to_string(); }
 
+    // 流式输出：默认写入 to_string() / representation() 的结果，容器和字符串直接写入 sink
+    virtual void write_string(Sink &sink);
+
+    virtual void write_representation(Sink &sink);
+
     virtual size_t obj_size() = 0;
 
     void mark();
@@ -147,6 +154,7 @@ DEFINE_OBJ_TYPE_MAP(ObjMap, ObjType::MAP)
 DEFINE_OBJ_TYPE_MAP(ObjModule, ObjType::MODULE)
 DEFINE_OBJ_TYPE_MAP(ObjIterator, ObjType::ITERATOR)
 DEFINE_OBJ_TYPE_MAP(ObjException, ObjType::EXCEPTION)
+DEFINE_OBJ_TYPE_MAP(ObjClosure, ObjType::CLOSURE)
 
 #undef DEFINE_OBJ_TYPE_MAP
 
@@ -0,0 +1,44 @@
+#include "object/shape.h"
+
+namespace aria {
+
+Shape::Shape(const Shape *parent, ObjString *name)
+    : names_{parent->names_}
+    , index_{parent->index_}
+{
+    names_.push_back(name);
+    if (names_.size() > k_linear_lookup_limit) {
+        if (index_.empty()) {
+            for (uint32_t i = 0; i < names_.size(); i++) {
+                index_[names_[i]] = i;
+            }
+        } else {
+            index_[name] = field_count() - 1;
+        }
+    }
+}
+
+int32_t Shape::lookup(ObjString *name) const
+{
+    if (!index_.empty()) {
+        auto it = index_.find(name);
+        return it == index_.end() ? -1 : static_cast<int32_t>(it->second);
+    }
+    for (uint32_t i = 0; i < names_.size(); i++) {
+        if (names_[i] == name) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+Shape *Shape::add_field(ObjString *name)
+{
+    auto &next = transitions_[name];
+    if (next == nullptr) {
+        next = UniquePtr<Shape>{new Shape{this, name}};
+    }
+    return next.get();
+}
+
+} // namespace aria
@@ -0,0 +1,46 @@
+#ifndef ARIA_SHAPE_H
+#define ARIA_SHAPE_H
+
+#include "common.h"
+
+namespace aria {
+
+class ObjString;
+
+// 隐藏类：记录字段名到槽位下标的映射。
+// 以相同顺序添加相同字段的实例共享同一个 Shape，字段值保存在实例的槽位数组中。
+// Shape 树由 GC 持有，直到 GC 析构才释放；字段名都是驻留字符串，不会被回收，因此无需标记
+class Shape
+{
+public:
+    Shape() = default;
+
+    ~Shape() = default;
+
+    Shape(const Shape &) = delete;
+    Shape &operator=(const Shape &) = delete;
+
+    // return slot index of name, or -1 if absent
+    [[nodiscard]] int32_t lookup(ObjString *name) const;
+
+    // shape after appending field name (slot index == field_count())
+    Shape *add_field(ObjString *name);
+
+    [[nodiscard]] uint32_t field_count() const { return static_cast<uint32_t>(names_.size()); }
+
+    [[nodiscard]] ObjString *field_name(uint32_t slot) const { return names_[slot]; }
+
+private:
+    static constexpr uint32_t k_linear_lookup_limit = 8;
+
+    Shape(const Shape *parent, ObjString *name);
+
+    List<ObjString *> names_;
+    // 字段较多时使用哈希索引
+    Map<ObjString *, uint32_t> index_;
+    Map<ObjString *, UniquePtr<Shape>> transitions_;
+};
+
+} // namespace aria
+
+#endif //ARIA_SHAPE_H
@@ -9,13 +9,21 @@
 #include "value/value.h"
 
 namespace aria {
+class ObjClosure;
+class ObjUpvalue;
 
 struct CallFrame
 {
+    static constexpr uint32_t k_no_rest = UINT32_MAX;
+
     CallFrame(ObjFunction *_function, uint8_t *_ip, Value *_stakBase)
         : function{_function}
+        , closure{nullptr}
         , ip{_ip}
         , stakBase{_stakBase}
+        , open_upvalues{nullptr}
+        , rest_base{k_no_rest}
+        , rest_count{-1}
     {}
 
     CallFrame()
@@ -24,18 +32,26 @@ struct CallFrame
 
     ~CallFrame() = default;
 
-    void init(ObjFunction *_function, uint8_t *_ip, Value *_stakBase)
+    void init(ObjFunction *_function, ObjClosure *_closure, uint8_t *_ip, Value *_stakBase)
     {
         this->function = _function;
+        this->closure = _closure;
         this->ip = _ip;
         this->stakBase = _stakBase;
+        this->open_upvalues = nullptr;
+        this->rest_base = k_no_rest;
+        this->rest_count = -1;
     }
 
     void copy(CallFrame *other)
     {
         this->function = other->function;
+        this->closure = other->closure;
         this->ip = other->ip;
         this->stakBase = other->stakBase;
+        this->open_upvalues = other->open_upvalues;
+        this->rest_base = other->rest_base;
+        this->rest_count = other->rest_count;
     }
 
     uint8_t readByte()
@@ -57,8 +73,17 @@ struct CallFrame
     ObjString *readObjString() { return as_obj_string(readConstant()); }
 
     ObjFunction *function;
+    // 捕获了变量的函数经由闭包调用，LOAD_UPVALUE/STORE_UPVALUE 从这里取 upvalue；其余为 nullptr
+    ObjClosure *closure;
     uint8_t *ip;
     Value *stakBase;
+    // 指向本帧局部变量的 open upvalue，按栈位置从高到低排列
+    ObjUpvalue *open_upvalues;
+    // lazy_varargs_ 函数的多余参数在 AriaVM::rest_args_ 中的起始下标，栈帧弹出时截断到这里；
+    // 其余栈帧为 k_no_rest
+    uint32_t rest_base;
+    // 多余参数的个数；剩余参数已生成列表（或没有留在 rest_args_ 中）时为 -1
+    int32_t rest_count;
 };
 
 } // namespace aria
@@ -1,6 +1,7 @@
 #include "runtime/native.h"
 #include "common.h"
 #include "memory/gc.h"
+#include "object/objIterator.h"
 #include "object/objList.h"
 #include "object/objString.h"
 #include "runtime/vm.h"
@@ -28,46 +29,53 @@ Value Native::_aria_random_(AriaEnv *env, int argCount, Value *args)
         std::uniform_int_distribution<uint32_t>::param_type{
             static_cast<uint32_t>(min), static_cast<uint32_t>(max)});
 
-    return NanBox::fromNumber(dis(gen));
+    return NanBox::fromInteger(dis(gen));
 }
 
+// STACK 约定：args 是全部 argCount 个参数，第一个参数是格式串，其中的 {} 依次替换为后面的参数。
+// 各部分直接写入 VM 的输出缓冲
 Value Native::_aria_println_(AriaEnv *env, int argCount, Value *args)
 {
-    ObjList *list = as_obj_list(args[0]);
-    String formatStr = value_string((*list->list_)[0]);
-
+    Sink &out = env->output();
+    if (argCount == 0) {
+        out.end_line();
+        return NanBox::NilValue;
+    }
     if (argCount == 1) {
-        std::cout << value_string((*list->list_)[0]) << '\n';
+        write_value(args[0], out);
+        out.end_line();
         return NanBox::NilValue;
     }
 
     try {
-        String result;
+        const String formatStr = is_obj_string(args[0]) ? String{} : value_string(args[0]);
+        const StringView fmt = is_obj_string(args[0])
+                                   ? StringView{as_c_string(args[0]), as_obj_string(args[0])->length_}
+                                   : StringView{formatStr};
         int argIndex = 1;
-
-        for (size_t i = 0; i < formatStr.length(); ++i) {
-            if (formatStr[i] == '{' && i + 1 < formatStr.length() && formatStr[i + 1] == '}') {
-                if (argIndex < argCount) {
-                    result += value_string((*list->list_)[argIndex++]);
-                } else {
-                    result += "{}";
-                }
-                i++; // skip '}'
+        size_t start = 0;
+        for (size_t pos = fmt.find("{}"); pos != StringView::npos; pos = fmt.find("{}", start)) {
+            out.write(fmt.substr(start, pos - start));
+            if (argIndex < argCount) {
+                write_value(args[argIndex++], out);
             } else {
-                result += formatStr[i];
+                out.write("{}");
             }
+            start = pos + 2;
         }
-
-        std::cout << result << '\n';
+        out.write(fmt.substr(start));
+        out.end_line();
     } catch (const std::exception &e) {
         return env->new_exception(ErrorCode::RUNTIME_TYPE_ERROR, e.what());
     }
 
-    return list->list_->size();
+    return NanBox::NilValue;
 }
 
 Value Native::_aria_readline_(AriaEnv *env, int argCount, Value *args)
 {
+    // 先写出缓冲中的提示信息再等待输入
+    env->output().flush();
     String line;
     std::getline(std::cin, line);
     ObjString *objLineStr = new_ObjString(line, env->gc_);
@@ -96,7 +104,7 @@ Value Native::_aria_num_(AriaEnv *env, int argCount, Value *args)
 {
     CHECK_OBJSTRING(args[0], argument);
     try {
-        return NanBox::fromNumber(std::stod(as_c_string(args[0])));
+        return NanBox::packNumber(std::stod(as_c_string(args[0])));
     } catch ([[maybe_unused]] const std::exception &e) {
         return env->new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Conversion failed");
     }
@@ -136,8 +144,37 @@ Value Native::_aria_iter_(AriaEnv *env, int argCount, Value *args)
     return NanBox::NilValue;
 }
 
+// range(stop)、range(start, stop)、range(start, stop, step)
+// STACK 约定：args 直接是栈上的 argCount 个参数
+Value Native::_aria_range_(AriaEnv *env, int argCount, Value *args)
+{
+    if (argCount > 3) {
+        String msg = format("Expected at most 3 arguments but got {}.", argCount);
+        return env->new_exception(ErrorCode::RUNTIME_MISMATCH_ARG_COUNT, msg);
+    }
+    CHECK_INTEGER(args[0], first, Argument);
+    int32_t start = 0;
+    int32_t stop = first;
+    int32_t step = 1;
+    if (argCount >= 2) {
+        CHECK_INTEGER(args[1], second, Argument);
+        start = first;
+        stop = second;
+    }
+    if (argCount == 3) {
+        CHECK_INTEGER(args[2], third, Argument);
+        step = third;
+    }
+    if (step == 0) {
+        return env->new_exception(ErrorCode::RUNTIME_TYPE_ERROR, "range step must not be zero");
+    }
+    return NanBox::fromObj(new_ObjIterator(new RangeIterator{start, stop, step}, env->gc_));
+}
+
 Value Native::_aria_exit_(AriaEnv *env, int argCount, Value *args)
 {
+    // exit() 不会析构 VM，缓冲中的输出在这里写出
+    env->output().flush();
     if (!NanBox::isNumber(args[0])) {
         exit(1);
     }
@@ -166,7 +203,7 @@ List<NativeFnEntry> &Native::nativeFnTable()
     static List<NativeFnEntry> table = {
         {"clock", 0, _aria_clock_},
         {"random", 2, _aria_random_},
-        {"println", 0, _aria_println_, true},
+        {"println", 0, _aria_println_, true, VarargsConvention::STACK},
         {"readline", 0, _aria_readline_},
         {"typeof", 1, _aria_typeof_},
         {"str", 1, _aria_str_},
@@ -176,6 +213,7 @@ List<NativeFnEntry> &Native::nativeFnTable()
         {"copy", 1, _aria_copy_},
         {"equals", 2, _aria_equals_},
         {"iter", 1, _aria_iter_},
+        {"range", 1, _aria_range_, true, VarargsConvention::STACK},
         {"exit", 1, _aria_exit_},
         {"_foo_", 1, _aria__foo__},
     };
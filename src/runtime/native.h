@@ -20,12 +20,19 @@ struct NativeFnEntry
     int arity;
     NativeFn_t fn;
     bool acceptsVarargs;
+    VarargsConvention convention;
 
-    NativeFnEntry(const char *_name, int _arity, NativeFn_t _fn, bool _acceptsVarargs = false)
+    NativeFnEntry(
+        const char *_name,
+        int _arity,
+        NativeFn_t _fn,
+        bool _acceptsVarargs = false,
+        VarargsConvention _convention = VarargsConvention::LIST)
         : name{_name}
         , arity{_arity}
         , fn{_fn}
         , acceptsVarargs{_acceptsVarargs}
+        , convention{_convention}
     {}
 };
 
@@ -58,6 +65,7 @@ public:
     static Value _aria_copy_(AriaEnv *env, int argCount, Value *args);
     static Value _aria_equals_(AriaEnv *env, int argCount, Value *args);
     static Value _aria_iter_(AriaEnv *env, int argCount, Value *args);
+    static Value _aria_range_(AriaEnv *env, int argCount, Value *args);
     [[noreturn]] static Value _aria_exit_(AriaEnv *env, int argCount, Value *args);
     static Value _aria__foo__(AriaEnv *env, int argCount, Value *args);
 
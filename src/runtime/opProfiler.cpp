@@ -0,0 +1,162 @@
+#include "runtime/opProfiler.h"
+#include "chunk/disassembler.h"
+#include "util/util.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace aria {
+
+namespace {
+
+struct OpPair
+{
+    uint32_t first;
+    uint32_t second;
+    uint64_t count;
+};
+
+double percent(uint64_t part, uint64_t total)
+{
+    return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+}
+
+const char *nameOf(uint32_t op)
+{
+    return Disassembler::opcodeName(static_cast<opCode>(op));
+}
+
+} // namespace
+
+OpProfiler::OpProfiler()
+    : pairs_(k_op_count * k_op_count)
+{
+    reset();
+}
+
+void OpProfiler::finish()
+{
+    if (prev_op_ != k_no_op) {
+        cycles_[prev_op_] += now() - last_tick_;
+        prev_op_ = k_no_op;
+    }
+}
+
+void OpProfiler::reset()
+{
+    counts_.fill(0);
+    cycles_.fill(0);
+    std::fill(pairs_.begin(), pairs_.end(), 0);
+    last_tick_ = 0;
+    prev_op_ = k_no_op;
+}
+
+const char *OpProfiler::clock_unit()
+{
+    return ARIA_PROFILER_RDTSC ? "cycles" : "ns";
+}
+
+void OpProfiler::report(std::ostream &os, size_t pair_limit) const
+{
+    List<uint32_t> ops;
+    uint64_t total = 0;
+    uint64_t totalCycles = 0;
+    for (uint32_t op = 0; op < k_op_count; op++) {
+        if (counts_[op] != 0) {
+            ops.push_back(op);
+            total += counts_[op];
+            totalCycles += cycles_[op];
+        }
+    }
+    std::ranges::sort(ops, [this](uint32_t a, uint32_t b) { return counts_[a] > counts_[b]; });
+
+    print(os, "======== opcode profile ========\n");
+    print(os, "{} instructions, {} {}\n", total, totalCycles, clock_unit());
+    print(
+        os,
+        "{:<24} {:>14} {:>7} {:>16} {:>7} {:>10}\n",
+        "opcode",
+        "count",
+        "count%",
+        clock_unit(),
+        "time%",
+        "per op");
+    for (uint32_t op : ops) {
+        print(
+            os,
+            "{:<24} {:>14} {:>6.2f}% {:>16} {:>6.2f}% {:>10.1f}\n",
+            nameOf(op),
+            counts_[op],
+            percent(counts_[op], total),
+            cycles_[op],
+            percent(cycles_[op], totalCycles),
+            static_cast<double>(cycles_[op]) / static_cast<double>(counts_[op]));
+    }
+
+    List<OpPair> pairs;
+    uint64_t totalPairs = 0;
+    for (uint32_t i = 0; i < k_op_count * k_op_count; i++) {
+        if (pairs_[i] != 0) {
+            pairs.push_back({i / k_op_count, i % k_op_count, pairs_[i]});
+            totalPairs += pairs_[i];
+        }
+    }
+    std::ranges::sort(pairs, [](const OpPair &a, const OpPair &b) { return a.count > b.count; });
+    if (pairs.size() > pair_limit) {
+        pairs.resize(pair_limit);
+    }
+    print(os, "======== top opcode pairs ========\n");
+    for (const auto &pair : pairs) {
+        print(
+            os,
+            "{:<49} {:>14} {:>6.2f}%\n",
+            format("{} -> {}", nameOf(pair.first), nameOf(pair.second)),
+            pair.count,
+            percent(pair.count, totalPairs));
+    }
+}
+
+void OpProfiler::write_json(std::ostream &os) const
+{
+    print(os, "{{\n  \"clock_unit\": \"{}\",\n  \"opcodes\": [", clock_unit());
+    const char *sep = "\n";
+    for (uint32_t op = 0; op < k_op_count; op++) {
+        if (counts_[op] != 0) {
+            print(
+                os,
+                "{}    {{\"name\": \"{}\", \"count\": {}, \"time\": {}}}",
+                sep,
+                nameOf(op),
+                counts_[op],
+                cycles_[op]);
+            sep = ",\n";
+        }
+    }
+    print(os, "\n  ],\n  \"pairs\": [");
+    sep = "\n";
+    for (uint32_t i = 0; i < k_op_count * k_op_count; i++) {
+        if (pairs_[i] != 0) {
+            print(
+                os,
+                "{}    {{\"first\": \"{}\", \"second\": \"{}\", \"count\": {}}}",
+                sep,
+                nameOf(i / k_op_count),
+                nameOf(i % k_op_count),
+                pairs_[i]);
+            sep = ",\n";
+        }
+    }
+    print(os, "\n  ]\n}}\n");
+}
+
+bool OpProfiler::write_json(const String &path) const
+{
+    std::ofstream file{path};
+    if (!file) {
+        return false;
+    }
+    write_json(file);
+    return static_cast<bool>(file);
+}
+
+} // namespace aria
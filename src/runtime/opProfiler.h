@@ -0,0 +1,89 @@
+#ifndef ARIA_OPPROFILER_H
+#define ARIA_OPPROFILER_H
+
+#include "chunk/code.h"
+#include "common.h"
+
+#include <array>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define ARIA_PROFILER_RDTSC 1
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#define ARIA_PROFILER_RDTSC 1
+#else
+#include <chrono>
+#define ARIA_PROFILER_RDTSC 0
+#endif
+
+namespace aria {
+
+// 操作码执行统计：每条指令分发前调用 record，累计各操作码的执行次数、
+// 相邻两条指令的组合（bigram）次数，以及两次分发之间的时钟差（计入前一条指令）。
+// x86-64 上用 rdtsc 计时（单位为 TSC 周期），其他平台用 steady_clock（单位为纳秒）。
+// 时钟读数包含分发和计时本身的开销，只适合比较各操作码的相对耗时
+class OpProfiler
+{
+public:
+    OpProfiler();
+
+    void record(uint8_t op)
+    {
+        const uint64_t tick = now();
+        if (prev_op_ != k_no_op) {
+            cycles_[prev_op_] += tick - last_tick_;
+            pairs_[prev_op_ * k_op_count + op]++;
+        }
+        counts_[op]++;
+        prev_op_ = op;
+        last_tick_ = tick;
+    }
+
+    // 把最后一条指令的耗时计入统计，之后的 record 开始新的指令序列
+    void finish();
+
+    void reset();
+
+    [[nodiscard]] uint64_t count(opCode op) const { return counts_[static_cast<uint8_t>(op)]; }
+
+    [[nodiscard]] uint64_t pair_count(opCode first, opCode second) const
+    {
+        return pairs_[static_cast<uint8_t>(first) * k_op_count + static_cast<uint8_t>(second)];
+    }
+
+    // 按执行次数排序的文本报告，附带最常见的 pair_limit 个指令组合
+    void report(std::ostream &os, size_t pair_limit = 20) const;
+
+    void write_json(std::ostream &os) const;
+
+    // 写入失败时返回 false
+    bool write_json(const String &path) const;
+
+private:
+    static constexpr uint32_t k_op_count = 256;
+    static constexpr uint32_t k_no_op = k_op_count;
+
+    static uint64_t now()
+    {
+#if ARIA_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    static const char *clock_unit();
+
+    std::array<uint64_t, k_op_count> counts_;
+    std::array<uint64_t, k_op_count> cycles_;
+    List<uint64_t> pairs_;
+    uint64_t last_tick_;
+    uint32_t prev_op_;
+};
+
+} // namespace aria
+
+#endif //ARIA_OPPROFILER_H
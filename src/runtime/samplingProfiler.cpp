@@ -0,0 +1,189 @@
+#include "runtime/samplingProfiler.h"
+#include "chunk/chunk.h"
+#include "object/objFunction.h"
+#include "object/objString.h"
+#include "runtime/vm.h"
+#include "sys.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <sstream>
+
+#if !defined(SYS_WINDOWS)
+#include <csignal>
+#include <sys/time.h>
+#define ARIA_SAMPLING 1
+#else
+#define ARIA_SAMPLING 0
+#endif
+
+namespace aria {
+
+namespace {
+
+constexpr uint64_t k_truncated = uint64_t{1} << 32;
+
+// SIGPROF 是进程级的信号，同一时刻只允许一个采样器接收
+std::atomic<SamplingProfiler *> activeProfiler{nullptr};
+
+#if ARIA_SAMPLING
+struct sigaction oldAction;
+#endif
+
+String frameLabel(const ObjFunction *function, uint64_t line)
+{
+    const String file = std::filesystem::path{function->location_->c_str()}.filename().string();
+    return format("{} ({}:{})", function->name_->c_str(), file, line);
+}
+
+} // namespace
+
+SamplingProfiler::SamplingProfiler(const AriaVM *vm)
+    : vm_{vm}
+    , write_pos_{0}
+    , read_pos_{0}
+    , dropped_{0}
+    , samples_{0}
+    , running_{false}
+{}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+bool SamplingProfiler::start(uint32_t hz)
+{
+#if ARIA_SAMPLING
+    if (running_ || hz == 0) {
+        return false;
+    }
+    SamplingProfiler *expected = nullptr;
+    if (!activeProfiler.compare_exchange_strong(expected, this)) {
+        return false;
+    }
+    if (buffer_ == nullptr) {
+        buffer_ = std::make_unique<uint64_t[]>(k_buffer_words);
+    }
+    struct sigaction action{};
+    action.sa_handler = &SamplingProfiler::on_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &oldAction);
+
+    const auto interval = static_cast<suseconds_t>(std::max(1000000u / hz, 1u));
+    itimerval timer{};
+    timer.it_interval.tv_sec = interval / 1000000;
+    timer.it_interval.tv_usec = interval % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    running_ = true;
+    return true;
+#else
+    (void) hz;
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop()
+{
+#if ARIA_SAMPLING
+    if (!running_) {
+        return;
+    }
+    itimerval timer{};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sigaction(SIGPROF, &oldAction, nullptr);
+    activeProfiler.store(nullptr);
+    running_ = false;
+    drain();
+#endif
+}
+
+void SamplingProfiler::on_signal(int)
+{
+    const int savedErrno = errno;
+    if (SamplingProfiler *profiler = activeProfiler.load(std::memory_order_relaxed)) {
+        profiler->sample();
+    }
+    errno = savedErrno;
+}
+
+// 在信号处理函数中执行：只读取 VM 的栈帧并写缓冲区
+void SamplingProfiler::sample()
+{
+    const int frameCount = vm_->c_frame_count_;
+    if (frameCount <= 0) {
+        return;
+    }
+    if (vm_->frames_moving_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint32_t depth = std::min(static_cast<uint32_t>(frameCount), k_max_depth);
+    const uint64_t words = 1 + 2 * uint64_t{depth};
+    const uint64_t write = write_pos_.load(std::memory_order_relaxed);
+    if (write + words - read_pos_.load(std::memory_order_acquire) > k_buffer_words) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    constexpr uint64_t mask = k_buffer_words - 1;
+    uint64_t pos = write;
+    buffer_[pos++ & mask] = depth | (depth < static_cast<uint32_t>(frameCount) ? k_truncated : 0);
+    const CallFrame *frames = vm_->c_frames_.data();
+    for (int i = frameCount - static_cast<int>(depth); i < frameCount; i++) {
+        const ObjFunction *function = frames[i].function;
+        const Chunk *chunk = function->chunk_;
+        // 调用者帧的 ip 指向 CALL 之后，取前一个字节所在的行
+        uint32_t offset = static_cast<uint32_t>(frames[i].ip - chunk->codes_);
+        offset = offset > 0 ? offset - 1 : 0;
+        buffer_[pos++ & mask] = reinterpret_cast<uintptr_t>(function);
+        buffer_[pos++ & mask] = offset < chunk->count_ ? chunk->lines_[offset] : 0;
+    }
+    write_pos_.store(pos, std::memory_order_release);
+}
+
+void SamplingProfiler::drain()
+{
+    if (buffer_ == nullptr) {
+        return;
+    }
+    constexpr uint64_t mask = k_buffer_words - 1;
+    const uint64_t write = write_pos_.load(std::memory_order_acquire);
+    uint64_t pos = read_pos_.load(std::memory_order_relaxed);
+    String stack;
+    while (pos < write) {
+        const uint64_t header = buffer_[pos++ & mask];
+        const auto depth = static_cast<uint32_t>(header);
+        stack = (header & k_truncated) != 0 ? "[truncated]" : "";
+        for (uint32_t i = 0; i < depth; i++) {
+            const auto *function = reinterpret_cast<const ObjFunction *>(buffer_[pos++ & mask]);
+            const uint64_t line = buffer_[pos++ & mask];
+            if (!stack.empty()) {
+                stack += ';';
+            }
+            stack += frameLabel(function, line);
+        }
+        stacks_[stack]++;
+        samples_++;
+    }
+    read_pos_.store(pos, std::memory_order_release);
+}
+
+String SamplingProfiler::folded() const
+{
+    List<const Map<String, uint64_t>::value_type *> entries;
+    entries.reserve(stacks_.size());
+    for (const auto &entry : stacks_) {
+        entries.push_back(&entry);
+    }
+    std::ranges::sort(entries, [](auto a, auto b) { return a->first < b->first; });
+    std::ostringstream oss;
+    for (const auto *entry : entries) {
+        println(oss, "{} {}", entry->first, entry->second);
+    }
+    return oss.str();
+}
+
+} // namespace aria
@@ -0,0 +1,64 @@
+#ifndef ARIA_SAMPLINGPROFILER_H
+#define ARIA_SAMPLINGPROFILER_H
+
+#include "common.h"
+
+#include <atomic>
+#include <memory>
+
+namespace aria {
+
+class AriaVM;
+
+// 定时对 Aria 调用栈采样，结果是 flamegraph.pl 可读的折叠栈（每行 "main;foo;bar 123"）。
+// 基于 SIGPROF：信号处理函数只把各栈帧的 (函数, 行号) 写入预先分配的无锁环形缓冲区，
+// 不分配内存也不加锁；drain 在主线程中把缓冲区里的样本折叠成字符串计数。
+// 缓冲区保存的是函数对象指针，所以 GC 回收对象之前（标记根时）必须先 drain。
+// 栈顶帧的行号来自解释器最近一次保存的 ip，可能落后几条指令。
+// 同一进程内同时只能有一个采样器在运行；不支持的平台上 start 返回 false
+class SamplingProfiler
+{
+public:
+    static constexpr uint32_t k_default_hz = 1000;
+
+    explicit SamplingProfiler(const AriaVM *vm);
+
+    ~SamplingProfiler();
+
+    bool start(uint32_t hz = k_default_hz);
+
+    void stop();
+
+    void drain();
+
+    // 已 drain 的样本，按折叠栈的字典序输出
+    [[nodiscard]] String folded() const;
+
+    [[nodiscard]] uint64_t sample_count() const { return samples_; }
+
+    // 缓冲区已满或调用栈正在扩容时丢弃的样本数
+    [[nodiscard]] uint64_t dropped_count() const { return dropped_.load(); }
+
+private:
+    static constexpr uint64_t k_buffer_words = 1 << 20;
+    static constexpr uint32_t k_max_depth = 256;
+
+    static void on_signal(int signal);
+
+    void sample();
+
+    const AriaVM *vm_;
+    // 每个样本：一个头部字（低 32 位为帧数，第 32 位标记栈被截断），随后每帧两个字（函数指针、行号），
+    // 从最外层帧到栈顶帧排列
+    std::unique_ptr<uint64_t[]> buffer_;
+    std::atomic<uint64_t> write_pos_;
+    std::atomic<uint64_t> read_pos_;
+    std::atomic<uint64_t> dropped_;
+    Map<String, uint64_t> stacks_;
+    uint64_t samples_;
+    bool running_;
+};
+
+} // namespace aria
+
+#endif //ARIA_SAMPLINGPROFILER_H
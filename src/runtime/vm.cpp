@@ -4,8 +4,10 @@
 #include "chunk/disassembler.h"
 #include "compile/compiler.h"
 #include "error/error.h"
+#include "jit/jit.h"
 #include "object/objBoundMethod.h"
 #include "object/objClass.h"
+#include "object/objClosure.h"
 #include "object/objException.h"
 #include "object/objFunction.h"
 #include "object/objInstance.h"
@@ -16,16 +18,23 @@
 #include "object/objNativeFn.h"
 #include "object/objString.h"
 #include "object/objUpvalue.h"
+#include "object/shape.h"
 #include "runtime/native.h"
+#include "runtime/opProfiler.h"
+#include "runtime/samplingProfiler.h"
+#include "value/globalTable.h"
 #include "value/valueHashTable.h"
 
 // debugger header files
 #include "debugger/debugger.h"
 
 // std header files
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
+#include <iterator>
 #include <sstream>
 #include <utility>
 
@@ -33,11 +42,9 @@ namespace aria {
 
 AriaVM::AriaVM()
     : gc_{new GC{}}
-    , c_frames_{new CallFrame[k_frame_size]}
-    , e_frames_{new ExceptionFrame[k_frame_size]}
-    , r_modules_{new Value[k_frame_size]}
+    , c_frames_(k_initial_frames)
+    , r_modules_(k_initial_frames)
     , c_frame_count_{0}
-    , e_frame_count_{0}
     , r_module_count_{0}
     , frame_{nullptr}
     , chunk_{nullptr}
@@ -45,9 +52,13 @@ AriaVM::AriaVM()
     , flags_{0}
     , built_in_{new ValueHashTable{gc_}}
     , cached_modules_{new ValueHashTable{gc_}}
-    , open_upvalues_{nullptr}
-    , globals_{new ValueHashTable{gc_}}
+    , globals_{new GlobalTable{built_in_}}
     , debugger_{nullptr}
+    , op_profiler_{nullptr}
+    , sampler_{nullptr}
+    , frames_moving_{0}
+    , backend_{CodeBackend::STACK}
+    , output_{&std::cout, Sink::stdout_is_tty()}
 {
     gc_->attach_vm(this);
     register_native();
@@ -55,9 +66,8 @@ AriaVM::AriaVM()
 
 AriaVM::~AriaVM()
 {
-    delete[] c_frames_;
-    delete[] e_frames_;
-    delete[] r_modules_;
+    output_.flush();
+    delete sampler_;
     delete built_in_;
     delete cached_modules_;
     delete globals_;
@@ -70,23 +80,27 @@ InterpretResult AriaVM::run_source(String sourceLocation, String source)
     println("aria directory: {}", aria_dir_);
     println("source file path: {}", sourceLocation);
 #endif
-    auto script = Compiler::compile(std::move(sourceLocation), std::move(source), gc_, globals_);
+    auto script = Compiler::compile(
+        std::move(sourceLocation), std::move(source), gc_, globals_, backend_);
     if (script == nullptr) {
         return InterpretResult::COMPILE_ERROR;
     }
     reset();
+    InterpretResult result = InterpretResult::RUNTIME_ERROR;
     try {
         stack_.push(NanBox::fromObj(script));
         call_module(script);
-        if (get_err_flag()) {
-            return InterpretResult::RUNTIME_ERROR;
+        if (!get_err_flag()) {
+            run();
+            result = InterpretResult::SUCCESS;
         }
-        run();
-        return InterpretResult::SUCCESS;
     } catch (const ariaException &e) {
+        // 先写出程序已经打印的内容，错误信息才出现在它们之后
+        output_.flush();
         error(e.what());
     }
-    return InterpretResult::RUNTIME_ERROR;
+    output_.flush();
+    return result;
 }
 
 InterpretResult AriaVM::interpret(String srcFilePath, String source)
@@ -117,10 +131,13 @@ Value AriaVM::run_function(ObjFunction *fun, int argCount, const Value *args)
     if (fun == nullptr) {
         report_runtime_fatal_error(ErrorCode::RUNTIME_NULL_REFERENCE, "Invalid function pointer");
     }
-    stack_.push(NanBox::fromObj(fun));
     if (argCount > 0 && args == nullptr) {
         report_runtime_fatal_error(ErrorCode::RUNTIME_NULL_REFERENCE, "Invalid arguments pointer");
     }
+    if (!reserve_stack(static_cast<uint32_t>(argCount) + 1)) {
+        return new_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "Stack overflow.");
+    }
+    stack_.push(NanBox::fromObj(fun));
     for (int i = 0; i < argCount; i++) {
         stack_.push(args[i]);
     }
@@ -131,6 +148,34 @@ Value AriaVM::run_function(ObjFunction *fun, int argCount, const Value *args)
 void AriaVM::set_debugger(AriaDebugger *_debugger)
 {
     debugger_ = _debugger;
+    // 调试时程序输出要和调试器的提示交替出现
+    output_.set_line_buffered(_debugger != nullptr || Sink::stdout_is_tty());
+}
+
+bool AriaVM::start_sampling(uint32_t hz)
+{
+    if (sampler_ != nullptr) {
+        return false;
+    }
+    sampler_ = new SamplingProfiler{this};
+    if (!sampler_->start(hz)) {
+        delete sampler_;
+        sampler_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+String AriaVM::stop_sampling()
+{
+    if (sampler_ == nullptr) {
+        return "";
+    }
+    sampler_->stop();
+    String result = sampler_->folded();
+    delete sampler_;
+    sampler_ = nullptr;
+    return result;
 }
 
 Value AriaVM::new_exception(ErrorCode code, const char *msg)
@@ -157,30 +202,56 @@ void AriaVM::update_call_frame()
     }
 }
 
-void AriaVM::push_call_frame(ObjFunction *_function, uint8_t *_ip, Value *_stakBase)
+bool AriaVM::reserve_stack(uint32_t count)
 {
-    if (c_frame_count_ >= k_frame_size) {
-        throw_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "Call stack overflow.");
-        return;
+    Value *oldBase = stack_.base();
+    if (!stack_.reserve(count)) {
+        return false;
     }
-    c_frames_[c_frame_count_].init(_function, _ip, _stakBase);
-    c_frame_count_++;
-    frame_ = &c_frames_[c_frame_count_ - 1];
-    chunk_ = frame_->function->chunk_;
+    const ptrdiff_t delta = stack_.base() - oldBase;
+    if (delta == 0) {
+        return true;
+    }
+    for (int i = 0; i < c_frame_count_; i++) {
+        c_frames_[i].stakBase += delta;
+        for (ObjUpvalue *upvalue = c_frames_[i].open_upvalues; upvalue != nullptr;
+             upvalue = upvalue->next_upvalue_) {
+            upvalue->location_ += delta;
+        }
+    }
+    return true;
 }
 
-void AriaVM::push_exception_frame(
-    int c_frame_count, int r_module_count, uint8_t *ip, uint32_t stack_size)
+void AriaVM::push_call_frame(
+    ObjFunction *_function, uint8_t *_ip, Value *_stakBase, ObjClosure *_closure)
 {
-    e_frames_[e_frame_count_].init(c_frame_count, r_module_count, ip, stack_size);
-    e_frame_count_++;
+    if (c_frame_count_ == static_cast<int>(c_frames_.size())) {
+        if (c_frame_count_ >= k_max_frames) {
+            throw_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "Call stack overflow.");
+            return;
+        }
+        frames_moving_ = 1;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        c_frames_.resize(c_frames_.size() * 2);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        frames_moving_ = 0;
+    }
+    c_frames_[c_frame_count_].init(_function, _closure, _ip, _stakBase);
+    // 采样信号只读取 c_frame_count_ 以内的栈帧，先写好栈帧再计数
+    std::atomic_signal_fence(std::memory_order_release);
+    c_frame_count_++;
+    frame_ = &c_frames_[c_frame_count_ - 1];
+    chunk_ = frame_->function->chunk_;
 }
 
 void AriaVM::push_running_module(const ObjFunction *_function)
 {
-    if (r_module_count_ >= k_frame_size) {
-        throw_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "Module stack overflow.");
-        return;
+    if (r_module_count_ == static_cast<int>(r_modules_.size())) {
+        if (r_module_count_ >= k_max_frames) {
+            throw_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "Module stack overflow.");
+            return;
+        }
+        r_modules_.resize(r_modules_.size() * 2);
     }
     r_modules_[r_module_count_] = NanBox::fromObj(_function->location_);
     r_module_count_++;
@@ -188,6 +259,9 @@ void AriaVM::push_running_module(const ObjFunction *_function)
 
 void AriaVM::pop_call_frame()
 {
+    if (frame_->rest_base != CallFrame::k_no_rest) {
+        rest_args_.resize(frame_->rest_base);
+    }
     c_frame_count_--;
     if (c_frame_count_ == 0) {
         frame_ = nullptr;
@@ -198,11 +272,6 @@ void AriaVM::pop_call_frame()
     }
 }
 
-void AriaVM::pop_exception_frame()
-{
-    e_frame_count_--;
-}
-
 void AriaVM::pop_running_module()
 {
     r_module_count_--;
@@ -225,6 +294,13 @@ void AriaVM::pack_varargs(int argCount, int arity)
     }
 }
 
+void AriaVM::materialize_rest(CallFrame *frame, uint16_t slot)
+{
+    Value *start = rest_args_.data() + frame->rest_base;
+    frame->stakBase[slot] = NanBox::fromObj(new_ObjList(start, frame->rest_count, gc_));
+    frame->rest_count = -1;
+}
+
 ObjModule *AriaVM::cache_module(ObjFunction *moduleFn)
 {
     GcTempRootGuard guard{gc_, NanBox::fromObj(moduleFn)};
@@ -234,14 +310,23 @@ ObjModule *AriaVM::cache_module(ObjFunction *moduleFn)
     return as_obj_module(module);
 }
 
-Value AriaVM::create_call_frame(ObjFunction *function)
+// 栈式函数每条指令最多使栈增长一个槽位，字节码长度就是栈深度的上界；寄存器帧大小固定
+static uint32_t frame_slots(const ObjFunction *function)
 {
-    if (c_frame_count_ == k_frame_size) {
+    return function->frame_size_ != 0 ? function->frame_size_ : function->chunk_->count_;
+}
+
+Value AriaVM::create_call_frame(ObjFunction *function, ObjClosure *closure)
+{
+    if (c_frame_count_ == k_max_frames || !reserve_stack(frame_slots(function) + k_stack_slack)) {
         return new_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "Stack overflow.");
     }
     // Normal function frame base includes callee itself at slot 0.
     auto arity = function->accepts_varargs_ ? function->arity_ + 2 : function->arity_ + 1;
-    push_call_frame(function, function->chunk_->codes_, stack_.get_top_ptr() - arity);
+    push_call_frame(function, function->chunk_->codes_, stack_.get_top_ptr() - arity, closure);
+    if (function->frame_size_ != 0) {
+        enter_register_frame();
+    }
     return NanBox::NilValue;
 }
 
@@ -260,7 +345,10 @@ Value AriaVM::return_from_current_frame(Value result)
     assert(c_frame_count_ > 0 && "returnFromCurrentFrame called with empty frame stack.");
     assert(r_module_count_ > 0 && "returnFromCurrentFrame called with empty running module stack.");
 #endif
-    close_upvalues(frame_->stakBase);
+    // 没有局部变量被捕获的函数不会留下 open upvalue
+    if (frame_->function->captures_locals_) {
+        close_upvalues(frame_, frame_->stakBase);
+    }
     if (frame_->function->type_ == FunctionType::SCRIPT) {
         result = return_from_current_module(result);
     }
@@ -268,12 +356,32 @@ Value AriaVM::return_from_current_frame(Value result)
     return result;
 }
 
+// 栈帧中超出当前栈顶的槽位可能残留着已被回收的对象，寄存器帧把它们纳入 GC 扫描范围前先置为 nil
+void AriaVM::enter_register_frame()
+{
+    // 字面量寄存器紧跟在参数之后，其余寄存器置 nil
+    const ValueArray &consts = frame_->function->chunk_->consts_;
+    Value *reg = std::copy_n(consts.data(), consts.size(), stack_.get_top_ptr());
+    Value *end = frame_->stakBase + frame_->function->frame_size_;
+    std::fill(reg, end, NanBox::NilValue);
+    stack_.set_top_ptr(end);
+}
+
+void AriaVM::restore_register_frame()
+{
+    Value *end = frame_->stakBase + frame_->function->frame_size_;
+    std::fill(stack_.get_top_ptr(), end, NanBox::NilValue);
+    stack_.set_top_ptr(end);
+}
+
 Value AriaVM::call_value(Value callee, int argCount)
 {
     if (NanBox::isObj(callee)) {
         switch (get_obj_type(callee)) {
         case ObjType::FUNCTION:
             return call_function(as_obj_function(callee), argCount);
+        case ObjType::CLOSURE:
+            return call_closure(as_obj_closure(callee), argCount);
         case ObjType::NATIVE_FN:
             return call_native_fn(as_obj_native_fn(callee), argCount);
         case ObjType::CLASS:
@@ -287,17 +395,125 @@ Value AriaVM::call_value(Value callee, int argCount)
     return new_exception(ErrorCode::RUNTIME_INVALID_CALL, "Invalid call operation.");
 }
 
+Value AriaVM::call_value_cached(Value callee, int argCount, CallCache *cache)
+{
+    if (callee == cache->callee) {
+        switch (cache->kind) {
+        case CallCacheKind::FUNCTION:
+            return create_call_frame(cache->function, cache->closure);
+        case CallCacheKind::NATIVE: {
+            ObjNativeFn *native = as_obj_native_fn(callee);
+            Value result = native->function_(this, argCount, stack_.get_top_ptr() - argCount);
+            stack_.pop_n(argCount + 1);
+            stack_.push(result);
+            return result;
+        }
+        case CallCacheKind::CLASS:
+            // 类的 init 方法在 MAKE_INIT_METHOD 之后不再改变
+            stack_[stack_.size() - argCount - 1]
+                = NanBox::fromObj(new_ObjInstance(as_obj_class(callee), gc_));
+            if (cache->function == nullptr) {
+                return NanBox::NilValue;
+            }
+            return create_call_frame(cache->function, cache->closure);
+        case CallCacheKind::NONE:
+            break;
+        }
+    }
+    update_call_cache(cache, callee, argCount);
+    return call_value(callee, argCount);
+}
+
+// 只缓存参数个数完全匹配、不需要打包可变参数的调用；其余情况清空缓存，每次走通用路径
+void AriaVM::update_call_cache(CallCache *cache, Value callee, int argCount)
+{
+    *cache = CallCache{};
+    if (!NanBox::isObj(callee)) {
+        return;
+    }
+    ObjFunction *function = nullptr;
+    ObjClosure *closure = nullptr;
+    CallCacheKind kind = CallCacheKind::FUNCTION;
+    switch (get_obj_type(callee)) {
+    case ObjType::FUNCTION:
+        function = as_obj_function(callee);
+        break;
+    case ObjType::CLOSURE:
+        closure = as_obj_closure(callee);
+        function = closure->function_;
+        break;
+    case ObjType::NATIVE_FN: {
+        const ObjNativeFn *native = as_obj_native_fn(callee);
+        // 缓存命中时 args 指向全部 argCount 个参数，正是 STACK 约定的可变参数调用
+        const bool stackVarargs = native->accepts_varargs_
+                                  && native->varargs_convention_ == VarargsConvention::STACK
+                                  && argCount >= native->arity_;
+        if ((!native->accepts_varargs_ && native->arity_ == argCount) || stackVarargs) {
+            cache->callee = callee;
+            cache->kind = CallCacheKind::NATIVE;
+        }
+        return;
+    }
+    case ObjType::CLASS: {
+        Obj *init = as_obj_class(callee)->init_method_;
+        if (init == nullptr) {
+            if (argCount == 0) {
+                cache->callee = callee;
+                cache->kind = CallCacheKind::CLASS;
+            }
+            return;
+        }
+        kind = CallCacheKind::CLASS;
+        if (init->type_ == ObjType::CLOSURE) {
+            closure = static_cast<ObjClosure *>(init);
+            function = closure->function_;
+        } else {
+            function = static_cast<ObjFunction *>(init);
+        }
+        break;
+    }
+    default:
+        return;
+    }
+    if (!function->accepts_varargs_ && function->arity_ == argCount) {
+        cache->callee = callee;
+        cache->kind = kind;
+        cache->function = function;
+        cache->closure = closure;
+    }
+}
+
 Value AriaVM::call_module(ObjFunction *module)
 {
-    if (r_module_count_ == k_frame_size) {
+    if (r_module_count_ == k_max_frames) {
         return new_exception(ErrorCode::RUNTIME_STACK_OVERFLOW, "RunningModule Stack overflow.");
     }
     push_running_module(module);
+    if (debugger_) {
+        debugger_->hookModuleLoaded(module);
+    }
     return call_function(module, 0);
 }
 
-Value AriaVM::call_function(ObjFunction *function, int argCount)
+Value AriaVM::call_function(ObjFunction *function, int argCount, ObjClosure *closure)
 {
+    if (function->accepts_varargs_ && argCount >= function->arity_ && function->lazy_varargs_) {
+        // 多余的参数移到 rest_args_，剩余参数的槽位先放 nil，用作值时才生成列表
+        const int count = argCount - function->arity_;
+        const auto base = static_cast<uint32_t>(rest_args_.size());
+        Value *extra = stack_.get_top_ptr() - count;
+        rest_args_.insert(rest_args_.end(), extra, extra + count);
+        stack_.pop_n(count);
+        stack_.push(NanBox::NilValue);
+        Value result = create_call_frame(function, closure);
+        if (is_obj_exception(result)) {
+            rest_args_.resize(base);
+            return result;
+        }
+        frame_->rest_base = base;
+        frame_->rest_count = count;
+        return result;
+    }
     if (function->accepts_varargs_ && argCount >= function->arity_) {
         pack_varargs(argCount, function->arity_);
     } else if (argCount == function->arity_) {
@@ -306,21 +522,29 @@ Value AriaVM::call_function(ObjFunction *function, int argCount)
         String msg = format("Expected {} arguments but got {}.", function->arity_, argCount);
         return new_exception(ErrorCode::RUNTIME_MISMATCH_ARG_COUNT, msg);
     }
-    return create_call_frame(function);
+    return create_call_frame(function, closure);
+}
+
+Value AriaVM::call_closure(ObjClosure *closure, int argCount)
+{
+    return call_function(closure->function_, argCount, closure);
 }
 
 Value AriaVM::call_native_fn(ObjNativeFn *native, int argCount)
 {
+    // Native function args pointer starts from first argument.
+    int arity = native->arity_;
     if (native->accepts_varargs_ && argCount >= native->arity_) {
-        pack_varargs(argCount, native->arity_);
-    } else if (argCount == native->arity_) {
-        // pass
-    } else {
+        if (native->varargs_convention_ == VarargsConvention::STACK) {
+            arity = argCount;
+        } else {
+            pack_varargs(argCount, native->arity_);
+            arity = native->arity_ + 1;
+        }
+    } else if (argCount != native->arity_) {
         String msg = format("Expected {} arguments but got {}.", native->arity_, argCount);
         return new_exception(ErrorCode::RUNTIME_MISMATCH_ARG_COUNT, msg);
     }
-    // Native function args pointer starts from first argument.
-    auto arity = native->accepts_varargs_ ? native->arity_ + 1 : native->arity_;
     Value result = native->function_(this, argCount, stack_.get_top_ptr() - arity);
     stack_.pop_n(arity + 1);
     stack_.push(result);
@@ -331,7 +555,7 @@ Value AriaVM::call_new_instance(ObjClass *klass, int argCount)
 {
     stack_[stack_.size() - argCount - 1] = NanBox::fromObj(new_ObjInstance(klass, gc_));
     if (klass->init_method_ != nullptr) {
-        return call_function(klass->init_method_, argCount);
+        return call_method(NanBox::fromObj(klass->init_method_), argCount);
     }
     if (argCount != 0) {
         String msg = format("Expected 0 argument but got {}.", argCount);
@@ -344,7 +568,7 @@ Value AriaVM::call_bound_method(const ObjBoundMethod *method, const int argCount
 {
     if (method->method_type_ == BoundMethodType::FUNCTION) {
         stack_[stack_.size() - argCount - 1] = method->receiver_;
-        return call_function(method->method_, argCount);
+        return call_function(method->method_, argCount, method->closure_);
     }
     if (method->method_type_ == BoundMethodType::NATIVE_FN) {
         stack_[stack_.size() - argCount - 1] = method->receiver_;
@@ -353,10 +577,120 @@ Value AriaVM::call_bound_method(const ObjBoundMethod *method, const int argCount
     return new_exception(ErrorCode::RUNTIME_INVALID_CALL, "Unknown bound method type.");
 }
 
+Value AriaVM::call_method(Value method, int argCount)
+{
+    if (is_obj_native_fn(method)) {
+        return call_native_fn(as_obj_native_fn(method), argCount);
+    }
+    if (is_obj_closure(method)) {
+        return call_closure(as_obj_closure(method), argCount);
+    }
+    return call_function(as_obj_function(method), argCount);
+}
+
+Value AriaVM::invoke_method(ObjString *name, int argCount, MethodCache *cache)
+{
+    Value receiver = stack_.peek(argCount);
+    if (!NanBox::isObj(receiver)) {
+        return new_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, "Only objects have fields.");
+    }
+    Obj *obj = NanBox::toObj(receiver);
+    Value method;
+
+    // 接收者已经位于 slot 0，找到方法后直接调用
+    switch (obj->type_) {
+    case ObjType::INSTANCE: {
+        auto instance = static_cast<ObjInstance *>(obj);
+        if (instance->shape_ == cache->shape && instance->klass_ == cache->klass) {
+            return call_method(cache->method, argCount);
+        }
+        // 同名字段优先于方法；shape 相同则字段集合相同，因此缓存以 shape 和类为键
+        if (instance->shape_->lookup(name) < 0
+            && instance->klass_->methods_.get(NanBox::fromObj(name), method)) {
+            *cache = MethodCache{instance->shape_, instance->klass_, method};
+            return call_method(method, argCount);
+        }
+        break;
+    }
+    case ObjType::LIST:
+        if (gc_->list_methods_->get(NanBox::fromObj(name), method)) {
+            return call_native_fn(as_obj_native_fn(method), argCount);
+        }
+        break;
+    case ObjType::MAP:
+        if (gc_->map_methods_->get(NanBox::fromObj(name), method)) {
+            return call_native_fn(as_obj_native_fn(method), argCount);
+        }
+        break;
+    case ObjType::STRING:
+        if (gc_->string_methods_->get(NanBox::fromObj(name), method)) {
+            return call_native_fn(as_obj_native_fn(method), argCount);
+        }
+        break;
+    case ObjType::ITERATOR:
+        if (gc_->iterator_methods_->get(NanBox::fromObj(name), method)) {
+            return call_native_fn(as_obj_native_fn(method), argCount);
+        }
+        break;
+    default:
+        break;
+    }
+
+    // 模块成员、可调用的字段等：与 LOAD_FIELD + CALL 相同，被调用者替换接收者
+    if (NanBox::isFalse(obj->get_by_field(name, method))) {
+        String msg = format(
+            "this {} object does no have attribute {}.", obj->representation(), name->c_str());
+        return new_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, msg);
+    }
+    stack_[stack_.size() - argCount - 1] = method;
+    return call_value(method, argCount);
+}
+
+bool AriaVM::tail_call(int argCount)
+{
+    Value callee = stack_.peek(argCount);
+    ObjFunction *function;
+    ObjClosure *closure = nullptr;
+    if (is_obj_function(callee)) {
+        function = as_obj_function(callee);
+    } else if (is_obj_closure(callee)) {
+        closure = as_obj_closure(callee);
+        function = closure->function_;
+    } else if (is_obj_bound_method(callee)
+               && as_obj_bound_method(callee)->method_type_ == BoundMethodType::FUNCTION) {
+        function = as_obj_bound_method(callee)->method_;
+        closure = as_obj_bound_method(callee)->closure_;
+        stack_[stack_.size() - argCount - 1] = as_obj_bound_method(callee)->receiver_;
+    } else {
+        return false;
+    }
+    // 参数个数不符时照常调用，报错时的调用栈中保留当前栈帧。
+    // 新栈帧的槽位也要在弹出当前栈帧之前预留：预留失败时按普通 CALL 执行，由它抛出栈溢出异常，
+    // 预留成功后 call_function 不会再失败（reserve_stack 可能移动值栈，之后才能取栈上的指针）
+    if ((function->accepts_varargs_ ? argCount < function->arity_ : argCount != function->arity_)
+        || !reserve_stack(frame_slots(function) + k_stack_slack)) {
+        stack_[stack_.size() - argCount - 1] = callee;
+        return false;
+    }
+    // 被调用者和参数滑到当前栈帧的底部，在同一位置重新建立栈帧
+    Value *base = frame_->stakBase;
+    Value *args = stack_.get_top_ptr() - argCount - 1;
+    if (frame_->function->captures_locals_) {
+        close_upvalues(frame_, base);
+    }
+    std::copy(args, args + argCount + 1, base);
+    stack_.set_top_ptr(base + argCount + 1);
+    pop_call_frame();
+    call_function(function, argCount, closure);
+    return true;
+}
+
+// 被捕获的局部变量总在当前帧，只需查找本帧的 open upvalue 链表，
+// 新捕获的变量通常位于最高的槽位，在表头即可找到插入位置
 ObjUpvalue *AriaVM::capture_upvalue(Value *local)
 {
     ObjUpvalue *prevUpvalue = nullptr;
-    ObjUpvalue *upvalue = open_upvalues_;
+    ObjUpvalue *upvalue = frame_->open_upvalues;
     while (upvalue != nullptr && upvalue->location_ > local) {
         prevUpvalue = upvalue;
         upvalue = upvalue->next_upvalue_;
@@ -369,27 +703,27 @@ ObjUpvalue *AriaVM::capture_upvalue(Value *local)
     createdUpvalue->next_upvalue_ = upvalue;
 
     if (prevUpvalue == nullptr) {
-        open_upvalues_ = createdUpvalue;
+        frame_->open_upvalues = createdUpvalue;
     } else {
         prevUpvalue->next_upvalue_ = createdUpvalue;
     }
     return createdUpvalue;
 }
 
-void AriaVM::close_upvalues(const Value *last)
+void AriaVM::close_upvalues(CallFrame *frame, const Value *last)
 {
-    while (open_upvalues_ != nullptr && open_upvalues_->location_ >= last) {
-        ObjUpvalue *upvalue = open_upvalues_;
+    while (frame->open_upvalues != nullptr && frame->open_upvalues->location_ >= last) {
+        ObjUpvalue *upvalue = frame->open_upvalues;
         upvalue->closed_ = *upvalue->location_;
         upvalue->location_ = &upvalue->closed_;
-        open_upvalues_ = upvalue->next_upvalue_;
+        frame->open_upvalues = upvalue->next_upvalue_;
     }
 }
 
 void AriaVM::register_native() const
 {
     for (const auto &entry : Native::nativeFnTable()) {
-        define_native_fn(entry.name, entry.arity, entry.fn, entry.acceptsVarargs);
+        define_native_fn(entry.name, entry.arity, entry.fn, entry.acceptsVarargs, entry.convention);
     }
 
     for (auto &var : Native::nativeVarTable()) {
@@ -398,12 +732,22 @@ void AriaVM::register_native() const
 }
 
 void AriaVM::define_native_fn(
-    const char *name, int arity, NativeFn_t function, bool acceptsVarargs) const
+    const char *name,
+    int arity,
+    NativeFn_t function,
+    bool acceptsVarargs,
+    VarargsConvention convention) const
 {
     Value key = NanBox::fromObj(new_ObjString(name, gc_));
     GcTempRootGuard guard{gc_, key};
     Value value = NanBox::fromObj(new_ObjNativeFn(
-        FunctionType::FUNCTION, function, as_obj_string(key), arity, acceptsVarargs, gc_));
+        FunctionType::FUNCTION,
+        function,
+        as_obj_string(key),
+        arity,
+        acceptsVarargs,
+        gc_,
+        convention));
     guard.push(value);
     built_in_->insert(key, value);
 }
@@ -443,27 +787,43 @@ ObjFunction *AriaVM::load_module(const String &path, ObjString *module_name)
     } catch ([[maybe_unused]] const std::exception &e) {
         return nullptr;
     }
-    return Compiler::compile(path, module_name->c_str(), std::move(source), gc_);
+    auto globals = new GlobalTable{built_in_};
+    auto module = Compiler::compile(
+        path, module_name->c_str(), std::move(source), gc_, globals, backend_);
+    if (module == nullptr) {
+        delete globals;
+    }
+    return module;
 }
 
 void AriaVM::mark_gc_roots()
 {
+    // 采样缓冲区中引用的函数对象可能在本次回收中被释放，先把样本折叠成字符串
+    if (sampler_ != nullptr) {
+        sampler_->drain();
+    }
+
     stack_.mark();
 
     mark_value(e_reg_);
 
     for (int i = 0; i < c_frame_count_; i++) {
         c_frames_[i].function->mark();
+        if (c_frames_[i].closure != nullptr) {
+            c_frames_[i].closure->mark();
+        }
+        for (ObjUpvalue *p = c_frames_[i].open_upvalues; p != nullptr; p = p->next_upvalue_) {
+            p->mark();
+        }
+    }
+    for (Value value : rest_args_) {
+        mark_value(value);
     }
 
     for (int i = 0; i < r_module_count_; i++) {
         mark_value(r_modules_[i]);
     }
 
-    for (ObjUpvalue *p = open_upvalues_; p != nullptr; p = p->next_upvalue_) {
-        p->mark();
-    }
-
     built_in_->mark();
     cached_modules_->mark();
     if (globals_ != nullptr) {
@@ -478,10 +838,10 @@ bool AriaVM::numeric_bin_op()
         throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Operands must be numbers.");
         return false;
     }
-    double b = NanBox::toNumber(stack_.pop());
+    Value b = stack_.pop();
 
     if constexpr (op == NumericBinOp::DIV || op == NumericBinOp::MOD) {
-        if (is_zero(b)) {
+        if (is_zero(NanBox::toNumber(b))) {
             if constexpr (op == NumericBinOp::DIV) {
                 throw_exception(ErrorCode::RUNTIME_DIVISION_BY_ZERO, "Divide by zero.");
             } else {
@@ -491,156 +851,639 @@ bool AriaVM::numeric_bin_op()
         }
     }
 
-    double a = NanBox::toNumber(stack_.pop());
+    Value a = stack_.pop();
 
     if constexpr (op == NumericBinOp::GT) {
-        stack_.push(NanBox::fromBool(a > b));
+        stack_.push(NanBox::fromBool(NanBox::greater(a, b)));
     } else if constexpr (op == NumericBinOp::GE) {
-        stack_.push(NanBox::fromBool(a >= b));
+        stack_.push(NanBox::fromBool(NanBox::greaterEqual(a, b)));
     } else if constexpr (op == NumericBinOp::LT) {
-        stack_.push(NanBox::fromBool(a < b));
+        stack_.push(NanBox::fromBool(NanBox::less(a, b)));
     } else if constexpr (op == NumericBinOp::LE) {
-        stack_.push(NanBox::fromBool(a <= b));
+        stack_.push(NanBox::fromBool(NanBox::lessEqual(a, b)));
+    } else if constexpr (op == NumericBinOp::ADD) {
+        stack_.push(NanBox::add(a, b));
     } else if constexpr (op == NumericBinOp::SUB) {
-        stack_.push(NanBox::fromNumber(a - b));
+        stack_.push(NanBox::sub(a, b));
     } else if constexpr (op == NumericBinOp::MUL) {
-        stack_.push(NanBox::fromNumber(a * b));
+        stack_.push(NanBox::mul(a, b));
     } else if constexpr (op == NumericBinOp::DIV) {
-        stack_.push(NanBox::fromNumber(a / b));
+        stack_.push(NanBox::div(a, b));
     } else if constexpr (op == NumericBinOp::MOD) {
-        stack_.push(NanBox::fromNumber(std::fmod(a, b)));
+        stack_.push(NanBox::mod(a, b));
     }
     return true;
 }
 
+// JIT 的慢路径在 jit.cpp 中调用
+template bool AriaVM::numeric_bin_op<NumericBinOp::GT>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::GE>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::LT>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::LE>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::SUB>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::MUL>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::DIV>();
+template bool AriaVM::numeric_bin_op<NumericBinOp::MOD>();
+
+bool AriaVM::add_objects()
+{
+    if (is_obj_string(stack_.peek()) && is_obj_string(stack_.peek(1))) {
+        ObjString *b = as_obj_string(stack_.peek(0));
+        ObjString *a = as_obj_string(stack_.peek(1));
+        ObjString *result = concatenate_string(a, b, gc_);
+        if (result == nullptr) {
+            fatal_error(
+                ErrorCode::RESOURCE_STRING_OVERFLOW,
+                "String concatenation result exceeds maximum length。");
+        }
+        stack_.pop_n(2);
+        stack_.push(NanBox::fromObj(result));
+        return true;
+    }
+    throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Operands must be numbers or strings.");
+    return false;
+}
+
+void AriaVM::load_field(ObjString *name, FieldCache *cache)
+{
+    if (!NanBox::isObj(stack_.peek())) {
+        throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, "Only objects have fields.");
+        return;
+    }
+    Obj *obj = NanBox::toObj(stack_.peek());
+    Value value;
+
+    // 缓存未命中：实例字段在 shape 中查到后更新内联缓存
+    if (obj->type_ == ObjType::INSTANCE) {
+        auto instance = static_cast<ObjInstance *>(obj);
+        if (int32_t slot = instance->shape_->lookup(name); slot >= 0) {
+            *cache = FieldCache{instance->shape_, nullptr, static_cast<uint32_t>(slot)};
+            stack_.set_top_val(instance->slots_[slot]);
+            return;
+        }
+    }
+
+    if (auto result = obj->get_by_field(name, value); NanBox::isFalse(result)) {
+        String msg = format(
+            "this {} object does no have attribute {}.", obj->representation(), name->c_str());
+        throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, msg);
+        return;
+    }
+    stack_.set_top_val(value);
+}
+
+void AriaVM::store_field(ObjString *name, FieldCache *cache)
+{
+    if (!NanBox::isObj(stack_.peek())) {
+        throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, "Only objects have fields.");
+        return;
+    }
+    // 接收者留在栈上直到写入完成，扩容槽位数组时可能触发 GC
+    Obj *obj = NanBox::toObj(stack_.peek());
+    Value value = stack_.peek(1);
+
+    if (obj->type_ == ObjType::INSTANCE) {
+        auto instance = static_cast<ObjInstance *>(obj);
+        Shape *shape = instance->shape_;
+        if (int32_t slot = shape->lookup(name); slot >= 0) {
+            *cache = FieldCache{shape, nullptr, static_cast<uint32_t>(slot)};
+            instance->slots_[slot] = value;
+        } else {
+            Shape *transition = shape->add_field(name);
+            instance->add_field(transition, value);
+            *cache = FieldCache{shape, transition, shape->field_count()};
+        }
+        stack_.pop();
+        return;
+    }
+
+    auto result = obj->set_by_field(name, value);
+    stack_.pop();
+    if (NanBox::isFalse(result)) {
+        String msg = format(
+            "this {} object does no support store field operation.",
+            value_type_string(stack_.peek()));
+        throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, msg);
+    }
+}
+
+// 指令分发：GCC/Clang 下使用 computed goto（每个 handler 末尾各自跳转，分支预测更准确），
+// 其余编译器或关闭 ARIA_COMPUTED_GOTO 时退回到 switch 分发。
+#if defined(ARIA_COMPUTED_GOTO) && ARIA_COMPUTED_GOTO && (defined(__GNUC__) || defined(__clang__))
+#define VM_COMPUTED_GOTO 1
+#else
+#define VM_COMPUTED_GOTO 0
+#endif
+
+// 解释器热状态（ip、栈顶、栈帧基址、常量表）保存在 run() 的局部变量中，
+// 只在调用、返回、抛出异常、可能触发 GC 的分配以及调试器钩子处与 frame_/stack_ 同步。
+// 慢路径 handler 的固定写法：VM_SAVE_STATE() → 原有逻辑 → VM_LOAD_STATE()。
+#define VM_SAVE_STATE() \
+    do { \
+        frame_->ip = ip; \
+        stack_.set_top_ptr(sp); \
+    } while (0)
+
+#define VM_LOAD_STATE() \
+    do { \
+        ip = frame_->ip; \
+        sp = stack_.get_top_ptr(); \
+        slots = frame_->stakBase; \
+        consts = chunk_->consts_.data(); \
+    } while (0)
+
+#define VM_READ_BYTE() (*ip++)
+#define VM_READ_WORD() (ip += 2, static_cast<uint16_t>((ip[-1] << 8) | ip[-2]))
+#define VM_READ_CONSTANT() (consts[VM_READ_WORD()])
+#define VM_WORD_AT(offset) static_cast<uint16_t>((ip[(offset) + 1] << 8) | ip[offset])
+#define VM_PUSH(value) (*sp++ = (value))
+#define VM_POP() (*--sp)
+#define VM_PEEK(depth) (sp[-1 - (depth)])
+
+#ifdef DEBUG_TRACE_EXECUTION
+#define VM_TRACE_INSTRUCTION() \
+    do { \
+        VM_SAVE_STATE(); \
+        stack_.display(slots - stack_.base(), frame_->function->to_string()); \
+        Disassembler::disassembleInstruction( \
+            chunk_, static_cast<uint32_t>(ip - chunk_->codes_), true); \
+    } while (0)
+#else
+#define VM_TRACE_INSTRUCTION() ((void) 0)
+#endif
+
+// 超级指令中的数值比较，op 是 LESS、LESS_EQUAL、GREATER 或 GREATER_EQUAL
+static inline bool compare_numbers(opCode op, Value a, Value b)
+{
+    switch (generic_opcode(op)) {
+    case opCode::LESS:
+        return NanBox::less(a, b);
+    case opCode::LESS_EQUAL:
+        return NanBox::lessEqual(a, b);
+    case opCode::GREATER:
+        return NanBox::greater(a, b);
+    default:
+        return NanBox::greaterEqual(a, b);
+    }
+}
+
+// 逐条跟踪执行时不进入机器码
+#if defined(ARIA_JIT) && ARIA_JIT && !defined(DEBUG_TRACE_EXECUTION)
+#define VM_JIT 1
+#else
+#define VM_JIT 0
+#endif
+
+// 调用和循环回边累计函数的热度，达到阈值时编译；已编译的函数在这两处进入机器码
+// 统计操作码或调试时所有指令都留在解释器中执行
+#define VM_JIT_HOT(function) \
+    (Mode == DispatchMode::FAST \
+     && ((function)->jit_code_ != nullptr || ++(function)->hotness_ == Jit::k_hot_threshold))
+
+// 循环回边（ip 已指向循环开头）：在循环开头进入机器码（OSR）
+#if VM_JIT
+#define VM_LOOP_BACK_EDGE() \
+    do { \
+        if (VM_JIT_HOT(frame_->function)) { \
+            VM_SAVE_STATE(); \
+            Value result; \
+            if (Jit::run(this, static_cast<uint32_t>(ip - chunk_->codes_), result)) { \
+                if (c_frame_count_ == retFrame) { \
+                    return result; \
+                } \
+                stack_.push(result); \
+                if (frame_->function->frame_size_ != 0) { \
+                    restore_register_frame(); \
+                } \
+            } \
+            VM_RELOAD_AND_NEXT(); \
+        } \
+    } while (0)
+#else
+#define VM_LOOP_BACK_EDGE() \
+    do { \
+    } while (0)
+#endif
+
+#define VM_BEFORE_DISPATCH() \
+    do { \
+        if constexpr (Mode == DispatchMode::PROFILE) { \
+            op_profiler_->record(*ip); \
+        } \
+        if constexpr (Mode == DispatchMode::DEBUG) { \
+            if (debugger_->wantsHook()) { \
+                VM_SAVE_STATE(); \
+                debugger_->hookBeforeExec(frame_, static_cast<uint32_t>(ip - chunk_->codes_)); \
+            } \
+        } \
+        VM_TRACE_INSTRUCTION(); \
+    } while (0)
+
+#if VM_COMPUTED_GOTO
+#define VM_INTERPRET_LOOP VM_NEXT();
+#define VM_CASE(op) L_##op
+#define VM_DEFAULT L_INVALID
+#define VM_NEXT() \
+    do { \
+        VM_BEFORE_DISPATCH(); \
+        goto *k_dispatch_table[VM_READ_BYTE()]; \
+    } while (0)
+#else
+#define VM_INTERPRET_LOOP \
+    vm_dispatch: \
+    VM_BEFORE_DISPATCH(); \
+    switch (static_cast<opCode>(VM_READ_BYTE()))
+#define VM_CASE(op) case opCode::op
+#define VM_DEFAULT default
+#define VM_NEXT() goto vm_dispatch
+#endif
+
+// 慢路径结束：重新载入可能被调用、返回或异常展开改变的状态后继续分发
+#define VM_RELOAD_AND_NEXT() \
+    do { \
+        VM_LOAD_STATE(); \
+        VM_NEXT(); \
+    } while (0)
+
+// 加速（quickening）：通用指令第一次以数字操作数执行时，把自身改写为 *_NUM 版本。
+// 只有当前字节仍是通用操作码时才改写，避免覆盖调试器等对字节码的其他修改
+#define VM_QUICKEN(generic, quick) \
+    do { \
+        if (ip[-1] == static_cast<uint8_t>(opCode::generic)) { \
+            ip[-1] = static_cast<uint8_t>(opCode::quick); \
+        } \
+    } while (0)
+
+// DIV/MOD 的除数为 0 时交给慢路径报错
+#define VM_NONZERO_DIVISOR(kind, b) \
+    ((kind != NumericBinOp::DIV && kind != NumericBinOp::MOD) || !is_zero(NanBox::toNumber(b)))
+
+// 两个操作数都是 int32 时单独展开一份运算，让编译器在该分支内消去 NanBox 运算中的类型判断；
+// 其余数字组合走通用分支，两个操作数不都是数字时什么也不做
+#define VM_NUMERIC_DISPATCH(a, b, body) \
+    do { \
+        if (NanBox::isInts(a, b)) { \
+            body; \
+        } else if (NanBox::isNumbers(a, b)) { \
+            body; \
+        } \
+    } while (0)
+
+#define VM_NUMERIC_FAST_PATH(kind, a, b, body) \
+    VM_NUMERIC_DISPATCH(a, b, { \
+        if (VM_NONZERO_DIVISOR(kind, b)) { \
+            body; \
+        } \
+    })
+
+// 数值二元运算的快速路径；类型错误、除零等情况交给 numeric_bin_op 处理
+#define VM_NUMERIC_BIN_OP(kind, op, expr) \
+    do { \
+        Value b = VM_PEEK(0); \
+        Value a = VM_PEEK(1); \
+        VM_NUMERIC_FAST_PATH(kind, a, b, { \
+            VM_QUICKEN(op, op##_NUM); \
+            sp[-2] = (expr); \
+            sp--; \
+            VM_NEXT(); \
+        }); \
+        VM_SAVE_STATE(); \
+        numeric_bin_op<kind>(); \
+        VM_RELOAD_AND_NEXT(); \
+    } while (0)
+
+// 已加速的数值运算：守卫失败时退回通用操作码（de-specialize）并转到通用实现
+#define VM_QUICK_NUMERIC_BIN_OP(kind, generic, expr) \
+    do { \
+        Value b = VM_PEEK(0); \
+        Value a = VM_PEEK(1); \
+        VM_NUMERIC_FAST_PATH(kind, a, b, { \
+            sp[-2] = (expr); \
+            sp--; \
+            VM_NEXT(); \
+        }); \
+        ip[-1] = static_cast<uint8_t>(opCode::generic); \
+        goto vm_generic_##generic; \
+    } while (0)
+
+// 寄存器后端：操作数是当前帧的寄存器（槽位）编号，帧内栈顶固定为 slots + frame_size_，
+// 慢路径把操作数压到帧顶之上，复用栈式指令的实现
+#define VM_REG(offset) (slots[ip[offset]])
+
+#define VM_REGISTER_BIN_OP(kind, expr) \
+    do { \
+        Value a = VM_REG(1); \
+        Value b = VM_REG(2); \
+        VM_NUMERIC_FAST_PATH(kind, a, b, { \
+            VM_REG(0) = (expr); \
+            ip += 3; \
+            VM_NEXT(); \
+        }); \
+        Value *dst = &VM_REG(0); \
+        ip += 3; \
+        VM_SAVE_STATE(); \
+        stack_.push(a); \
+        stack_.push(b); \
+        if (numeric_bin_op<kind>()) { \
+            *dst = stack_.pop(); \
+        } \
+        VM_RELOAD_AND_NEXT(); \
+    } while (0)
+
+// a b offset16：比较结果为假时向前跳转
+#define VM_REGISTER_CMP_JUMP(cond) \
+    do { \
+        Value a = VM_REG(0); \
+        Value b = VM_REG(1); \
+        const bool result = (cond); \
+        const uint16_t offset = VM_WORD_AT(2); \
+        ip += 4; \
+        if (!result) { \
+            ip += offset; \
+        } \
+        VM_NEXT(); \
+    } while (0)
+
+// 大小比较只对数字有效，其余情况由 numeric_bin_op 报告类型错误
+#define VM_REGISTER_ORDER_JUMP(kind, cond) \
+    do { \
+        Value a = VM_REG(0); \
+        Value b = VM_REG(1); \
+        VM_NUMERIC_DISPATCH(a, b, { VM_REGISTER_CMP_JUMP(cond); }); \
+        ip += 4; \
+        VM_SAVE_STATE(); \
+        stack_.push(a); \
+        stack_.push(b); \
+        numeric_bin_op<kind>(); \
+        VM_RELOAD_AND_NEXT(); \
+    } while (0)
+
 Value AriaVM::run(int retFrame)
 {
     if (retFrame < 0 || retFrame >= c_frame_count_) {
         report_runtime_fatal_error(ErrorCode::RUNTIME_INVALID_FRAME, "Invalid retFrame index");
     }
-    for (;;) {
-        auto codeOffset = static_cast<uint32_t>(frame_->ip - chunk_->codes_);
-        maybe_debug_step(codeOffset);
-#ifdef DEBUG_TRACE_EXECUTION
-        stack_.display(frame_->stakBase - stack_.base(), frame_->function->to_string());
-        Disassembler::disassembleInstruction(chunk_, codeOffset, true);
+    if (debugger_ != nullptr) {
+        return execute<DispatchMode::DEBUG>(retFrame);
+    }
+    if (op_profiler_ != nullptr) {
+        return execute<DispatchMode::PROFILE>(retFrame);
+    }
+    return execute<DispatchMode::FAST>(retFrame);
+}
+
+template<DispatchMode Mode>
+Value AriaVM::execute(int retFrame)
+{
+
+#if VM_COMPUTED_GOTO
+    static void *const k_dispatch_table[] = {
+        &&L_INVALID,
+        &&L_LOAD_CONST,
+        &&L_LOAD_NIL,
+        &&L_LOAD_TRUE,
+        &&L_LOAD_FALSE,
+        &&L_LOAD_LOCAL,
+        &&L_STORE_LOCAL,
+        &&L_LOAD_UPVALUE,
+        &&L_STORE_UPVALUE,
+        &&L_CLOSE_UPVALUE,
+        &&L_DEF_GLOBAL,
+        &&L_LOAD_GLOBAL,
+        &&L_STORE_GLOBAL,
+        &&L_LOAD_FIELD,
+        &&L_STORE_FIELD,
+        &&L_LOAD_SUBSCR,
+        &&L_STORE_SUBSCR,
+        &&L_EQUAL,
+        &&L_NOT_EQUAL,
+        &&L_GREATER,
+        &&L_GREATER_EQUAL,
+        &&L_LESS,
+        &&L_LESS_EQUAL,
+        &&L_ADD,
+        &&L_SUBTRACT,
+        &&L_MULTIPLY,
+        &&L_DIVIDE,
+        &&L_MOD,
+        &&L_NOT,
+        &&L_NEGATE,
+        &&L_POP,
+        &&L_POP_N,
+        &&L_PRINT,
+        &&L_NOP,
+        &&L_JUMP_FWD,
+        &&L_JUMP_BWD,
+        &&L_JUMP_TRUE,
+        &&L_JUMP_TRUE_NOPOP,
+        &&L_JUMP_FALSE,
+        &&L_JUMP_FALSE_NOPOP,
+        &&L_CALL,
+        &&L_CLOSURE,
+        &&L_MAKE_CLASS,
+        &&L_INHERIT,
+        &&L_MAKE_METHOD,
+        &&L_MAKE_INIT_METHOD,
+        &&L_INVOKE_METHOD,
+        &&L_LOAD_SUPER_METHOD,
+        &&L_MAKE_LIST,
+        &&L_MAKE_MAP,
+        &&L_IMPORT,
+        &&L_GET_ITER,
+        &&L_FOR_ITER,
+        &&L_THROW,
+        &&L_RETURN,
+        &&L_INC_LOCAL,
+        &&L_LOCAL_LOCAL_CMP_JUMP,
+        &&L_LOCAL_CONST_CMP_JUMP,
+        &&L_LOAD_LOCAL_FIELD,
+        &&L_FOR_RANGE,
+        &&L_ADD_NUM,
+        &&L_SUBTRACT_NUM,
+        &&L_MULTIPLY_NUM,
+        &&L_DIVIDE_NUM,
+        &&L_MOD_NUM,
+        &&L_GREATER_NUM,
+        &&L_GREATER_EQUAL_NUM,
+        &&L_LESS_NUM,
+        &&L_LESS_EQUAL_NUM,
+        &&L_REG_MOVE,
+        &&L_REG_LOAD_GLOBAL,
+        &&L_REG_STORE_GLOBAL,
+        &&L_REG_ADD,
+        &&L_REG_SUBTRACT,
+        &&L_REG_MULTIPLY,
+        &&L_REG_DIVIDE,
+        &&L_REG_MOD,
+        &&L_REG_EQUAL,
+        &&L_REG_NOT_EQUAL,
+        &&L_REG_GREATER,
+        &&L_REG_GREATER_EQUAL,
+        &&L_REG_LESS,
+        &&L_REG_LESS_EQUAL,
+        &&L_REG_NOT,
+        &&L_REG_NEGATE,
+        &&L_REG_JUMP_TRUE,
+        &&L_REG_JUMP_FALSE,
+        &&L_REG_EQUAL_JUMP,
+        &&L_REG_NOT_EQUAL_JUMP,
+        &&L_REG_GREATER_JUMP,
+        &&L_REG_GREATER_EQUAL_JUMP,
+        &&L_REG_LESS_JUMP,
+        &&L_REG_LESS_EQUAL_JUMP,
+        &&L_REG_CALL,
+        &&L_REG_RETURN,
+        &&L_REG_PRINT,
+        &&L_TAIL_CALL,
+        &&L_LOAD_REST,
+        &&L_LOAD_REST_ITEM,
+        &&L_LOAD_REST_ITER,
+        &&L_BREAKPOINT,
+    };
+    static_assert(
+        std::size(k_dispatch_table) == static_cast<size_t>(k_last_opcode) + 1,
+        "dispatch table must cover every opcode");
 #endif
 
-        switch (frame_->readOpcode()) {
-        case opCode::LOAD_CONST:
-            stack_.push(frame_->readConstant());
-            break;
-        case opCode::LOAD_NIL:
-            stack_.push(NanBox::NilValue);
-            break;
-        case opCode::LOAD_TRUE:
-            stack_.push(NanBox::TrueValue);
-            break;
-        case opCode::LOAD_FALSE:
-            stack_.push(NanBox::FalseValue);
-            break;
-        case opCode::LOAD_LOCAL: {
-            uint16_t offset = frame_->readWord();
-            stack_.push(frame_->stakBase[offset]);
-            break;
+    uint8_t *ip;
+    Value *sp;
+    Value *slots;
+    const Value *consts;
+    VM_LOAD_STATE();
+
+    VM_INTERPRET_LOOP
+    {
+        VM_CASE(LOAD_CONST): {
+            VM_PUSH(VM_READ_CONSTANT());
+            VM_NEXT();
         }
-        case opCode::STORE_LOCAL: {
-            uint16_t offset = frame_->readWord();
-            frame_->stakBase[offset] = stack_.peek();
-            break;
+        VM_CASE(LOAD_NIL): {
+            VM_PUSH(NanBox::NilValue);
+            VM_NEXT();
         }
-        case opCode::LOAD_UPVALUE: {
-            uint16_t slot = frame_->readWord();
-            Value val = *(frame_->function->upvalues_[slot]->location_);
-            stack_.push(val);
-            break;
+        VM_CASE(LOAD_TRUE): {
+            VM_PUSH(NanBox::TrueValue);
+            VM_NEXT();
         }
-        case opCode::STORE_UPVALUE: {
-            uint16_t slot = frame_->readWord();
-            *frame_->function->upvalues_[slot]->location_ = stack_.peek();
-            break;
+        VM_CASE(LOAD_FALSE): {
+            VM_PUSH(NanBox::FalseValue);
+            VM_NEXT();
         }
-        case opCode::CLOSE_UPVALUE: {
-            close_upvalues(stack_.get_top_ptr() - 1);
-            stack_.pop(); // pop captured upvalue variable
-            break;
+        VM_CASE(LOAD_LOCAL): {
+            uint16_t offset = VM_READ_WORD();
+            VM_PUSH(slots[offset]);
+            VM_NEXT();
+        }
+        VM_CASE(STORE_LOCAL): {
+            uint16_t offset = VM_READ_WORD();
+            slots[offset] = VM_PEEK(0);
+            VM_NEXT();
+        }
+        VM_CASE(LOAD_UPVALUE): {
+            uint16_t slot = VM_READ_WORD();
+            VM_PUSH(*(frame_->closure->upvalues_[slot]->location_));
+            VM_NEXT();
         }
-        case opCode::DEF_GLOBAL: {
-            ObjString *name = frame_->readObjString();
-            if (!chunk_->globals_->insert(NanBox::fromObj(name), stack_.peek())) {
-                String msg = format("Existed variable '{}'.", name->c_str());
+        VM_CASE(STORE_UPVALUE): {
+            uint16_t slot = VM_READ_WORD();
+            *frame_->closure->upvalues_[slot]->location_ = VM_PEEK(0);
+            VM_NEXT();
+        }
+        VM_CASE(CLOSE_UPVALUE): {
+            close_upvalues(frame_, sp - 1);
+            sp--; // pop captured upvalue variable
+            VM_NEXT();
+        }
+        VM_CASE(DEF_GLOBAL): {
+            uint16_t slot = VM_READ_WORD();
+            if (!chunk_->globals_->define(slot, VM_PEEK(0))) {
+                VM_SAVE_STATE();
+                String msg = format("Existed variable '{}'.", chunk_->globals_->name(slot)->c_str());
                 throw_exception(ErrorCode::RUNTIME_EXISTED_VARIABLE, msg);
-                break;
+                VM_RELOAD_AND_NEXT();
             }
-            stack_.pop();
-            break;
+            sp--;
+            VM_NEXT();
         }
-        case opCode::LOAD_GLOBAL: {
-            ObjString *name = frame_->readObjString();
-            Value value = NanBox::NilValue;
-            if (!chunk_->globals_->get(NanBox::fromObj(name), value)) {
-                if (!built_in_->get(NanBox::fromObj(name), value)) {
-                    String msg = format("Undefined variable '{}'.", name->c_str());
-                    throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
-                    break;
-                }
+        VM_CASE(LOAD_GLOBAL): {
+            // 内置函数在创建槽位时已预先绑定，未定义的槽位保存 k_undefined
+            uint16_t slot = VM_READ_WORD();
+            Value value = chunk_->globals_->value(slot);
+            if (value == GlobalTable::k_undefined) {
+                VM_SAVE_STATE();
+                String msg = format("Undefined variable '{}'.", chunk_->globals_->name(slot)->c_str());
+                throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
+                VM_RELOAD_AND_NEXT();
             }
-            stack_.push(value);
-            break;
+            VM_PUSH(value);
+            VM_NEXT();
         }
-        case opCode::STORE_GLOBAL: {
-            ObjString *name = frame_->readObjString();
-            if (chunk_->globals_->insert(NanBox::fromObj(name), stack_.peek())) {
-                chunk_->globals_->remove(NanBox::fromObj(name));
-                String msg = format("Undefined variable '{}'.", name->c_str());
+        VM_CASE(STORE_GLOBAL): {
+            uint16_t slot = VM_READ_WORD();
+            if (!chunk_->globals_->is_defined(slot)) {
+                VM_SAVE_STATE();
+                String msg = format("Undefined variable '{}'.", chunk_->globals_->name(slot)->c_str());
                 throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
-                break;
+                VM_RELOAD_AND_NEXT();
             }
-            break;
+            chunk_->globals_->value(slot) = VM_PEEK(0);
+            VM_NEXT();
         }
-        case opCode::LOAD_FIELD: {
-            if (!NanBox::isObj(stack_.peek())) {
-                throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, "Only objects have fields.");
-                break;
-            }
-            Obj *obj = NanBox::toObj(stack_.peek());
-            ObjString *name = frame_->readObjString();
-            Value value;
-
-            if (auto result = obj->get_by_field(name, value); NanBox::isFalse(result)) {
-                String msg = format(
-                    "this {} object does no have attribute {}.",
-                    obj->representation(),
-                    name->c_str());
-                throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, msg);
-                break;
+        VM_CASE(LOAD_FIELD): {
+            // 内联缓存命中：一次 shape 比较加一次下标读取
+            if (is_obj_instance(VM_PEEK(0))) {
+                ObjInstance *instance = as_obj_instance(VM_PEEK(0));
+                const FieldCache &cache = chunk_->field_caches_[VM_WORD_AT(2)];
+                if (instance->shape_ == cache.shape) {
+                    sp[-1] = instance->slots_[cache.slot];
+                    ip += 4;
+                    VM_NEXT();
+                }
             }
-            stack_.set_top_val(value);
-            break;
+            ObjString *name = as_obj_string(VM_READ_CONSTANT());
+            FieldCache *cache = &chunk_->field_caches_[VM_READ_WORD()];
+            VM_SAVE_STATE();
+            load_field(name, cache);
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::STORE_FIELD: {
-            if (!NanBox::isObj(stack_.peek())) {
-                throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, "Only objects have fields.");
-                break;
-            }
-            Obj *obj = NanBox::toObj(stack_.pop());
-            ObjString *propertyName = frame_->readObjString();
-
-            if (auto result = obj->set_by_field(propertyName, stack_.peek());
-                NanBox::isFalse(result)) {
-                String msg = format(
-                    "this {} object does no support store field operation.",
-                    value_type_string(stack_.peek()));
-                throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, msg);
-                break;
+        VM_CASE(STORE_FIELD): {
+            if (is_obj_instance(VM_PEEK(0))) {
+                ObjInstance *instance = as_obj_instance(VM_PEEK(0));
+                const FieldCache &cache = chunk_->field_caches_[VM_WORD_AT(2)];
+                if (instance->shape_ == cache.shape
+                    && (cache.transition == nullptr || cache.slot < instance->slot_capacity_)) {
+                    instance->slots_[cache.slot] = VM_PEEK(1);
+                    if (cache.transition != nullptr) {
+                        instance->shape_ = cache.transition;
+                    }
+                    sp--;
+                    ip += 4;
+                    VM_NEXT();
+                }
             }
-            break;
+            ObjString *name = as_obj_string(VM_READ_CONSTANT());
+            FieldCache *cache = &chunk_->field_caches_[VM_READ_WORD()];
+            VM_SAVE_STATE();
+            store_field(name, cache);
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::LOAD_SUBSCR: {
+        VM_CASE(LOAD_SUBSCR): {
+        vm_generic_LOAD_SUBSCR:
+            // 列表配范围内的 int 下标时直接读取元素，不经过虚函数 get_by_index
+            if (is_obj_list(VM_PEEK(1)) && NanBox::isInt(VM_PEEK(0))) {
+                const ValueArray &list = as_obj_list(VM_PEEK(1))->list_;
+                const auto index = static_cast<uint32_t>(NanBox::toInt(VM_PEEK(0)));
+                if (index < list.size()) {
+                    sp[-2] = list[index];
+                    sp--;
+                    VM_NEXT();
+                }
+            }
+            VM_SAVE_STATE();
             if (!NanBox::isObj(stack_.peek(1))) {
                 throw_exception(
                     ErrorCode::RUNTIME_INVALID_INDEX_OP, "Only objects support index operation.");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             Obj *obj = NanBox::toObj(stack_.peek(1));
             Value index = stack_.peek();
@@ -654,25 +1497,36 @@ Value AriaVM::run(int retFrame)
                     value_type_string(NanBox::fromObj(obj)),
                     value_string(index));
                 throw_exception(ErrorCode::RUNTIME_INVALID_INDEX_OP, msg);
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             if (get_err_flag()) {
                 if (!is_obj_exception(result)) {
                     report_runtime_fatal_error(ErrorCode::INTERNAL_UNKNOWN, "Invalid return value");
                 }
                 throw_exception(as_obj_exception(result));
-                break;
+                VM_RELOAD_AND_NEXT();
             }
 
             stack_.pop_n(2);
             stack_.push(value);
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::STORE_SUBSCR: {
+        VM_CASE(STORE_SUBSCR): {
+            // 与 LOAD_SUBSCR 相同的列表快速路径；赋值表达式的值留在栈上
+            if (is_obj_list(VM_PEEK(1)) && NanBox::isInt(VM_PEEK(0))) {
+                ValueArray &list = as_obj_list(VM_PEEK(1))->list_;
+                const auto index = static_cast<uint32_t>(NanBox::toInt(VM_PEEK(0)));
+                if (index < list.size()) {
+                    list[index] = VM_PEEK(2);
+                    sp -= 2;
+                    VM_NEXT();
+                }
+            }
+            VM_SAVE_STATE();
             if (!NanBox::isObj(stack_.peek(1))) {
                 throw_exception(
                     ErrorCode::RUNTIME_INVALID_INDEX_OP, "Only objects support index operation.");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             Value index = stack_.peek();
             Obj *obj = NanBox::toObj(stack_.peek(1));
@@ -686,50 +1540,56 @@ Value AriaVM::run(int retFrame)
                     value_type_string(NanBox::fromObj(obj)),
                     value_string(index));
                 throw_exception(ErrorCode::RUNTIME_INVALID_INDEX_OP, msg);
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             if (get_err_flag()) {
                 if (!is_obj_exception(result)) {
                     report_runtime_fatal_error(ErrorCode::RUNTIME_UNKNOWN, "Invalid return value");
                 }
                 throw_exception(as_obj_exception(result));
-                break;
+                VM_RELOAD_AND_NEXT();
             }
 
             stack_.pop_n(2);
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::EQUAL: {
-            Value b = stack_.pop();
-            Value a = stack_.pop();
-            stack_.push(NanBox::fromBool(values_same(a, b)));
-            break;
+        VM_CASE(EQUAL): {
+            Value b = VM_POP();
+            Value a = VM_POP();
+            VM_PUSH(NanBox::fromBool(values_same(a, b)));
+            VM_NEXT();
         }
-        case opCode::NOT_EQUAL: {
-            Value b = stack_.pop();
-            Value a = stack_.pop();
-            stack_.push(NanBox::fromBool(!values_same(a, b)));
-            break;
+        VM_CASE(NOT_EQUAL): {
+            Value b = VM_POP();
+            Value a = VM_POP();
+            VM_PUSH(NanBox::fromBool(!values_same(a, b)));
+            VM_NEXT();
         }
-        case opCode::GREATER:
-            numeric_bin_op<NumericBinOp::GT>();
-            break;
-        case opCode::GREATER_EQUAL:
-            numeric_bin_op<NumericBinOp::GE>();
-            break;
-        case opCode::LESS:
-            numeric_bin_op<NumericBinOp::LT>();
-            break;
-        case opCode::LESS_EQUAL:
-            numeric_bin_op<NumericBinOp::LE>();
-            break;
-        case opCode::ADD: {
-            if (NanBox::isNumber(stack_.peek()) && NanBox::isNumber(stack_.peek(1))) {
-                double b = NanBox::toNumber(stack_.pop());
-                double a = NanBox::toNumber(stack_.pop());
-                stack_.push(NanBox::fromNumber(a + b));
-                break;
+        VM_CASE(GREATER): {
+        vm_generic_GREATER:
+            VM_NUMERIC_BIN_OP(NumericBinOp::GT, GREATER, NanBox::fromBool(NanBox::greater(a, b)));
+        }
+        VM_CASE(GREATER_EQUAL): {
+        vm_generic_GREATER_EQUAL:
+            VM_NUMERIC_BIN_OP(NumericBinOp::GE, GREATER_EQUAL, NanBox::fromBool(NanBox::greaterEqual(a, b)));
+        }
+        VM_CASE(LESS): {
+        vm_generic_LESS:
+            VM_NUMERIC_BIN_OP(NumericBinOp::LT, LESS, NanBox::fromBool(NanBox::less(a, b)));
+        }
+        VM_CASE(LESS_EQUAL): {
+        vm_generic_LESS_EQUAL:
+            VM_NUMERIC_BIN_OP(NumericBinOp::LE, LESS_EQUAL, NanBox::fromBool(NanBox::lessEqual(a, b)));
+        }
+        VM_CASE(ADD): {
+        vm_generic_ADD:
+            if (NanBox::isNumbers(VM_PEEK(0), VM_PEEK(1))) {
+                VM_QUICKEN(ADD, ADD_NUM);
+                sp[-2] = NanBox::add(sp[-2], sp[-1]);
+                sp--;
+                VM_NEXT();
             }
+            VM_SAVE_STATE();
             if (is_obj_string(stack_.peek()) && is_obj_string(stack_.peek(1))) {
                 ObjString *b = as_obj_string(stack_.peek(0));
                 ObjString *a = as_obj_string(stack_.peek(1));
@@ -741,176 +1601,227 @@ Value AriaVM::run(int retFrame)
                 }
                 stack_.pop_n(2);
                 stack_.push(NanBox::fromObj(result));
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Operands must be numbers or strings.");
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::SUBTRACT:
-            numeric_bin_op<NumericBinOp::SUB>();
-            break;
-        case opCode::MULTIPLY:
-            numeric_bin_op<NumericBinOp::MUL>();
-            break;
-        case opCode::DIVIDE:
-            numeric_bin_op<NumericBinOp::DIV>();
-            break;
-        case opCode::MOD:
-            numeric_bin_op<NumericBinOp::MOD>();
-            break;
-        case opCode::NOT:
-            stack_.push(NanBox::fromBool(is_falsey(stack_.pop())));
-            break;
-        case opCode::NEGATE: {
-            if (!NanBox::isNumber(stack_.peek())) {
+        VM_CASE(SUBTRACT): {
+        vm_generic_SUBTRACT:
+            VM_NUMERIC_BIN_OP(NumericBinOp::SUB, SUBTRACT, NanBox::sub(a, b));
+        }
+        VM_CASE(MULTIPLY): {
+        vm_generic_MULTIPLY:
+            VM_NUMERIC_BIN_OP(NumericBinOp::MUL, MULTIPLY, NanBox::mul(a, b));
+        }
+        VM_CASE(DIVIDE): {
+        vm_generic_DIVIDE:
+            VM_NUMERIC_BIN_OP(NumericBinOp::DIV, DIVIDE, NanBox::div(a, b));
+        }
+        VM_CASE(MOD): {
+        vm_generic_MOD:
+            VM_NUMERIC_BIN_OP(NumericBinOp::MOD, MOD, NanBox::mod(a, b));
+        }
+        VM_CASE(NOT): {
+            sp[-1] = NanBox::fromBool(is_falsey(sp[-1]));
+            VM_NEXT();
+        }
+        VM_CASE(NEGATE): {
+            if (!NanBox::isNumber(VM_PEEK(0))) {
+                VM_SAVE_STATE();
                 throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Operand must be number.");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
-            stack_.push(NanBox::fromNumber(-NanBox::toNumber(stack_.pop())));
-            break;
+            sp[-1] = NanBox::negate(sp[-1]);
+            VM_NEXT();
         }
-        case opCode::POP:
-            stack_.pop();
-            break;
-        case opCode::POP_N:
-            stack_.pop_n(frame_->readByte());
-            break;
-        case opCode::PRINT:
-            std::cout << value_string(stack_.pop()) << std::endl;
-            break;
-        case opCode::NOP:
-            break;
-        case opCode::JUMP_FWD: {
-            const uint16_t offset = frame_->readWord();
-            frame_->ip -= offset;
-            break;
+        VM_CASE(POP): {
+            sp--;
+            VM_NEXT();
         }
-        case opCode::JUMP_BWD: {
-            const uint16_t offset = frame_->readWord();
-            frame_->ip += offset;
-            break;
+        VM_CASE(POP_N): {
+            sp -= VM_READ_BYTE();
+            VM_NEXT();
         }
-        case opCode::JUMP_TRUE: {
-            const uint16_t offset = frame_->readWord();
-            if (!is_falsey(stack_.pop()))
-                frame_->ip += offset;
-            break;
+        VM_CASE(PRINT): {
+            VM_SAVE_STATE();
+            write_value(stack_.pop(), output_);
+            output_.end_line();
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::JUMP_TRUE_NOPOP: {
-            const uint16_t offset = frame_->readWord();
-            if (!is_falsey(stack_.peek(0)))
-                frame_->ip += offset;
-            break;
+        VM_CASE(NOP): {
+            VM_NEXT();
         }
-        case opCode::JUMP_FALSE: {
-            const uint16_t offset = frame_->readWord();
-            if (is_falsey(stack_.pop()))
-                frame_->ip += offset;
-            break;
+        VM_CASE(JUMP_FWD): {
+            const uint16_t offset = VM_READ_WORD();
+            ip -= offset;
+            VM_LOOP_BACK_EDGE();
+            VM_NEXT();
         }
-        case opCode::JUMP_FALSE_NOPOP: {
-            const uint16_t offset = frame_->readWord();
-            if (is_falsey(stack_.peek(0)))
-                frame_->ip += offset;
-            break;
+        VM_CASE(JUMP_BWD): {
+            const uint16_t offset = VM_READ_WORD();
+            ip += offset;
+            VM_NEXT();
+        }
+        VM_CASE(JUMP_TRUE): {
+            const uint16_t offset = VM_READ_WORD();
+            if (!is_falsey(VM_POP()))
+                ip += offset;
+            VM_NEXT();
+        }
+        VM_CASE(JUMP_TRUE_NOPOP): {
+            const uint16_t offset = VM_READ_WORD();
+            if (!is_falsey(VM_PEEK(0)))
+                ip += offset;
+            VM_NEXT();
         }
-        case opCode::CALL: {
-            int argCount = frame_->readByte();
-            auto callee = stack_.peek(argCount);
-            auto result = call_value(callee, argCount);
+        VM_CASE(JUMP_FALSE): {
+            const uint16_t offset = VM_READ_WORD();
+            if (is_falsey(VM_POP()))
+                ip += offset;
+            VM_NEXT();
+        }
+        VM_CASE(JUMP_FALSE_NOPOP): {
+            const uint16_t offset = VM_READ_WORD();
+            if (is_falsey(VM_PEEK(0)))
+                ip += offset;
+            VM_NEXT();
+        }
+        VM_CASE(CALL): {
+        vm_generic_CALL:
+            const int argCount = VM_READ_BYTE();
+            CallCache *cache = &chunk_->call_caches_[VM_READ_WORD()];
+            auto callee = VM_PEEK(argCount);
+            VM_SAVE_STATE();
+            auto result = call_value_cached(callee, argCount, cache);
             if (get_err_flag()) {
                 if (!is_obj_exception(result)) {
                     report_runtime_fatal_error(ErrorCode::RUNTIME_UNKNOWN, "Invalid return value");
                 }
                 throw_exception(as_obj_exception(result));
             }
-            break;
+#if VM_JIT
+            // 新压入的栈帧：ip 位于函数开头
+            else if (frame_->ip == chunk_->codes_ && VM_JIT_HOT(frame_->function)) {
+                if (Jit::run(this, 0, result)) {
+                    stack_.push(result);
+                }
+            }
+#endif
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::CLOSURE: {
+        VM_CASE(CLOSURE): {
+            VM_SAVE_STATE();
             ObjFunction *fun = as_obj_function(frame_->readConstant());
-            for (int i = 0; i < fun->upvalue_count_; i++) {
+            // 闭包先入栈，捕获 upvalue 时分配的对象不会回收它
+            ObjClosure *closure = new_ObjClosure(fun, gc_);
+            stack_.push(NanBox::fromObj(closure));
+            for (int i = 0; i < closure->upvalue_count_; i++) {
                 uint8_t isLocal = frame_->readByte();
                 uint16_t index = frame_->readWord();
                 if (isLocal) {
-                    fun->upvalues_[i] = capture_upvalue(frame_->stakBase + index);
+                    closure->upvalues_[i] = capture_upvalue(frame_->stakBase + index);
                 } else {
-                    fun->upvalues_[i] = frame_->function->upvalues_[index];
+                    closure->upvalues_[i] = frame_->closure->upvalues_[index];
                 }
             }
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::MAKE_CLASS: {
+        VM_CASE(MAKE_CLASS): {
+            VM_SAVE_STATE();
             ObjClass *klass = new_ObjClass(frame_->readObjString(), gc_);
             stack_.push(NanBox::fromObj(klass));
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::INHERIT: {
+        VM_CASE(INHERIT): {
+            VM_SAVE_STATE();
             if (!is_obj_class(stack_.peek())) {
                 throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Superclass must be a class.");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             ObjClass *superKlass = as_obj_class(stack_.pop());
             ObjClass *klass = as_obj_class(stack_.peek());
             klass->super_klass_ = superKlass;
             klass->methods_.copy(&superKlass->methods_);
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::MAKE_METHOD: {
+        VM_CASE(MAKE_METHOD): {
+            VM_SAVE_STATE();
             Value methodName = NanBox::fromObj(frame_->readObjString());
             Value method = stack_.peek(0);
             ObjClass *klass = as_obj_class(stack_.peek(1));
-            as_obj_function(method)->enclosing_class_ = klass;
+            // 使用 super 的方法总是闭包，每次执行类声明都是新创建的，原型保持不变
+            if (is_obj_closure(method)) {
+                as_obj_closure(method)->enclosing_class_ = klass;
+            }
             klass->methods_.insert(methodName, method);
             stack_.pop();
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::MAKE_INIT_METHOD: {
-            Value method = stack_.pop();
-            ObjClass *klass = as_obj_class(stack_.peek());
-            as_obj_function(method)->enclosing_class_ = klass;
-            klass->init_method_ = as_obj_function(method);
-            break;
+        VM_CASE(MAKE_INIT_METHOD): {
+            Value method = VM_POP();
+            ObjClass *klass = as_obj_class(VM_PEEK(0));
+            if (is_obj_closure(method)) {
+                as_obj_closure(method)->enclosing_class_ = klass;
+            }
+            klass->init_method_ = NanBox::toObj(method);
+            VM_NEXT();
         }
-        case opCode::INVOKE_METHOD: {
-            error("Invoke_method not implemented");
-            exit(1);
+        VM_CASE(INVOKE_METHOD): {
+            ObjString *name = as_obj_string(VM_READ_CONSTANT());
+            int argCount = VM_READ_BYTE();
+            MethodCache *cache = &chunk_->method_caches_[VM_READ_WORD()];
+            VM_SAVE_STATE();
+            auto result = invoke_method(name, argCount, cache);
+            if (get_err_flag()) {
+                if (!is_obj_exception(result)) {
+                    report_runtime_fatal_error(ErrorCode::RUNTIME_UNKNOWN, "Invalid return value");
+                }
+                throw_exception(as_obj_exception(result));
+            }
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::LOAD_SUPER_METHOD: {
+        VM_CASE(LOAD_SUPER_METHOD): {
+            VM_SAVE_STATE();
             ObjString *methodName = frame_->readObjString();
             ObjInstance *instance = as_obj_instance(stack_.peek());
-            ObjClass *klass = frame_->function->enclosing_class_;
+            // 使用 super 的方法总以闭包调用
+            ObjClass *klass = frame_->closure->enclosing_class_;
             Value superMethod = NanBox::NilValue;
             if (auto result = instance->getSuperMethod(klass, methodName, superMethod);
                 NanBox::isFalse(result)) {
                 String msg = format("Superclass has no method '{}", methodName->to_string());
                 throw_exception(ErrorCode::RUNTIME_INVALID_FIELD_OP, msg);
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             stack_.set_top_val(superMethod);
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::MAKE_LIST: {
+        VM_CASE(MAKE_LIST): {
+            VM_SAVE_STATE();
             int listSize = frame_->readWord();
             ObjList *list = new_ObjList(stack_.get_top_ptr() - listSize, listSize, gc_);
             stack_.pop_n(listSize);
             stack_.push(NanBox::fromObj(list));
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::MAKE_MAP: {
+        VM_CASE(MAKE_MAP): {
+            VM_SAVE_STATE();
             int mapSize = frame_->readWord();
             ObjMap *map = new_ObjMap(stack_.get_top_ptr() - mapSize * 2, mapSize, gc_);
             stack_.pop_n(mapSize * 2);
             stack_.push(NanBox::fromObj(map));
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::IMPORT: {
+        VM_CASE(IMPORT): {
+            VM_SAVE_STATE();
             ObjString *moduleName = frame_->readObjString();
             const char *currentModuleName = as_c_string(*current_rmodule());
             String absoluteModulePath;
             absoluteModulePath = get_absolute_module_path(currentModuleName, moduleName->c_str());
             if (absoluteModulePath.empty()) {
                 throw_exception(ErrorCode::RUNTIME_MODULE_INIT_ERROR, "Invalid module path.");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
 #ifdef DEBUG_MODE
             println("Importing module {}", absoluteModulePath);
@@ -918,82 +1829,77 @@ Value AriaVM::run(int retFrame)
             if (is_module_running(absoluteModulePath)) {
                 throw_exception(
                     ErrorCode::RUNTIME_MODULE_INIT_ERROR, "Circular module import detected.");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
 
             ObjString *path = new_ObjString(absoluteModulePath, gc_);
             if (auto module = get_cached_module(path)) {
                 module->name_ = moduleName;
                 stack_.push(NanBox::fromObj(module));
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             if (auto moduleFn = load_module(absoluteModulePath, moduleName)) {
                 stack_.push(NanBox::fromObj(moduleFn));
                 call_module(moduleFn);
-                break;
+                VM_RELOAD_AND_NEXT();
             }
             throw_exception(ErrorCode::RUNTIME_MODULE_INIT_ERROR, "Import module error.");
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::GET_ITER: {
+        VM_CASE(GET_ITER): {
+        vm_generic_GET_ITER:
+            VM_SAVE_STATE();
             if (!NanBox::isObj(stack_.peek())) {
                 throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Expected an iterable object");
-                break;
-            }
-            Value iter = NanBox::toObj(stack_.peek())->create_iter(gc_);
-            if (NanBox::isNil(iter)) {
-                throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Expected iterable object");
-                break;
+                VM_RELOAD_AND_NEXT();
             }
-            stack_.set_top_val(iter);
-            break;
-        }
-        case opCode::ITER_HAS_NEXT: {
-            if (!is_obj_iterator(stack_.peek())) {
-                throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Expected an iterator object");
-                break;
+            // 列表、字符串、映射和迭代器对象由 FOR_ITER 按游标直接遍历，其余对象换成它们的迭代器
+            Value iterable = stack_.peek();
+            if (!is_obj_list(iterable) && !is_obj_string(iterable) && !is_obj_map(iterable)
+                && !is_obj_iterator(iterable)) {
+                Value iter = NanBox::toObj(iterable)->create_iter(gc_);
+                if (NanBox::isNil(iter)) {
+                    throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Expected iterable object");
+                    VM_RELOAD_AND_NEXT();
+                }
+                stack_.set_top_val(iter);
             }
-            ObjIterator *iterator = as_obj_iterator(stack_.peek());
-            Value result = NanBox::fromBool(iterator->iter_->hasNext());
-            stack_.set_top_val(result);
-            break;
+            stack_.push(NanBox::fromInt(0));
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::ITER_GET_NEXT: {
-            if (!is_obj_iterator(stack_.peek())) {
-                throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Expected an iterator object");
-                break;
+        VM_CASE(FOR_ITER): {
+            // slots[slot] 是被遍历的对象，slots[slot + 1] 是游标；
+            // 取到下一个值时写入 slots[slot + 2]（循环变量）并跳回循环体开头
+            Value *iter = slots + VM_READ_WORD();
+            const uint16_t offset = VM_READ_WORD();
+            if (is_obj_list(iter[0])) {
+                const ValueArray &list = as_obj_list(iter[0])->list_;
+                const int32_t cursor = NanBox::toInt(iter[1]);
+                if (static_cast<uint32_t>(cursor) < list.size()) {
+                    iter[1] = NanBox::fromInt(cursor + 1);
+                    iter[2] = list[cursor];
+                    ip -= offset;
+                }
+                VM_NEXT();
             }
-            ObjIterator *iterator = as_obj_iterator(stack_.peek());
-            Value nextVal = iterator->iter_->next();
-            stack_.pop();
-            stack_.push(nextVal);
-            break;
-        }
-        case opCode::SETUP_EXCEPT: {
-            uint16_t offset = frame_->readWord();
-            uint8_t *newIp = frame_->ip + offset;
-            if (e_frame_count_ == k_frame_size) {
-                report_runtime_fatal_error(
-                    ErrorCode::RUNTIME_STACK_OVERFLOW, "Exception Stack overflow.");
+            VM_SAVE_STATE();
+            if (iterate_next(iter)) {
+                ip -= offset;
             }
-            push_exception_frame(c_frame_count_, r_module_count_, newIp, stack_.size());
-            break;
+            VM_NEXT();
         }
-        case opCode::END_EXCEPT: {
-            pop_exception_frame();
-            break;
-        }
-        case opCode::THROW: {
+        VM_CASE(THROW): {
+            VM_SAVE_STATE();
             set_err_flag();
             e_reg_ = stack_.pop();
-            if (e_frame_count_ == 0) {
+            if (!unwind_to_catch_point()) {
                 report_runtime_fatal_error(
                     ErrorCode::RUNTIME_UNCAUGHT_EXCEPTION, value_string(e_reg_).c_str());
             }
-            unwind_to_catch_point();
-            break;
+            VM_RELOAD_AND_NEXT();
         }
-        case opCode::RETURN: {
+        VM_CASE(RETURN): {
+            VM_SAVE_STATE();
             Value result = stack_.pop();
             stack_.resize(static_cast<uint32_t>(frame_->stakBase - stack_.base()));
             result = return_from_current_frame(result);
@@ -1001,39 +1907,541 @@ Value AriaVM::run(int retFrame)
                 return result;
             }
             stack_.push(result);
-            break;
+            if (frame_->function->frame_size_ != 0) {
+                restore_register_frame();
+            }
+            VM_RELOAD_AND_NEXT();
         }
-        default:
+        VM_CASE(INC_LOCAL): {
+            // LOAD_LOCAL a; LOAD_CONST k; ADD|SUBTRACT; STORE_LOCAL a; POP
+            Value value = slots[VM_WORD_AT(0)];
+            Value step = consts[VM_WORD_AT(3)];
+            VM_NUMERIC_DISPATCH(value, step, {
+                slots[VM_WORD_AT(0)] = generic_opcode(static_cast<opCode>(ip[5])) == opCode::ADD
+                                           ? NanBox::add(value, step)
+                                           : NanBox::sub(value, step);
+                ip += 10;
+                VM_NEXT();
+            });
+            // 守卫失败：只执行 LOAD_LOCAL，后续原始指令照常执行
+            ip += 2;
+            VM_PUSH(value);
+            VM_NEXT();
+        }
+        VM_CASE(LOCAL_LOCAL_CMP_JUMP):
+        VM_CASE(LOCAL_CONST_CMP_JUMP): {
+            // LOAD_LOCAL a; LOAD_LOCAL b | LOAD_CONST k; compare; JUMP_FALSE
+            Value lhs = slots[VM_WORD_AT(0)];
+            Value rhs = static_cast<opCode>(ip[2]) == opCode::LOAD_LOCAL ? slots[VM_WORD_AT(3)]
+                                                                          : consts[VM_WORD_AT(3)];
+            VM_NUMERIC_DISPATCH(lhs, rhs, {
+                const bool result = compare_numbers(static_cast<opCode>(ip[5]), lhs, rhs);
+                const uint16_t offset = VM_WORD_AT(7);
+                ip += 9;
+                if (!result) {
+                    ip += offset;
+                }
+                VM_NEXT();
+            });
+            ip += 2;
+            VM_PUSH(lhs);
+            VM_NEXT();
+        }
+        VM_CASE(FOR_RANGE): {
+            // LOAD_LOCAL a; LOAD_CONST k; ADD|SUBTRACT; STORE_LOCAL a; POP;
+            // LOAD_LOCAL a; LOAD_LOCAL b | LOAD_CONST c; compare; JUMP_FALSE exit; JUMP_FWD body
+            Value value = slots[VM_WORD_AT(0)];
+            Value step = consts[VM_WORD_AT(3)];
+            VM_NUMERIC_DISPATCH(value, step, {
+                value = generic_opcode(static_cast<opCode>(ip[5])) == opCode::ADD
+                            ? NanBox::add(value, step)
+                            : NanBox::sub(value, step);
+                slots[VM_WORD_AT(0)] = value;
+                Value limit = static_cast<opCode>(ip[13]) == opCode::LOAD_LOCAL
+                                  ? slots[VM_WORD_AT(14)]
+                                  : consts[VM_WORD_AT(14)];
+                if (!NanBox::isNumber(limit)) {
+                    // 比较的守卫失败：自增已完成，从比较序列的 LOAD_LOCAL 之后继续
+                    ip += 13;
+                    VM_PUSH(value);
+                    VM_NEXT();
+                }
+                if (!compare_numbers(static_cast<opCode>(ip[16]), value, limit)) {
+                    ip += 23;
+                    VM_NEXT();
+                }
+                ip += 23 - VM_WORD_AT(21);
+                VM_LOOP_BACK_EDGE();
+                VM_NEXT();
+            });
+            ip += 2;
+            VM_PUSH(value);
+            VM_NEXT();
+        }
+        VM_CASE(LOAD_LOCAL_FIELD): {
+            // LOAD_LOCAL a; LOAD_FIELD name cache
+            Value receiver = slots[VM_WORD_AT(0)];
+            FieldCache *cache = &chunk_->field_caches_[VM_WORD_AT(5)];
+            if (is_obj_instance(receiver)) {
+                ObjInstance *instance = as_obj_instance(receiver);
+                if (instance->shape_ == cache->shape) {
+                    VM_PUSH(instance->slots_[cache->slot]);
+                    ip += 7;
+                    VM_NEXT();
+                }
+            }
+            VM_PUSH(receiver);
+            ObjString *name = as_obj_string(consts[VM_WORD_AT(3)]);
+            ip += 7;
+            VM_SAVE_STATE();
+            load_field(name, cache);
+            VM_RELOAD_AND_NEXT();
+        }
+        VM_CASE(ADD_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::ADD, ADD, NanBox::add(a, b));
+        }
+        VM_CASE(SUBTRACT_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::SUB, SUBTRACT, NanBox::sub(a, b));
+        }
+        VM_CASE(MULTIPLY_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::MUL, MULTIPLY, NanBox::mul(a, b));
+        }
+        VM_CASE(DIVIDE_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::DIV, DIVIDE, NanBox::div(a, b));
+        }
+        VM_CASE(MOD_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::MOD, MOD, NanBox::mod(a, b));
+        }
+        VM_CASE(GREATER_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::GT, GREATER, NanBox::fromBool(NanBox::greater(a, b)));
+        }
+        VM_CASE(GREATER_EQUAL_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::GE, GREATER_EQUAL, NanBox::fromBool(NanBox::greaterEqual(a, b)));
+        }
+        VM_CASE(LESS_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::LT, LESS, NanBox::fromBool(NanBox::less(a, b)));
+        }
+        VM_CASE(LESS_EQUAL_NUM): {
+            VM_QUICK_NUMERIC_BIN_OP(NumericBinOp::LE, LESS_EQUAL, NanBox::fromBool(NanBox::lessEqual(a, b)));
+        }
+        VM_CASE(REG_MOVE): {
+            VM_REG(0) = VM_REG(1);
+            ip += 2;
+            VM_NEXT();
+        }
+        VM_CASE(REG_LOAD_GLOBAL): {
+            uint16_t slot = VM_WORD_AT(1);
+            Value value = chunk_->globals_->value(slot);
+            if (value == GlobalTable::k_undefined) {
+                ip += 3;
+                VM_SAVE_STATE();
+                String msg = format("Undefined variable '{}'.", chunk_->globals_->name(slot)->c_str());
+                throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
+                VM_RELOAD_AND_NEXT();
+            }
+            VM_REG(0) = value;
+            ip += 3;
+            VM_NEXT();
+        }
+        VM_CASE(REG_STORE_GLOBAL): {
+            uint16_t slot = VM_WORD_AT(1);
+            if (!chunk_->globals_->is_defined(slot)) {
+                ip += 3;
+                VM_SAVE_STATE();
+                String msg = format("Undefined variable '{}'.", chunk_->globals_->name(slot)->c_str());
+                throw_exception(ErrorCode::RUNTIME_UNDEFINED_VARIABLE, msg);
+                VM_RELOAD_AND_NEXT();
+            }
+            chunk_->globals_->value(slot) = VM_REG(0);
+            ip += 3;
+            VM_NEXT();
+        }
+        VM_CASE(REG_ADD): {
+            Value a = VM_REG(1);
+            Value b = VM_REG(2);
+            VM_NUMERIC_DISPATCH(a, b, {
+                VM_REG(0) = NanBox::add(a, b);
+                ip += 3;
+                VM_NEXT();
+            });
+            Value *dst = &VM_REG(0);
+            ip += 3;
+            VM_SAVE_STATE();
+            stack_.push(a);
+            stack_.push(b);
+            if (add_objects()) {
+                *dst = stack_.pop();
+            }
+            VM_RELOAD_AND_NEXT();
+        }
+        VM_CASE(REG_SUBTRACT): {
+            VM_REGISTER_BIN_OP(NumericBinOp::SUB, NanBox::sub(a, b));
+        }
+        VM_CASE(REG_MULTIPLY): {
+            VM_REGISTER_BIN_OP(NumericBinOp::MUL, NanBox::mul(a, b));
+        }
+        VM_CASE(REG_DIVIDE): {
+            VM_REGISTER_BIN_OP(NumericBinOp::DIV, NanBox::div(a, b));
+        }
+        VM_CASE(REG_MOD): {
+            VM_REGISTER_BIN_OP(NumericBinOp::MOD, NanBox::mod(a, b));
+        }
+        VM_CASE(REG_EQUAL): {
+            VM_REG(0) = NanBox::fromBool(values_same(VM_REG(1), VM_REG(2)));
+            ip += 3;
+            VM_NEXT();
+        }
+        VM_CASE(REG_NOT_EQUAL): {
+            VM_REG(0) = NanBox::fromBool(!values_same(VM_REG(1), VM_REG(2)));
+            ip += 3;
+            VM_NEXT();
+        }
+        VM_CASE(REG_GREATER): {
+            VM_REGISTER_BIN_OP(NumericBinOp::GT, NanBox::fromBool(NanBox::greater(a, b)));
+        }
+        VM_CASE(REG_GREATER_EQUAL): {
+            VM_REGISTER_BIN_OP(NumericBinOp::GE, NanBox::fromBool(NanBox::greaterEqual(a, b)));
+        }
+        VM_CASE(REG_LESS): {
+            VM_REGISTER_BIN_OP(NumericBinOp::LT, NanBox::fromBool(NanBox::less(a, b)));
+        }
+        VM_CASE(REG_LESS_EQUAL): {
+            VM_REGISTER_BIN_OP(NumericBinOp::LE, NanBox::fromBool(NanBox::lessEqual(a, b)));
+        }
+        VM_CASE(REG_NOT): {
+            VM_REG(0) = NanBox::fromBool(is_falsey(VM_REG(1)));
+            ip += 2;
+            VM_NEXT();
+        }
+        VM_CASE(REG_NEGATE): {
+            Value value = VM_REG(1);
+            if (!NanBox::isNumber(value)) {
+                ip += 2;
+                VM_SAVE_STATE();
+                throw_exception(ErrorCode::RUNTIME_TYPE_ERROR, "Operand must be number.");
+                VM_RELOAD_AND_NEXT();
+            }
+            VM_REG(0) = NanBox::negate(value);
+            ip += 2;
+            VM_NEXT();
+        }
+        VM_CASE(REG_JUMP_TRUE): {
+            const bool truthy = !is_falsey(VM_REG(0));
+            const uint16_t offset = VM_WORD_AT(1);
+            ip += 3;
+            if (truthy) {
+                ip += offset;
+            }
+            VM_NEXT();
+        }
+        VM_CASE(REG_JUMP_FALSE): {
+            const bool falsey = is_falsey(VM_REG(0));
+            const uint16_t offset = VM_WORD_AT(1);
+            ip += 3;
+            if (falsey) {
+                ip += offset;
+            }
+            VM_NEXT();
+        }
+        VM_CASE(REG_EQUAL_JUMP): {
+            // 两个 int32 相等当且仅当编码相同
+            VM_REGISTER_CMP_JUMP(NanBox::isInts(a, b) ? a == b : values_same(a, b));
+        }
+        VM_CASE(REG_NOT_EQUAL_JUMP): {
+            VM_REGISTER_CMP_JUMP(NanBox::isInts(a, b) ? a != b : !values_same(a, b));
+        }
+        VM_CASE(REG_GREATER_JUMP): {
+            VM_REGISTER_ORDER_JUMP(NumericBinOp::GT, NanBox::greater(a, b));
+        }
+        VM_CASE(REG_GREATER_EQUAL_JUMP): {
+            VM_REGISTER_ORDER_JUMP(NumericBinOp::GE, NanBox::greaterEqual(a, b));
+        }
+        VM_CASE(REG_LESS_JUMP): {
+            VM_REGISTER_ORDER_JUMP(NumericBinOp::LT, NanBox::less(a, b));
+        }
+        VM_CASE(REG_LESS_EQUAL_JUMP): {
+            VM_REGISTER_ORDER_JUMP(NumericBinOp::LE, NanBox::lessEqual(a, b));
+        }
+        VM_CASE(REG_CALL): {
+            // 被调用者和参数在连续寄存器中，被调用函数的栈帧从 callee 所在寄存器开始，返回值写回该寄存器
+            Value *callee = &VM_REG(0);
+            const int argCount = ip[1];
+            ip += 2;
+            VM_SAVE_STATE();
+            stack_.set_top_ptr(callee + argCount + 1);
+            // 调用另一个寄存器函数：参数已经就位，直接建立栈帧
+            if (is_obj_function(*callee)) {
+                ObjFunction *function = as_obj_function(*callee);
+                if (function->frame_size_ != 0 && !function->accepts_varargs_
+                    && argCount == function->arity_ && c_frame_count_ < k_max_frames
+                    && reserve_stack(function->frame_size_ + k_stack_slack)) {
+                    // 值栈可能已经扩容，callee 按栈顶重新定位
+                    push_call_frame(
+                        function, function->chunk_->codes_, stack_.get_top_ptr() - argCount - 1);
+                    enter_register_frame();
+                    VM_RELOAD_AND_NEXT();
+                }
+            }
+            const int frameCount = c_frame_count_;
+            auto result = call_value(*callee, argCount);
+            if (get_err_flag()) {
+                if (!is_obj_exception(result)) {
+                    report_runtime_fatal_error(ErrorCode::RUNTIME_UNKNOWN, "Invalid return value");
+                }
+                throw_exception(as_obj_exception(result));
+            } else if (c_frame_count_ == frameCount) {
+                // 原生函数等同步完成的调用
+                restore_register_frame();
+            }
+            VM_RELOAD_AND_NEXT();
+        }
+        VM_CASE(REG_RETURN): {
+            Value result = VM_REG(0);
+            ip += 1;
+            VM_SAVE_STATE();
+            stack_.resize(static_cast<uint32_t>(frame_->stakBase - stack_.base()));
+            result = return_from_current_frame(result);
+            if (c_frame_count_ == retFrame) {
+                return result;
+            }
+            stack_.push(result);
+            if (frame_->function->frame_size_ != 0) {
+                restore_register_frame();
+            }
+            VM_RELOAD_AND_NEXT();
+        }
+        VM_CASE(REG_PRINT): {
+            Value value = VM_REG(0);
+            ip += 1;
+            VM_SAVE_STATE();
+            write_value(value, output_);
+            output_.end_line();
+            VM_RELOAD_AND_NEXT();
+        }
+        VM_CASE(TAIL_CALL): {
+            const int argCount = VM_READ_BYTE();
+            ip += 2;
+            VM_SAVE_STATE();
+            if (!tail_call(argCount)) {
+                // 原生函数、类等：按普通 CALL 执行（操作数格式相同），随后的 RETURN 返回其结果
+                ip -= 3;
+                goto vm_generic_CALL;
+            }
+#if VM_JIT
+            if (VM_JIT_HOT(frame_->function)) {
+                Value result;
+                if (Jit::run(this, 0, result)) {
+                    if (c_frame_count_ == retFrame) {
+                        return result;
+                    }
+                    stack_.push(result);
+                    if (frame_->function->frame_size_ != 0) {
+                        restore_register_frame();
+                    }
+                }
+            }
+#endif
+            VM_RELOAD_AND_NEXT();
+        }
+        VM_CASE(LOAD_REST): {
+            // 剩余参数用作值：先把 rest_args_ 中的多余参数生成列表，之后与 LOAD_LOCAL 相同
+            const uint16_t slot = VM_READ_WORD();
+            if (frame_->rest_count >= 0) {
+                VM_SAVE_STATE();
+                materialize_rest(frame_, slot);
+            }
+            VM_PUSH(slots[slot]);
+            VM_NEXT();
+        }
+        VM_CASE(LOAD_REST_ITEM): {
+            // rest[i]：下标在范围内时直接读取 rest_args_，否则生成列表后按 LOAD_LOCAL + LOAD_SUBSCR 执行
+            const uint16_t slot = VM_READ_WORD();
+            if (frame_->rest_count >= 0) {
+                int32_t index = -1;
+                if (NanBox::toInteger(VM_PEEK(0), index) && index >= 0
+                    && index < frame_->rest_count) {
+                    sp[-1] = rest_args_[frame_->rest_base + index];
+                    VM_NEXT();
+                }
+                VM_SAVE_STATE();
+                materialize_rest(frame_, slot);
+            }
+            const Value index = VM_POP();
+            VM_PUSH(slots[slot]);
+            VM_PUSH(index);
+            goto vm_generic_LOAD_SUBSCR;
+        }
+        VM_CASE(LOAD_REST_ITER): {
+            // for-in 遍历剩余参数：被遍历对象的槽位放剩余参数的槽位号，FOR_ITER 按游标读取 rest_args_；
+            // 已经生成列表时与 LOAD_LOCAL + GET_ITER 相同
+            const uint16_t slot = VM_READ_WORD();
+            if (frame_->rest_count >= 0) {
+                VM_PUSH(NanBox::fromInt(slot));
+                VM_PUSH(NanBox::fromInt(0));
+                VM_NEXT();
+            }
+            VM_PUSH(slots[slot]);
+            goto vm_generic_GET_ITER;
+        }
+        VM_CASE(BREAKPOINT): {
+            if constexpr (Mode == DispatchMode::DEBUG) {
+                // 调试器恢复原指令字节并暂停，之后照常分发原指令，执行完后再补回断点
+                ip--;
+                VM_SAVE_STATE();
+                debugger_->hookBreakpoint(frame_, static_cast<uint32_t>(ip - chunk_->codes_));
+                VM_RELOAD_AND_NEXT();
+            }
+            VM_SAVE_STATE();
+            report_runtime_fatal_error(
+                ErrorCode::RUNTIME_INVALID_INSTRUCTION, "Breakpoint without a debugger.");
+        }
+        VM_DEFAULT: {
+            VM_SAVE_STATE();
             report_runtime_fatal_error(ErrorCode::RUNTIME_INVALID_INSTRUCTION, "Invalid opcode.");
         }
     }
+
+#undef VM_REGISTER_ORDER_JUMP
+#undef VM_JIT_HOT
+#undef VM_JIT
+#undef VM_REGISTER_CMP_JUMP
+#undef VM_REGISTER_BIN_OP
+#undef VM_REG
+#undef VM_QUICK_NUMERIC_BIN_OP
+#undef VM_NUMERIC_FAST_PATH
+#undef VM_NUMERIC_DISPATCH
+#undef VM_NONZERO_DIVISOR
+#undef VM_NUMERIC_BIN_OP
+#undef VM_QUICKEN
+#undef VM_RELOAD_AND_NEXT
+#undef VM_NEXT
+#undef VM_DEFAULT
+#undef VM_CASE
+#undef VM_INTERPRET_LOOP
+#undef VM_BEFORE_DISPATCH
+#undef VM_TRACE_INSTRUCTION
+#undef VM_PEEK
+#undef VM_POP
+#undef VM_PUSH
+#undef VM_WORD_AT
+#undef VM_READ_CONSTANT
+#undef VM_READ_WORD
+#undef VM_READ_BYTE
+#undef VM_LOAD_STATE
+#undef VM_SAVE_STATE
+#undef VM_COMPUTED_GOTO
 }
 
 void AriaVM::reset()
 {
     stack_.reset();
     c_frame_count_ = 0;
-    e_frame_count_ = 0;
-    open_upvalues_ = nullptr;
+    r_module_count_ = 0;
+    rest_args_.clear();
     update_call_frame();
     e_reg_ = NanBox::NilValue;
     flags_ = 0;
 }
 
-void AriaVM::unwind_to_catch_point()
+// FOR_ITER 的慢路径：字符串、映射和迭代器对象。字符串、映射和 range 的游标是下一个要检查的位置
+bool AriaVM::iterate_next(Value *iter)
 {
-    auto ef = current_eframe();
-    c_frame_count_ = ef->CframeCount;
-    update_call_frame();
-    r_module_count_ = ef->RmoduleCount;
-    frame_->ip = ef->ip;
-    // 在截断栈之前，关闭所有指向将被丢弃的中间栈帧局部的 open upvalue，
+    const int32_t cursor = NanBox::toInt(iter[1]);
+    if (NanBox::isInt(iter[0])) {
+        // LOAD_REST_ITER：当前栈帧留在 rest_args_ 中的多余参数
+        if (frame_->rest_count >= 0) {
+            if (cursor >= frame_->rest_count) {
+                return false;
+            }
+            iter[1] = NanBox::fromInt(cursor + 1);
+            iter[2] = rest_args_[frame_->rest_base + cursor];
+            return true;
+        }
+        // 循环体把剩余参数用作了值，之后改为遍历生成的列表，循环体对列表的修改对遍历可见
+        iter[0] = frame_->stakBase[NanBox::toInt(iter[0])];
+        const ValueArray &list = as_obj_list(iter[0])->list_;
+        if (static_cast<uint32_t>(cursor) >= list.size()) {
+            return false;
+        }
+        iter[1] = NanBox::fromInt(cursor + 1);
+        iter[2] = list[cursor];
+        return true;
+    }
+    if (is_obj_string(iter[0])) {
+        ObjString *str = as_obj_string(iter[0]);
+        if (static_cast<size_t>(cursor) >= str->length_) {
+            return false;
+        }
+        iter[1] = NanBox::fromInt(cursor + 1);
+        iter[2] = NanBox::fromObj(new_ObjString(str->c_str()[cursor], gc_));
+        return true;
+    }
+    if (is_obj_map(iter[0])) {
+        const ValueHashTable *map = as_obj_map(iter[0])->map_;
+        const int64_t index = map->get_next_index(cursor - 1);
+        if (index < 0) {
+            return false;
+        }
+        iter[1] = NanBox::fromInt(static_cast<int32_t>(index + 1));
+        iter[2] = map->get_by_index(index);
+        return true;
+    }
+    Iterator *iterator = as_obj_iterator(iter[0])->iter_;
+    if (iterator->indexed()) {
+        if (!iterator->at(cursor, iter[2])) {
+            return false;
+        }
+        iter[1] = NanBox::fromInt(cursor + 1);
+        return true;
+    }
+    if (!iterator->hasNext()) {
+        return false;
+    }
+    iter[2] = iterator->next();
+    return true;
+}
+
+bool AriaVM::unwind_to_catch_point()
+{
+    int index = c_frame_count_ - 1;
+    const ExceptionHandler *handler = nullptr;
+    for (; index >= 0; index--) {
+        const CallFrame &frame = c_frames_[index];
+        const Chunk *chunk = frame.function->chunk_;
+        // 栈顶帧的 ip 已越过抛出异常的指令的操作码，调用者帧的 ip 在 CALL 之后，
+        // 前一个字节都落在当前指令内；刚压入还没执行的帧 ip 在开头，不会匹配
+        const auto offset = static_cast<uint32_t>(frame.ip - chunk->codes_);
+        if (offset > 0 && (handler = chunk->find_handler(offset - 1)) != nullptr) {
+            break;
+        }
+    }
+    if (handler == nullptr) {
+        return false;
+    }
+    const int frameCount = index + 1;
+    // 在截断栈之前，关闭所有指向将被丢弃的栈帧局部的 open upvalue，
     // 将其值拷贝到各自的 closed_，避免 stack_.resize 后产生悬挂指针。
-    close_upvalues(stack_.base() + ef->stackSize);
-    stack_.resize(ef->stackSize);
+    uint32_t restTop = CallFrame::k_no_rest;
+    for (int i = frameCount; i < c_frame_count_; i++) {
+        close_upvalues(&c_frames_[i], c_frames_[i].stakBase);
+        restTop = std::min(restTop, c_frames_[i].rest_base);
+        if (c_frames_[i].function->type_ == FunctionType::SCRIPT) {
+            pop_running_module();
+        }
+    }
+    if (restTop != CallFrame::k_no_rest) {
+        rest_args_.resize(restTop);
+    }
+    c_frame_count_ = frameCount;
+    update_call_frame();
+    frame_->ip = chunk_->codes_ + handler->handler;
+    Value *stackTop = frame_->stakBase + handler->stack_depth;
+    close_upvalues(frame_, stackTop);
+    stack_.resize(static_cast<uint32_t>(stackTop - stack_.base()));
     stack_.push(e_reg_);
     e_reg_ = NanBox::NilValue;
     unset_err_flag();
+    return true;
 }
 
 void AriaVM::throw_exception(ObjException *e)
@@ -1044,10 +2452,9 @@ void AriaVM::throw_exception(ObjException *e)
 void AriaVM::throw_exception(ErrorCode code, ObjException *e)
 {
     e_reg_ = NanBox::fromObj(e);
-    if (e_frame_count_ == 0) {
+    if (!unwind_to_catch_point()) {
         report_runtime_fatal_error(code, e->what());
     }
-    unwind_to_catch_point();
 }
 
 void AriaVM::throw_exception(ErrorCode code, const char *message)
@@ -1076,11 +2483,4 @@ void AriaVM::report_runtime_fatal_error(ErrorCode code, const char *msg) const
     throw ariaRuntimeException(code, oss.str());
 }
 
-void AriaVM::maybe_debug_step(const uint32_t offset) const
-{
-    if (debugger_) {
-        debugger_->hookBeforeExec(frame_, offset);
-    }
-}
-
 } // namespace aria
\ No newline at end of file
@@ -11,17 +11,30 @@
 #include "object/objFunction.h"
 #include "object/objString.h"
 #include "runtime/callFrame.h"
-#include "runtime/exceptionFrame.h"
+#include "util/sink.h"
+
+#include <csignal>
 
 namespace aria {
+class ObjClosure;
 class ObjModule;
 class ObjUpvalue;
 class ValueHashTable;
+class GlobalTable;
 class AriaDebugger;
+class OpProfiler;
+class SamplingProfiler;
+struct FieldCache;
+struct MethodCache;
+struct CallCache;
 
 enum class InterpretResult { SUCCESS, SRC_FILE_ERROR, COMPILE_ERROR, RUNTIME_ERROR };
 
-enum class NumericBinOp { GT, GE, LT, LE, SUB, MUL, DIV, MOD };
+enum class NumericBinOp { GT, GE, LT, LE, ADD, SUB, MUL, DIV, MOD };
+
+// 解释器主循环的三个实例：FAST 不含任何插桩；PROFILE 在每条指令分发前调用 OpProfiler；
+// DEBUG 处理 BREAKPOINT 并在单步或恢复断点时调用调试器
+enum class DispatchMode { FAST, PROFILE, DEBUG };
 
 class AriaVM
 {
@@ -38,10 +51,29 @@ public:
 
     Value run_function(ObjFunction *fun, int arg_count, const Value *args);
 
+    // 挂上调试器后解释器改用 DEBUG 循环（不进入 JIT），传 nullptr 回到无插桩的循环
     void set_debugger(AriaDebugger *debugger);
 
+    // 之后执行的字节码逐条计入 profiler；传 nullptr 关闭统计。
+    // 统计期间不进入 JIT 机器码，关闭时解释器循环中没有任何统计代码
+    void set_op_profiler(OpProfiler *profiler) { op_profiler_ = profiler; }
+
+    // 以每秒 hz 次的频率对 Aria 调用栈采样（POSIX，基于 SIGPROF）。
+    // 平台不支持、已在采样或进程内其他 VM 正在采样时返回 false
+    bool start_sampling(uint32_t hz = 1000);
+
+    // 停止采样，返回 flamegraph.pl 可读的折叠栈，每行形如 "main;foo;bar 123"；未在采样时返回空串
+    String stop_sampling();
+
+    // 此后由这个 VM 编译的函数使用的后端
+    void set_backend(CodeBackend backend) { backend_ = backend; }
+
     void define_native_fn(
-        const char *name, int arity, NativeFn_t function, bool accepts_varargs = false) const;
+        const char *name,
+        int arity,
+        NativeFn_t function,
+        bool accepts_varargs = false,
+        VarargsConvention convention = VarargsConvention::LIST) const;
 
     void define_native_var(const char *name, Value value) const;
 
@@ -62,13 +94,20 @@ public:
 
     void mark_gc_roots();
 
+    // PRINT 和 println 的输出缓冲：连接终端时按行写出，否则攒满或每次 interpret 结束时写出
+    Sink &output() { return output_; }
+
     GC *gc_;
 
 private:
     InterpretResult run_source(String sourceLocation, String source);
 
     friend class ObjFunction;
+    friend class ObjClosure;
     friend class VMStateHelper;
+    friend class Jit;
+    friend class JitCompiler;
+    friend class SamplingProfiler;
 
     enum FlagIndex {
         undefined0 = 0,
@@ -90,13 +129,15 @@ private:
 
 #undef defFlag
 
-    static constexpr int k_frame_size = 256;
+    // 调用栈和运行模块栈从 k_initial_frames 开始按需成倍扩容，超过 k_max_frames 时报栈溢出
+    static constexpr int k_initial_frames = 16;
+    static constexpr int k_max_frames = 1 << 16;
+    // 为每个栈帧额外预留的值栈槽位（可变参数列表、超级指令的临时值等）
+    static constexpr uint32_t k_stack_slack = 16;
 
-    CallFrame *c_frames_;
-    ExceptionFrame *e_frames_;
-    Value *r_modules_;
+    List<CallFrame> c_frames_;
+    List<Value> r_modules_;
     int c_frame_count_;
-    int e_frame_count_;
     int r_module_count_;
     CallFrame *frame_;
     Chunk *chunk_;
@@ -107,45 +148,65 @@ private:
     ValueHashTable *built_in_;
     ValueHashTable *cached_modules_;
     ValueStack stack_;
-    ObjUpvalue *open_upvalues_;
+    // lazy_varargs_ 函数的多余参数，按栈帧嵌套顺序存放，见 CallFrame::rest_base
+    List<Value> rest_args_;
     String aria_dir_;
-    ValueHashTable *globals_;
+    GlobalTable *globals_;
     AriaDebugger *debugger_;
-
-    ExceptionFrame *current_eframe() { return &e_frames_[e_frame_count_ - 1]; }
+    OpProfiler *op_profiler_;
+    SamplingProfiler *sampler_;
+    // 调用栈扩容期间置位，采样信号此时不读取栈帧
+    volatile std::sig_atomic_t frames_moving_;
+    CodeBackend backend_;
+    Sink output_;
 
     Value *current_rmodule() { return &r_modules_[r_module_count_ - 1]; }
 
     void update_call_frame();
 
-    void push_call_frame(ObjFunction *function, uint8_t *ip, Value *stack_base);
+    // 保证值栈栈顶之上还有 count 个空闲槽位；值栈扩容后把栈帧基址和开放 upvalue 移到新的栈上。
+    // 超过值栈上限时返回 false
+    bool reserve_stack(uint32_t count);
 
-    void push_exception_frame(
-        int c_frame_count, int r_module_count, uint8_t *ip, uint32_t stack_size);
+    void push_call_frame(
+        ObjFunction *function, uint8_t *ip, Value *stack_base, ObjClosure *closure = nullptr);
 
     void push_running_module(const ObjFunction *function);
 
     void pop_call_frame();
 
-    void pop_exception_frame();
-
     void pop_running_module();
 
     void pack_varargs(int arg_count, int arity);
 
+    // 把 frame 留在 rest_args_ 中的多余参数生成列表，存入剩余参数的槽位
+    void materialize_rest(CallFrame *frame, uint16_t slot);
+
     ObjModule *cache_module(ObjFunction *module_fn);
 
-    Value create_call_frame(ObjFunction *function);
+    Value create_call_frame(ObjFunction *function, ObjClosure *closure = nullptr);
 
     Value return_from_current_module(Value result);
 
     Value return_from_current_frame(Value result);
 
+    // 寄存器帧的栈顶固定在 stakBase + frame_size_：进入函数时装入字面量寄存器，调用返回后重置栈顶
+    void enter_register_frame();
+
+    void restore_register_frame();
+
     Value call_value(Value callee, int arg_count);
 
+    // CALL/TAIL_CALL：命中调用点缓存时直接建立栈帧或调用原生函数，否则按 call_value 调用并更新缓存
+    Value call_value_cached(Value callee, int argCount, CallCache *cache);
+
+    static void update_call_cache(CallCache *cache, Value callee, int argCount);
+
     Value call_module(ObjFunction *module);
 
-    Value call_function(ObjFunction *function, int arg_count);
+    Value call_function(ObjFunction *function, int arg_count, ObjClosure *closure = nullptr);
+
+    Value call_closure(ObjClosure *closure, int arg_count);
 
     Value call_native_fn(ObjNativeFn *native, int arg_count);
 
@@ -153,13 +214,31 @@ private:
 
     Value call_bound_method(const ObjBoundMethod *method, int arg_count);
 
+    // 调用类方法或内置原生方法，接收者已经在 0 号槽位
+    Value call_method(Value method, int argCount);
+
+    Value invoke_method(ObjString *name, int argCount, MethodCache *cache);
+
+    // TAIL_CALL：被调用者是参数个数匹配的 Aria 函数（或绑定到它的方法）时复用当前栈帧并返回 true，
+    // 否则（包括新栈帧的槽位预留失败）不做任何改变并返回 false，由调用方按普通 CALL 处理。
+    // 返回 false 时值栈可能已经扩容，调用方需要重新读取栈顶
+    bool tail_call(int argCount);
+
     ObjUpvalue *capture_upvalue(Value *local);
 
-    void close_upvalues(const Value *last);
+    // 关闭 frame 中位于 last 及其之上的 open upvalue
+    void close_upvalues(CallFrame *frame, const Value *last);
 
     template<NumericBinOp op>
     bool numeric_bin_op();
 
+    // 栈顶两个操作数不全是数字时的 ADD：字符串拼接，否则报类型错误
+    bool add_objects();
+
+    void load_field(ObjString *name, FieldCache *cache);
+
+    void store_field(ObjString *name, FieldCache *cache);
+
     void register_native() const;
 
     [[nodiscard]] bool is_module_running(const String &path) const;
@@ -170,11 +249,17 @@ private:
 
     Value run(int ret_frame = 0);
 
+    template<DispatchMode Mode>
+    Value execute(int ret_frame);
+
     void reset();
 
-    void unwind_to_catch_point();
+    // 取出 FOR_ITER 遍历的下一个值写入 iter[2]，已经遍历完时返回 false
+    bool iterate_next(Value *iter);
 
-    void maybe_debug_step(uint32_t offset) const;
+    // 从栈顶帧向下按各帧当前指令查找异常处理表，找到时弹出中间的栈帧和模块、跳到 handler 并压入 e_reg_；
+    // 没有处理器时不改动任何状态并返回 false
+    bool unwind_to_catch_point();
 };
 
 } // namespace aria
@@ -7,10 +7,10 @@ VMState VMStateHelper::saveState(AriaVM *vm)
 {
     VMState state;
     state.CframeCount = vm->c_frame_count_;
-    state.EframeCount = vm->e_frame_count_;
     state.RmoduleCount = vm->r_module_count_;
     state.frame = vm->frame_;
     state.stackSize = vm->stack_.size();
+    state.restArgsSize = static_cast<uint32_t>(vm->rest_args_.size());
     state.flags = vm->flags_;
     state.E_REG = vm->e_reg_;
     return state;
@@ -23,10 +23,11 @@ void VMStateHelper::restoreState(AriaVM *vm, const VMState &state)
         return;
     }
     vm->c_frame_count_ = state.CframeCount;
-    vm->e_frame_count_ = state.EframeCount;
     vm->r_module_count_ = state.RmoduleCount;
     vm->stack_.resize(state.stackSize);
-    vm->frame_ = state.frame;
+    vm->rest_args_.resize(state.restArgsSize);
+    // 调用栈扩容后保存的 frame 指针可能已经失效，按栈帧数重新定位
+    vm->update_call_frame();
     vm->flags_ = state.flags;
     vm->e_reg_ = state.E_REG;
 }
@@ -2,7 +2,6 @@
 #define ARIA_VMSTATE_H
 
 #include "runtime/callFrame.h"
-#include "runtime/exceptionFrame.h"
 
 namespace aria {
 
@@ -11,19 +10,19 @@ class AriaVM;
 struct VMState
 {
     int CframeCount;
-    int EframeCount;
     int RmoduleCount;
     CallFrame *frame;
     uint32_t stackSize;
+    uint32_t restArgsSize;
     uint8_t flags;
     Value E_REG;
 
     VMState()
         : CframeCount{0}
-        , EframeCount{0}
         , RmoduleCount{0}
         , frame{nullptr}
         , stackSize{0}
+        , restArgsSize{0}
         , flags{0}
         , E_REG{NanBox::NilValue}
     {}
@@ -19,14 +19,9 @@ namespace aria {
     }
 
 #define CHECK_INTEGER(val, int_result, what) \
-    int int_result = -1; \
+    int32_t int_result = -1; \
     do { \
-        if (!NanBox::isNumber(val)) { \
-            return env->new_exception(ErrorCode::RUNTIME_TYPE_ERROR, #what " must be an integer"); \
-        } \
-        auto _double_val_ = NanBox::toNumber(val); \
-        (int_result) = static_cast<int>(_double_val_); \
-        if ((int_result) != _double_val_) { \
+        if (!NanBox::toInteger(val, int_result)) { \
             return env->new_exception(ErrorCode::RUNTIME_TYPE_ERROR, #what " must be an integer"); \
         } \
     } while (0)
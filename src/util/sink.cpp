@@ -0,0 +1,40 @@
+#include "util/sink.h"
+
+#include "sys.h"
+
+#include <format>
+#include <iterator>
+
+#if defined(SYS_WINDOWS)
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace aria {
+
+void Sink::write_number(double num)
+{
+    std::format_to(std::back_inserter(buf_), "{}", num);
+}
+
+void Sink::flush()
+{
+    if (out_ == nullptr || buf_.empty()) {
+        return;
+    }
+    out_->write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    out_->flush();
+    buf_.clear();
+}
+
+bool Sink::stdout_is_tty()
+{
+#if defined(SYS_WINDOWS)
+    return _isatty(_fileno(stdout)) != 0;
+#else
+    return isatty(STDOUT_FILENO) != 0;
+#endif
+}
+
+} // namespace aria
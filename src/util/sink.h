@@ -0,0 +1,65 @@
+#ifndef ARIA_SINK_H
+#define ARIA_SINK_H
+
+#include "common.h"
+
+namespace aria {
+
+// 追加式文本缓冲。write_value 把值的文本直接写进来，不为每个值生成临时 String。
+// 绑定了输出流时，缓冲超过 k_flush_threshold、行缓冲模式下写完一行，或显式调用 flush() 时写出；
+// 未绑定输出流时只用来拼接字符串
+class Sink
+{
+public:
+    static constexpr size_t k_flush_threshold = 64 * 1024;
+
+    explicit Sink(std::ostream *out = nullptr, bool lineBuffered = false)
+        : out_{out}
+        , line_buffered_{lineBuffered}
+    {}
+
+    ~Sink() { flush(); }
+
+    Sink(const Sink &) = delete;
+    Sink &operator=(const Sink &) = delete;
+
+    void put(char ch) { buf_.push_back(ch); }
+
+    void write(StringView str)
+    {
+        buf_.append(str);
+        if (buf_.size() >= k_flush_threshold) {
+            flush();
+        }
+    }
+
+    void write_number(double num);
+
+    // 写入换行；行缓冲模式下（输出到终端）随即写出
+    void end_line()
+    {
+        buf_.push_back('\n');
+        if (line_buffered_ || buf_.size() >= k_flush_threshold) {
+            flush();
+        }
+    }
+
+    void flush();
+
+    void set_line_buffered(bool lineBuffered) { line_buffered_ = lineBuffered; }
+
+    // 未绑定输出流时取出拼好的字符串
+    String take() { return std::move(buf_); }
+
+    // 标准输出是否连接到终端
+    static bool stdout_is_tty();
+
+private:
+    String buf_;
+    std::ostream *out_;
+    bool line_buffered_;
+};
+
+} // namespace aria
+
+#endif //ARIA_SINK_H
@@ -0,0 +1,63 @@
+#include "value/globalTable.h"
+
+#include "object/objString.h"
+#include "value/valueHashTable.h"
+
+namespace aria {
+
+GlobalTable::GlobalTable(const ValueHashTable *builtins)
+    : builtins_{builtins}
+    , values_base_{nullptr}
+{}
+
+uint32_t GlobalTable::slot_of(ObjString *name)
+{
+    auto [it, inserted] = index_.try_emplace(name, size());
+    if (inserted) {
+        Value value = k_undefined;
+        if (builtins_ != nullptr) {
+            builtins_->get(NanBox::fromObj(name), value);
+        }
+        names_.push_back(name);
+        values_.push_back(value);
+        values_base_ = values_.data();
+        defined_.push_back(false);
+    }
+    return it->second;
+}
+
+int32_t GlobalTable::find(ObjString *name) const
+{
+    auto it = index_.find(name);
+    return it == index_.end() ? -1 : static_cast<int32_t>(it->second);
+}
+
+bool GlobalTable::define(uint32_t slot, Value value)
+{
+    values_[slot] = value;
+    if (defined_[slot]) {
+        return false;
+    }
+    defined_[slot] = true;
+    return true;
+}
+
+bool GlobalTable::get(ObjString *name, Value &value) const
+{
+    int32_t slot = find(name);
+    if (slot < 0 || !defined_[slot]) {
+        return false;
+    }
+    value = values_[slot];
+    return true;
+}
+
+void GlobalTable::mark()
+{
+    for (uint32_t i = 0; i < size(); i++) {
+        names_[i]->mark();
+        mark_value(values_[i]);
+    }
+}
+
+} // namespace aria
@@ -0,0 +1,63 @@
+#ifndef ARIA_GLOBALTABLE_H
+#define ARIA_GLOBALTABLE_H
+
+#include "value/value.h"
+
+namespace aria {
+class ObjString;
+class ValueHashTable;
+
+// 模块级全局变量表。
+// 编译期把全局变量名解析为槽位下标，运行时 LOAD/STORE/DEF_GLOBAL 直接按下标访问 values_。
+// 同一模块（以及 REPL 的多次输入）共用一张表，因此槽位在多次编译之间保持稳定。
+// 新建槽位时若存在同名内置函数/变量，则预先绑定其值；用户定义的同名全局变量会覆盖它
+class GlobalTable
+{
+public:
+    explicit GlobalTable(const ValueHashTable *builtins = nullptr);
+
+    ~GlobalTable() = default;
+
+    GlobalTable(const GlobalTable &) = delete;
+    GlobalTable &operator=(const GlobalTable &) = delete;
+
+    // slot index of name, a new (undefined or builtin-bound) slot is appended if absent
+    uint32_t slot_of(ObjString *name);
+
+    // return slot index of name, or -1 if absent
+    [[nodiscard]] int32_t find(ObjString *name) const;
+
+    // define a global in slot; return false if it was already defined (value is still updated)
+    bool define(uint32_t slot, Value value);
+
+    // value of a user-defined global, builtins are not included
+    bool get(ObjString *name, Value &value) const;
+
+    [[nodiscard]] bool is_defined(uint32_t slot) const { return defined_[slot]; }
+
+    [[nodiscard]] Value &value(uint32_t slot) { return values_[slot]; }
+
+    [[nodiscard]] ObjString *name(uint32_t slot) const { return names_[slot]; }
+
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(names_.size()); }
+
+    // 槽位数组的地址在新增槽位时可能改变，JIT 生成的代码经由它间接访问槽位
+    [[nodiscard]] Value *const *values_address() const { return &values_base_; }
+
+    void mark();
+
+    // value of a slot that is neither defined nor bound to a builtin, never visible to scripts
+    static constexpr Value k_undefined = NanBox::QNaN | 0x4;
+
+private:
+    const ValueHashTable *builtins_;
+    List<ObjString *> names_;
+    List<Value> values_;
+    Value *values_base_;
+    List<uint8_t> defined_;
+    Map<ObjString *, uint32_t> index_;
+};
+
+} // namespace aria
+
+#endif //ARIA_GLOBALTABLE_H
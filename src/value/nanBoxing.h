@@ -2,6 +2,7 @@
 #define ARIA_NANBOXING_H
 
 #include <bit>
+#include <cmath>
 #include <cstdint>
 
 namespace aria {
@@ -24,6 +25,9 @@ inline constexpr uint64_t TagTrue = 0x0000000000000003;
 inline constexpr NanBox_t TrueValue = QNaN | TagTrue;
 inline constexpr NanBox_t FalseValue = QNaN | TagFalse;
 inline constexpr NanBox_t NilValue = QNaN | TagNil;
+// 小整数：QNaN | TagInt | 低 32 位的 int32
+inline constexpr NanBox_t TagInt = 0x0001000000000000;
+inline constexpr NanBox_t IntMask = SignBit | QNaN | TagInt;
 
 //==============================
 //  基本构造函数
@@ -39,6 +43,31 @@ inline NanBox_t fromNumber(double num)
     return std::bit_cast<NanBox_t>(num);
 }
 
+inline NanBox_t fromInt(int32_t i)
+{
+    return QNaN | TagInt | static_cast<uint32_t>(i);
+}
+
+// 能用 int32 精确表示的数（-0 除外）使用整数表示，否则使用 double
+inline NanBox_t fromInteger(int64_t i)
+{
+    if (i >= INT32_MIN && i <= INT32_MAX) {
+        return fromInt(static_cast<int32_t>(i));
+    }
+    return fromNumber(static_cast<double>(i));
+}
+
+inline NanBox_t packNumber(double num)
+{
+    if (num >= INT32_MIN && num <= INT32_MAX) {
+        auto i = static_cast<int32_t>(num);
+        if (i == num && (i != 0 || !std::signbit(num))) {
+            return fromInt(i);
+        }
+    }
+    return fromNumber(num);
+}
+
 inline NanBox_t fromObj(Obj *obj)
 {
     return SignBit | QNaN | std::bit_cast<uint64_t>(obj);
@@ -53,7 +82,12 @@ inline bool toBool(NanBox_t v)
     return v == TrueValue;
 }
 
-inline double toNumber(NanBox_t v)
+inline int32_t toInt(NanBox_t v)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(v));
+}
+
+inline double toDouble(NanBox_t v)
 {
     return std::bit_cast<double>(v);
 }
@@ -87,16 +121,210 @@ inline bool isNil(NanBox_t v)
     return v == NilValue;
 }
 
-inline bool isNumber(NanBox_t v)
+inline bool isInt(NanBox_t v)
+{
+    return (v & IntMask) == (QNaN | TagInt);
+}
+
+inline bool isDouble(NanBox_t v)
 {
     return (v & QNaN) != QNaN;
 }
 
+inline bool isNumber(NanBox_t v)
+{
+    return isDouble(v) | isInt(v);
+}
+
+// 合并的类型守卫：两个值都是 double
+inline bool isDoubles(NanBox_t a, NanBox_t b)
+{
+    return ((a & QNaN) != QNaN) & ((b & QNaN) != QNaN);
+}
+
+// 合并的类型守卫：两个值都是 int32
+inline bool isInts(NanBox_t a, NanBox_t b)
+{
+    return ((a & IntMask) == (QNaN | TagInt)) & ((b & IntMask) == (QNaN | TagInt));
+}
+
+// 合并的类型守卫：两个值都是数字
+inline bool isNumbers(NanBox_t a, NanBox_t b)
+{
+    return isNumber(a) & isNumber(b);
+}
+
 inline bool isObj(NanBox_t v)
 {
     return (v & (QNaN | SignBit)) == (QNaN | SignBit);
 }
 
+//==============================
+//  数字取值（int32 与 double 两种表示）
+//==============================
+
+// 数字（int32 或 double）统一按 double 取值
+inline double toNumber(NanBox_t v)
+{
+    return isInt(v) ? toInt(v) : toDouble(v);
+}
+
+// 取整数值：int32，或能用 int32 精确表示的 double
+inline bool toInteger(NanBox_t v, int32_t &out)
+{
+    if (isInt(v)) {
+        out = toInt(v);
+        return true;
+    }
+    if (!isDouble(v)) {
+        return false;
+    }
+    double num = toDouble(v);
+    if (!(num >= INT32_MIN && num <= INT32_MAX)) {
+        return false;
+    }
+    out = static_cast<int32_t>(num);
+    return out == num;
+}
+
+//==============================
+//  数值运算（调用方保证两个操作数都是数字）
+//  两个 int32 的结果仍能用 int32 表示时得到整数，否则提升为 double
+//==============================
+
+// 带溢出检查的 int32 运算，溢出时返回 true
+inline bool addOverflow(int32_t a, int32_t b, int32_t &result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &result);
+#else
+    int64_t wide = static_cast<int64_t>(a) + b;
+    result = static_cast<int32_t>(wide);
+    return wide != result;
+#endif
+}
+
+inline bool subOverflow(int32_t a, int32_t b, int32_t &result)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_sub_overflow(a, b, &result);
+#else
+    int64_t wide = static_cast<int64_t>(a) - b;
+    result = static_cast<int32_t>(wide);
+    return wide != result;
+#endif
+}
+
+inline NanBox_t add(NanBox_t a, NanBox_t b)
+{
+    int32_t result;
+    if (isInts(a, b) && !addOverflow(toInt(a), toInt(b), result)) {
+        return fromInt(result);
+    }
+    if (isDoubles(a, b)) {
+        return fromNumber(toDouble(a) + toDouble(b));
+    }
+    return fromNumber(toNumber(a) + toNumber(b));
+}
+
+inline NanBox_t sub(NanBox_t a, NanBox_t b)
+{
+    int32_t result;
+    if (isInts(a, b) && !subOverflow(toInt(a), toInt(b), result)) {
+        return fromInt(result);
+    }
+    if (isDoubles(a, b)) {
+        return fromNumber(toDouble(a) - toDouble(b));
+    }
+    return fromNumber(toNumber(a) - toNumber(b));
+}
+
+inline NanBox_t mul(NanBox_t a, NanBox_t b)
+{
+    if (isInts(a, b)) {
+        int64_t result = static_cast<int64_t>(toInt(a)) * toInt(b);
+        // 0 乘以负数在 double 下得到 -0
+        if (result != 0 || (toInt(a) >= 0 && toInt(b) >= 0)) {
+            return fromInteger(result);
+        }
+    }
+    if (isDoubles(a, b)) {
+        return fromNumber(toDouble(a) * toDouble(b));
+    }
+    return fromNumber(toNumber(a) * toNumber(b));
+}
+
+inline NanBox_t div(NanBox_t a, NanBox_t b)
+{
+    return fromNumber(toNumber(a) / toNumber(b));
+}
+
+// 除数为 0 的情况由调用方检查
+inline NanBox_t mod(NanBox_t a, NanBox_t b)
+{
+    if (isInts(a, b) && toInt(b) != -1) {
+        int32_t result = toInt(a) % toInt(b);
+        // 负数被整除时 fmod 得到 -0
+        if (result != 0 || toInt(a) >= 0) {
+            return fromInt(result);
+        }
+    }
+    return fromNumber(std::fmod(toNumber(a), toNumber(b)));
+}
+
+inline bool less(NanBox_t a, NanBox_t b)
+{
+    if (isInts(a, b)) {
+        return toInt(a) < toInt(b);
+    }
+    if (isDoubles(a, b)) {
+        return toDouble(a) < toDouble(b);
+    }
+    return toNumber(a) < toNumber(b);
+}
+
+inline bool lessEqual(NanBox_t a, NanBox_t b)
+{
+    if (isInts(a, b)) {
+        return toInt(a) <= toInt(b);
+    }
+    if (isDoubles(a, b)) {
+        return toDouble(a) <= toDouble(b);
+    }
+    return toNumber(a) <= toNumber(b);
+}
+
+inline bool greater(NanBox_t a, NanBox_t b)
+{
+    if (isInts(a, b)) {
+        return toInt(a) > toInt(b);
+    }
+    if (isDoubles(a, b)) {
+        return toDouble(a) > toDouble(b);
+    }
+    return toNumber(a) > toNumber(b);
+}
+
+inline bool greaterEqual(NanBox_t a, NanBox_t b)
+{
+    if (isInts(a, b)) {
+        return toInt(a) >= toInt(b);
+    }
+    if (isDoubles(a, b)) {
+        return toDouble(a) >= toDouble(b);
+    }
+    return toNumber(a) >= toNumber(b);
+}
+
+inline NanBox_t negate(NanBox_t v)
+{
+    // -0 与 -INT32_MIN 无法用 int32 表示
+    if (isInt(v) && toInt(v) != 0 && toInt(v) != INT32_MIN) {
+        return fromInt(-toInt(v));
+    }
+    return fromNumber(-toNumber(v));
+}
+
 } // namespace NanBox
 
 } // namespace aria
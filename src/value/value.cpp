@@ -1,9 +1,11 @@
 #include "value/value.h"
+#include "object/objBoundMethod.h"
 #include "object/objInstance.h"
 #include "object/objList.h"
 #include "object/objMap.h"
 #include "object/object.h"
 #include "util/hash.h"
+#include "util/sink.h"
 #include "value/valueArray.h"
 #include "value/valueStack.h"
 
@@ -25,6 +27,7 @@ String value_type_string(Value value)
         case ObjType::STRING:
             return "string";
         case ObjType::FUNCTION:
+        case ObjType::CLOSURE:
             return "function";
         case ObjType::BOUND_METHOD:
             return "boundMethod";
@@ -91,13 +94,35 @@ String value_representation(Value value)
     return "unknown value";
 }
 
+void write_value(Value value, Sink &sink)
+{
+    if (NanBox::isNumber(value)) {
+        sink.write_number(NanBox::toNumber(value));
+    } else if (NanBox::isObj(value)) {
+        NanBox::toObj(value)->write_string(sink);
+    } else {
+        sink.write(value_string(value));
+    }
+}
+
+void write_value_representation(Value value, Sink &sink)
+{
+    if (NanBox::isNumber(value)) {
+        sink.write_number(NanBox::toNumber(value));
+    } else if (NanBox::isObj(value)) {
+        NanBox::toObj(value)->write_representation(sink);
+    } else {
+        sink.write(value_representation(value));
+    }
+}
+
 bool values_equal(Value a, Value b)
 {
     if (NanBox::isNumber(a) && NanBox::isNumber(b)) {
         return NanBox::toNumber(a) == NanBox::toNumber(b);
     }
     if (is_obj_list(a) && is_obj_list(b)) {
-        return as_obj_list(a)->list_->equals(as_obj_list(b)->list_);
+        return as_obj_list(a)->list_.equals(&as_obj_list(b)->list_);
     }
     if (is_obj_map(a) && is_obj_map(b)) {
         return as_obj_map(a)->map_->equals(as_obj_map(b)->map_);
@@ -108,7 +133,16 @@ bool values_equal(Value a, Value b)
         if (a_instance->klass_ != b_instance->klass_) {
             return false;
         }
-        return a_instance->fields_.equals(&b_instance->fields_);
+        return a_instance->fields_equal(b_instance);
+    }
+    if (is_obj_bound_method(a) && is_obj_bound_method(b)) {
+        // 每次读取方法都会新建 bound method，同一接收者上的同一方法视为相等
+        const ObjBoundMethod *a_method = as_obj_bound_method(a);
+        const ObjBoundMethod *b_method = as_obj_bound_method(b);
+        return a_method->receiver_ == b_method->receiver_
+               && a_method->method_type_ == b_method->method_type_
+               && a_method->method_ == b_method->method_ && a_method->closure_ == b_method->closure_
+               && a_method->native_method_ == b_method->native_method_;
     }
     return a == b;
 }
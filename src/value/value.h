@@ -6,6 +6,8 @@
 
 namespace aria {
 
+class Sink;
+
 using Value = NanBox::NanBox_t;
 
 String value_type_string(Value value);
@@ -14,6 +16,11 @@ String value_string(Value value);
 
 String value_representation(Value value);
 
+// 与 value_string / value_representation 输出相同，但直接写入 sink，不生成中间字符串
+void write_value(Value value, Sink &sink);
+
+void write_value_representation(Value value, Sink &sink);
+
 inline bool values_same(Value a, Value b)
 {
     if (NanBox::isNumber(a) && NanBox::isNumber(b)) {
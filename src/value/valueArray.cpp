@@ -1,24 +1,28 @@
 #include "value/valueArray.h"
 #include "memory/gc.h"
+#include "util/sink.h"
 
+#include <algorithm>
 #include <cstring>
 
 namespace aria {
 ValueArray::ValueArray(GC *gc)
-    : capacity_{0}
+    : capacity_{k_inline_capacity}
     , count_{0}
-    , values_{nullptr}
+    , values_{inline_values_}
     , gc_{gc}
+    , inline_values_{}
 {}
 
 ValueArray::ValueArray(const uint32_t begin, const uint32_t end, const ValueArray *other, GC *gc)
-    : capacity_{0}
+    : capacity_{k_inline_capacity}
     , count_{0}
-    , values_{nullptr}
+    , values_{inline_values_}
     , gc_{gc}
+    , inline_values_{}
 {
     uint32_t size = end - begin;
-    reserve(next_power_of_2(size));
+    reserve(size <= k_inline_capacity ? size : next_power_of_2(size));
     if (size > 0 && (other == nullptr || other->values_ == nullptr)) {
         fatal_error(
             ErrorCode::RESOURCE_LIST_CONSTRUCT_FAIL,
@@ -33,12 +37,13 @@ ValueArray::ValueArray(const uint32_t begin, const uint32_t end, const ValueArra
 }
 
 ValueArray::ValueArray(Value *values, uint32_t count, GC *gc)
-    : capacity_{0}
+    : capacity_{k_inline_capacity}
     , count_{0}
-    , values_{nullptr}
+    , values_{inline_values_}
     , gc_{gc}
+    , inline_values_{}
 {
-    reserve(next_power_of_2(count));
+    reserve(count <= k_inline_capacity ? count : next_power_of_2(count));
     if (count > 0 && values == nullptr) {
         fatal_error(
             ErrorCode::RESOURCE_LIST_CONSTRUCT_FAIL,
@@ -52,7 +57,9 @@ ValueArray::ValueArray(Value *values, uint32_t count, GC *gc)
 
 ValueArray::~ValueArray()
 {
-    gc_->free_array<Value>(values_, capacity_);
+    if (!is_inline()) {
+        gc_->free_array<Value>(values_, capacity_);
+    }
 }
 
 void ValueArray::push(Value value)
@@ -141,7 +148,23 @@ uint32_t ValueArray::size() const
 
 void ValueArray::reserve(const uint32_t new_capacity)
 {
-    values_ = gc_->resize_array<Value>(values_, capacity_, new_capacity);
+    if (new_capacity <= k_inline_capacity) {
+        if (!is_inline()) {
+            std::copy_n(values_, std::min(count_, k_inline_capacity), inline_values_);
+            gc_->free_array<Value>(values_, capacity_);
+            values_ = inline_values_;
+            capacity_ = k_inline_capacity;
+        }
+        return;
+    }
+    if (is_inline()) {
+        // 分配可能触发 GC，此时元素仍在内联缓冲中
+        Value *values = gc_->allocate_array<Value>(new_capacity);
+        std::copy_n(inline_values_, count_, values);
+        values_ = values;
+    } else {
+        values_ = gc_->resize_array<Value>(values_, capacity_, new_capacity);
+    }
     capacity_ = new_capacity;
 }
 
@@ -160,20 +183,21 @@ bool ValueArray::equals(ValueArray *other) const
 
 String ValueArray::to_string() const
 {
-    String list_str = "[";
-    if (count_ == 0) {
-        list_str += "]";
-    }
+    Sink sink;
+    write_to(sink);
+    return sink.take();
+}
+
+void ValueArray::write_to(Sink &sink) const
+{
+    sink.put('[');
     for (uint32_t i = 0; i < count_; i++) {
-        Value elem = values_[i];
-        list_str += value_representation(elem);
-        if (i != count_ - 1) {
-            list_str += ",";
-        } else {
-            list_str += "]";
+        if (i != 0) {
+            sink.put(',');
         }
+        write_value_representation(values_[i], sink);
     }
-    return list_str;
+    sink.put(']');
 }
 
 void ValueArray::mark()
@@ -9,9 +9,13 @@ class ValueStack;
 
 class GC;
 
+// 元素不超过 k_inline_capacity 个时存放在对象内部的 inline_values_ 中，不另外分配数组；
+// 超过后换到堆上的数组，容量降回 k_inline_capacity 以内时（clear 等）再回到内联缓冲
 class ValueArray
 {
 public:
+    static constexpr uint32_t k_inline_capacity = 4;
+
     ValueArray() = delete;
 
     explicit ValueArray(GC *gc);
@@ -23,6 +27,9 @@ public:
 
     ~ValueArray();
 
+    ValueArray(const ValueArray &) = delete;
+    ValueArray &operator=(const ValueArray &) = delete;
+
     Value &operator[](uint32_t index)
     {
 #ifdef DEBUG_MODE
@@ -59,19 +66,26 @@ public:
 
     [[nodiscard]] bool empty() const { return count_ == 0; }
 
+    [[nodiscard]] const Value *data() const { return values_; }
+
     void reserve(uint32_t new_capacity);
 
     bool equals(ValueArray *other) const;
 
     String to_string() const;
 
+    void write_to(Sink &sink) const;
+
     void mark();
 
+    [[nodiscard]] bool is_inline() const { return values_ == inline_values_; }
+
 private:
     uint32_t capacity_;
     uint32_t count_;
     Value *values_;
     GC *gc_;
+    Value inline_values_[k_inline_capacity];
 };
 } // namespace aria
 
@@ -1,6 +1,7 @@
 #include "value/valueHashTable.h"
 #include "memory/gc.h"
 #include "object/objList.h"
+#include "util/sink.h"
 #include "value/valueArray.h"
 
 namespace aria {
@@ -154,24 +155,28 @@ void ValueHashTable::clear()
 
 String ValueHashTable::to_string() const
 {
-    String str;
-    str.reserve(count_ * 6);
-    str += "{";
+    Sink sink;
+    write_to(sink);
+    return sink.take();
+}
+
+void ValueHashTable::write_to(Sink &sink) const
+{
+    sink.put('{');
     bool first = true;
     for (int i = 0; i < capacity_; i++) {
         if (ctrl_not_full(ctrl_[i])) {
             continue;
         }
         if (!first) {
-            str += ",";
+            sink.put(',');
         }
         first = false;
-        str += value_representation(entry_[i].key);
-        str += ":";
-        str += value_representation(entry_[i].value);
+        write_value_representation(entry_[i].key, sink);
+        sink.put(':');
+        write_value_representation(entry_[i].value, sink);
     }
-    str += "}";
-    return str;
+    sink.put('}');
 }
 
 int64_t ValueHashTable::find_exist(Value key) const
@@ -323,8 +328,8 @@ ObjList *ValueHashTable::create_pair(const uint32_t index) const
 {
     ObjList *list = new_ObjList(gc_);
     GcTempRootGuard guard{gc_, NanBox::fromObj(list)};
-    list->list_->push(entry_[index].key);
-    list->list_->push(entry_[index].value);
+    list->list_.push(entry_[index].key);
+    list->list_.push(entry_[index].value);
     return list;
 }
 
@@ -333,7 +338,7 @@ ObjList *ValueHashTable::collect_entries(F &&selector) const
 {
     ObjList *list = new_ObjList(gc_);
     GcTempRootGuard guard{gc_, NanBox::fromObj(list)};
-    list->list_->reserve(next_power_of_2(count_));
+    list->list_.reserve(next_power_of_2(count_));
     for (uint32_t i = 0; i < capacity_; i++) {
         if (ctrl_not_full(ctrl_[i])) {
             continue;
@@ -346,21 +351,21 @@ ObjList *ValueHashTable::collect_entries(F &&selector) const
 ObjList *ValueHashTable::create_pair_list() const
 {
     return collect_entries([this](ObjList *list, uint32_t i) {
-        list->list_->push(NanBox::fromObj(create_pair(i)));
+        list->list_.push(NanBox::fromObj(create_pair(i)));
     });
 }
 
 ObjList *ValueHashTable::create_key_list() const
 {
     return collect_entries([this](ObjList *list, uint32_t i) {
-        list->list_->push(entry_[i].key);
+        list->list_.push(entry_[i].key);
     });
 }
 
 ObjList *ValueHashTable::create_value_list() const
 {
     return collect_entries([this](ObjList *list, uint32_t i) {
-        list->list_->push(entry_[i].value);
+        list->list_.push(entry_[i].value);
     });
 }
 
@@ -56,6 +56,8 @@ public:
 
     String to_string() const;
 
+    void write_to(Sink &sink) const;
+
     void mark();
 
     int64_t get_next_index(int64_t pre) const;
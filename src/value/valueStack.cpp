@@ -1,5 +1,6 @@
 #include "value/valueStack.h"
 
+#include <algorithm>
 #include <sstream>
 
 namespace aria {
@@ -19,6 +20,24 @@ ValueStack::~ValueStack()
     delete[] stack_;
 }
 
+bool ValueStack::grow(uint32_t required)
+{
+    if (required > k_max_stack_size) {
+        return false;
+    }
+    uint32_t new_max = std::max(max_, 1u);
+    while (new_max < required) {
+        new_max *= 2;
+    }
+    new_max = std::min(new_max, k_max_stack_size);
+    auto *new_stack = new Value[new_max];
+    std::copy_n(stack_, top_, new_stack);
+    delete[] stack_;
+    stack_ = new_stack;
+    max_ = new_max;
+    return true;
+}
+
 bool ValueStack::exist(Value v)
 {
     for (uint32_t slot = 0; slot < top_; slot++) {
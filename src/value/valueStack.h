@@ -19,7 +19,7 @@ public:
     void push(Value value)
     {
 #ifdef DEBUG_MODE
-        assert(top_ < k_default_stack_size);
+        assert(top_ < max_);
 #endif
         stack_[top_] = value;
         top_++;
@@ -54,6 +54,12 @@ public:
 
     uint32_t size() const { return top_; }
 
+    uint32_t capacity() const { return max_; }
+
+    // 保证栈顶之上至少还有 count 个空闲槽位，容量不足时成倍扩容。
+    // 扩容会把栈搬到新的内存上，之前取得的槽位指针全部失效；超过 k_max_stack_size 时返回 false
+    bool reserve(uint32_t count) { return max_ - top_ >= count || grow(top_ + count); }
+
     void resize(uint32_t new_size) { top_ = new_size; }
 
     Value &operator[](uint32_t index) { return stack_[index]; }
@@ -62,6 +68,8 @@ public:
 
     Value *get_top_ptr() { return &stack_[top_]; }
 
+    void set_top_ptr(Value *top) { top_ = static_cast<uint32_t>(top - stack_); }
+
     void set_top_val(Value v) { stack_[top_ - 1] = v; }
 
     Value *base() { return stack_; }
@@ -74,9 +82,11 @@ public:
 
     void mark();
 
+    static constexpr uint32_t k_default_stack_size = 256;
+    static constexpr uint32_t k_max_stack_size = 1 << 22;
+
 private:
-    using stack_size_t = uint16_t;
-    static constexpr int k_default_stack_size = UINT16_MAX;
+    bool grow(uint32_t required);
 
     Value *stack_;
     uint32_t max_;
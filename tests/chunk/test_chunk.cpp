@@ -3,8 +3,12 @@
 #include "tests/gc/gc_init.h"
 
 #include "src/chunk/chunk.h"
+#include "src/object/objFunction.h"
+#include "src/object/objString.h"
 
 using namespace aria;
+using testing::internal::CaptureStdout;
+using testing::internal::GetCapturedStdout;
 
 class ChunkTest : public GCFixture
 {
@@ -181,3 +185,57 @@ TEST_F(ChunkTest, EmitFunEndRetInit)
     EXPECT_EQ(chunk[2], 0);  // arg high byte
     EXPECT_EQ(chunk[3], static_cast<uint8_t>(opCode::RETURN));
 }
+
+// emit_call：CALL + argc8 + 调用点缓存下标16，反汇编显示缓存状态
+TEST_F(ChunkTest, EmitCallWithCache)
+{
+    Chunk chunk{gc};
+    chunk.emit_call(opCode::CALL, 2, 1);
+    chunk.emit_call(opCode::TAIL_CALL, 0, 1);
+
+    EXPECT_EQ(chunk.count_, 8);
+    EXPECT_EQ(chunk[0], static_cast<uint8_t>(opCode::CALL));
+    EXPECT_EQ(chunk[1], 2);
+    EXPECT_EQ(chunk[2], 0);  // cache low byte
+    EXPECT_EQ(chunk[6], 1);  // 第二个调用点使用 1 号缓存
+    ASSERT_EQ(chunk.call_caches_.size(), 2u);
+
+    CaptureStdout();
+    chunk.disassemble("call");
+    String output = GetCapturedStdout();
+    EXPECT_NE(output.find("[ic 0]"), String::npos) << output;
+
+    auto name = new_ObjString("f", gc);
+    auto fn = new_ObjFunction(FunctionType::FUNCTION, name, name, 2, nullptr, false, gc);
+    chunk.call_caches_[0] = CallCache{NanBox::fromObj(fn), CallCacheKind::FUNCTION, fn, nullptr};
+    CaptureStdout();
+    chunk.disassemble("call");
+    output = GetCapturedStdout();
+    EXPECT_NE(output.find("[ic 0 function"), String::npos) << output;
+    EXPECT_NE(output.find("[ic 1]"), String::npos) << output;
+}
+
+// 调用点缓存不让被调用者存活：GC 后被回收的被调用者对应的缓存被清空，存活的保持不变
+TEST_F(ChunkTest, CallCacheDoesNotKeepCalleeAlive)
+{
+    auto name = new_ObjString("f", gc);
+    GcTempRootGuard guard{gc, NanBox::fromObj(name)};
+    auto caller = new_ObjFunction(FunctionType::FUNCTION, name, name, gc);
+    guard.push(NanBox::fromObj(caller));
+    auto kept = new_ObjFunction(FunctionType::FUNCTION, name, name, gc);
+    guard.push(NanBox::fromObj(kept));
+    caller->chunk_->emit_call(opCode::CALL, 0, 1);
+    caller->chunk_->emit_call(opCode::CALL, 0, 1);
+    auto dropped = new_ObjFunction(FunctionType::FUNCTION, name, name, gc);
+
+    auto &caches = caller->chunk_->call_caches_;
+    caches[0] = CallCache{NanBox::fromObj(kept), CallCacheKind::FUNCTION, kept, nullptr};
+    caches[1] = CallCache{NanBox::fromObj(dropped), CallCacheKind::FUNCTION, dropped, nullptr};
+    gc->collect_garbage();
+
+    EXPECT_EQ(caches[0].callee, NanBox::fromObj(kept));
+    EXPECT_EQ(caches[0].function, kept);
+    EXPECT_TRUE(NanBox::isNil(caches[1].callee));
+    EXPECT_EQ(caches[1].kind, CallCacheKind::NONE);
+    EXPECT_EQ(caches[1].function, nullptr);
+}
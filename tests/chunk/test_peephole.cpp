@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include "compile/byteCodeGenerator.h"
+#include "compile/lexer.h"
+#include "compile/parser.h"
+#include "memory/gc.h"
+#include "object/objFunction.h"
+#include "src/chunk/chunk.h"
+#include "src/chunk/peephole.h"
+#include "src/runtime/vm.h"
+#include "tests/gc/gc_init.h"
+
+using namespace aria;
+using testing::internal::CaptureStdout;
+using testing::internal::GetCapturedStdout;
+
+class PeepholeTest : public GCFixture
+{
+public:
+    // 编译源码并执行窥孔优化，返回整个 chunk（含嵌套函数）的反汇编
+    String optimizedDisassembly(const char *source)
+    {
+        auto lexer = Lexer{String{source}};
+        auto tokens = lexer.tokenize();
+        EXPECT_FALSE(lexer.had_error());
+        auto parser = Parser{tokens};
+        auto ast = parser.parse();
+        EXPECT_FALSE(parser.hasError());
+        auto generator = ByteCodeGenerator{"anonymous", "script", nullptr, gc};
+        auto fn = generator.generateCode(ast);
+        uint32_t count = fn->chunk_->count_;
+
+        Peephole::optimize(fn);
+        // 改写是等长的
+        EXPECT_EQ(fn->chunk_->count_, count);
+
+        CaptureStdout();
+        fn->chunk_->disassemble("peephole");
+        for (uint32_t i = 0; i < fn->chunk_->consts_.size(); i++) {
+            if (is_obj_function(fn->chunk_->consts_[i])) {
+                as_obj_function(fn->chunk_->consts_[i])->chunk_->disassemble("fn");
+            }
+        }
+        return GetCapturedStdout();
+    }
+};
+
+// 只改写序列首字节，其余字节保持不变
+TEST_F(PeepholeTest, RewriteOnlyFirstByte)
+{
+    Chunk chunk{gc};
+    chunk.emit_op_arg16(opCode::LOAD_LOCAL, 1, 1);
+    chunk.emit_op_value(opCode::LOAD_CONST, NanBox::fromNumber(1), 1);
+    chunk.emit_op(opCode::ADD, 1);
+    chunk.emit_op_arg16(opCode::STORE_LOCAL, 1, 1);
+    chunk.emit_op(opCode::POP, 1);
+    chunk.emit_op(opCode::RETURN, 2);
+
+    Peephole::optimizeChunk(&chunk);
+
+    EXPECT_EQ(chunk.count_, 12);
+    EXPECT_EQ(chunk[0], static_cast<uint8_t>(opCode::INC_LOCAL));
+    EXPECT_EQ(chunk[3], static_cast<uint8_t>(opCode::LOAD_CONST));
+    EXPECT_EQ(chunk[6], static_cast<uint8_t>(opCode::ADD));
+    EXPECT_EQ(chunk[7], static_cast<uint8_t>(opCode::STORE_LOCAL));
+    EXPECT_EQ(chunk[10], static_cast<uint8_t>(opCode::POP));
+    EXPECT_EQ(chunk[11], static_cast<uint8_t>(opCode::RETURN));
+}
+
+// 不同的局部变量不能融合为 INC_LOCAL
+TEST_F(PeepholeTest, IncLocalRequiresSameSlot)
+{
+    Chunk chunk{gc};
+    chunk.emit_op_arg16(opCode::LOAD_LOCAL, 1, 1);
+    chunk.emit_op_value(opCode::LOAD_CONST, NanBox::fromNumber(1), 1);
+    chunk.emit_op(opCode::ADD, 1);
+    chunk.emit_op_arg16(opCode::STORE_LOCAL, 2, 1);
+    chunk.emit_op(opCode::POP, 1);
+
+    Peephole::optimizeChunk(&chunk);
+
+    EXPECT_EQ(chunk[0], static_cast<uint8_t>(opCode::LOAD_LOCAL));
+}
+
+// 序列内部是跳转目标时不能融合
+TEST_F(PeepholeTest, SkipJumpTargetInsideSequence)
+{
+    Chunk chunk{gc};
+    chunk.emit_op(opCode::LOAD_TRUE, 1);
+    uint32_t jump = chunk.emit_jump(opCode::JUMP_TRUE, 1);
+    chunk.emit_op_arg16(opCode::LOAD_LOCAL, 1, 1);
+    chunk.patch_jump(jump);
+    chunk.emit_op_value(opCode::LOAD_CONST, NanBox::fromNumber(1), 1);
+    chunk.emit_op(opCode::ADD, 1);
+    chunk.emit_op_arg16(opCode::STORE_LOCAL, 1, 1);
+    chunk.emit_op(opCode::POP, 1);
+
+    Peephole::optimizeChunk(&chunk);
+
+    EXPECT_EQ(chunk[4], static_cast<uint8_t>(opCode::LOAD_LOCAL));
+}
+
+TEST_F(PeepholeTest, FuseLoopAndField)
+{
+    auto output = optimizedDisassembly(R"(
+        class Point {
+            init(x) { this.x = x; }
+            getX() { return this.x; }
+        }
+        fun sum(n) {
+            var total = 0;
+            for (var i = 0; i < n; i += 1) {
+                total = total + i;
+            }
+            while (total >= 100) {
+                total -= 7;
+            }
+            return total;
+        }
+    )");
+    EXPECT_NE(output.find("INC_LOCAL"), String::npos) << output;
+    EXPECT_NE(output.find("LOCAL_LOCAL_CMP_JUMP"), String::npos) << output;
+    EXPECT_NE(output.find("LOCAL_CONST_CMP_JUMP"), String::npos) << output;
+    EXPECT_NE(output.find("LOAD_LOCAL_FIELD"), String::npos) << output;
+}
+
+// 计数循环尾部的自增、比较和回边融合为一条 FOR_RANGE，循环头的条件判断保持不变
+TEST_F(PeepholeTest, FuseCountedForLoop)
+{
+    auto output = optimizedDisassembly(R"(
+        fun sum(n) {
+            var s = 0;
+            for (var i = 0; i < n; i++) { s = s + i; }
+            return s;
+        }
+    )");
+    auto pos = output.find("FOR_RANGE");
+    ASSERT_NE(pos, String::npos) << output;
+    EXPECT_EQ(output.find("FOR_RANGE", pos + 1), String::npos) << output;
+    EXPECT_NE(output.find("LOCAL_LOCAL_CMP_JUMP"), String::npos) << output;
+}
+
+class PeepholeVMTest : public ::testing::Test
+{
+public:
+    void SetUp() override { vm = new AriaVM(); }
+    void TearDown() override { delete vm; }
+
+    String run(const char *source, InterpretResult expected = InterpretResult::SUCCESS)
+    {
+        CaptureStdout();
+        auto result = vm->interpret(String{source});
+        auto output = GetCapturedStdout();
+        EXPECT_EQ(result, expected) << output;
+        return output;
+    }
+
+    AriaVM *vm = nullptr;
+};
+
+TEST_F(PeepholeVMTest, NumericLoop)
+{
+    auto output = run(R"(
+        fun sum(n) {
+            var total = 0;
+            for (var i = 0; i < n; i += 1) {
+                total = total + i;
+            }
+            var j = 10;
+            while (j > 0) { j -= 3; }
+            return total + j;
+        }
+        print sum(100);
+    )");
+    EXPECT_EQ(output, "4948\n");
+}
+
+// 守卫失败时退化为原始指令序列
+TEST_F(PeepholeVMTest, FallbackForNonNumbers)
+{
+    auto output = run(R"(
+        fun f() {
+            var s = "a";
+            s += "b";
+            var n = 1.5;
+            n -= 0.5;
+            print n;
+            return s;
+        }
+        print f();
+    )");
+    EXPECT_EQ(output, "1\nab\n");
+}
+
+TEST_F(PeepholeVMTest, FallbackRuntimeError)
+{
+    run(R"(
+        fun f() {
+            var a = "a";
+            var b = "b";
+            if (a < b) { print "unreachable"; }
+        }
+        f();
+    )",
+        InterpretResult::RUNTIME_ERROR);
+}
+
+TEST_F(PeepholeVMTest, LoadLocalField)
+{
+    auto output = run(R"(
+        class Point {
+            init(x) { this.x = x; }
+            getX() { return this.x; }
+        }
+        var p = Point(7);
+        print p.getX();
+    )");
+    EXPECT_EQ(output, "7\n");
+}
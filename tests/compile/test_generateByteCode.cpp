@@ -121,7 +121,7 @@ TEST_F(CompileGenByteCodeTest, GenByteCode3Test)
                           "000029      7 POP_N              2\n"
                           "000031      8 LOAD_CONST         (4) 'world'\n"
                           "000034      | DEF_GLOBAL         a\n"
-                          "000037      9 LOAD_CONST         (6) 100\n"
+                          "000037      9 LOAD_CONST         (5) 100\n"
                           "000040      | STORE_GLOBAL       a\n"
                           "000043      | POP\n"
                           "000044     10 LOAD_GLOBAL        a\n"
@@ -172,57 +172,57 @@ TEST_F(CompileGenByteCodeTest, GenByteCode4Test)
     aria::String result = "  ========  example4  ========\n"
                           "000000      2 LOAD_CONST         (0) 'world'\n"
                           "000003      | DEF_GLOBAL         a\n"
-                          "000006      3 LOAD_CONST         (2) 100\n"
+                          "000006      3 LOAD_CONST         (1) 100\n"
                           "000009      | STORE_GLOBAL       a\n"
                           "000012      | POP\n"
                           "000013      4 LOAD_GLOBAL        a\n"
-                          "000016      | LOAD_CONST         (5) 10\n"
+                          "000016      | LOAD_CONST         (2) 10\n"
                           "000019      | EQUAL\n"
                           "000020      | JUMP_FALSE         20 -> 30\n"
-                          "000023      5 LOAD_CONST         (6) 'a is 10'\n"
+                          "000023      5 LOAD_CONST         (3) 'a is 10'\n"
                           "000026      | PRINT\n"
                           "000027      | JUMP_BWD           27 -> 51\n"
                           "000030      6 LOAD_GLOBAL        a\n"
-                          "000033      | LOAD_CONST         (8) 10\n"
+                          "000033      | LOAD_CONST         (4) 10\n"
                           "000036      | LESS\n"
                           "000037      | JUMP_FALSE         37 -> 47\n"
-                          "000040      7 LOAD_CONST         (9) 'a is less than 10'\n"
+                          "000040      7 LOAD_CONST         (5) 'a is less than 10'\n"
                           "000043      | PRINT\n"
                           "000044      | JUMP_BWD           44 -> 51\n"
-                          "000047      9 LOAD_CONST         (10) 'a is greater than 10'\n"
+                          "000047      9 LOAD_CONST         (6) 'a is greater than 10'\n"
                           "000050      | PRINT\n"
                           "000051     11 LOAD_GLOBAL        a\n"
-                          "000054      | LOAD_CONST         (12) 24\n"
+                          "000054      | LOAD_CONST         (7) 24\n"
                           "000057      | ADD\n"
                           "000058      | STORE_GLOBAL       a\n"
                           "000061      | POP\n"
                           "000062     12 LOAD_GLOBAL        a\n"
-                          "000065      | LOAD_CONST         (15) 4\n"
+                          "000065      | LOAD_CONST         (8) 4\n"
                           "000068      | SUBTRACT\n"
                           "000069      | STORE_GLOBAL       a\n"
                           "000072      | POP\n"
                           "000073     13 LOAD_GLOBAL        a\n"
-                          "000076      | LOAD_CONST         (18) 2\n"
+                          "000076      | LOAD_CONST         (9) 2\n"
                           "000079      | MULTIPLY\n"
                           "000080      | STORE_GLOBAL       a\n"
                           "000083      | POP\n"
                           "000084     14 LOAD_GLOBAL        a\n"
-                          "000087      | LOAD_CONST         (21) 6\n"
+                          "000087      | LOAD_CONST         (10) 6\n"
                           "000090      | DIVIDE\n"
                           "000091      | STORE_GLOBAL       a\n"
                           "000094      | POP\n"
                           "000095     15 LOAD_GLOBAL        a\n"
-                          "000098      | LOAD_CONST         (24) 13\n"
+                          "000098      | LOAD_CONST         (11) 13\n"
                           "000101      | MOD\n"
                           "000102      | STORE_GLOBAL       a\n"
                           "000105      | POP\n"
                           "000106     17 LOAD_GLOBAL        a\n"
-                          "000109      | LOAD_CONST         (27) 1\n"
+                          "000109      | LOAD_CONST         (12) 1\n"
                           "000112      | ADD\n"
                           "000113      | STORE_GLOBAL       a\n"
                           "000116      | POP\n"
                           "000117     18 LOAD_GLOBAL        a\n"
-                          "000120      | LOAD_CONST         (30) 1\n"
+                          "000120      | LOAD_CONST         (13) 1\n"
                           "000123      | SUBTRACT\n"
                           "000124      | STORE_GLOBAL       a\n"
                           "000127      | POP\n"
@@ -269,24 +269,24 @@ TEST_F(CompileGenByteCodeTest, GenByteCode5Test)
                           "000000      2 LOAD_CONST         (0) 0\n"
                           "000003      | DEF_GLOBAL         i\n"
                           "000006      3 LOAD_GLOBAL        i\n"
-                          "000009      | LOAD_CONST         (3) 10\n"
+                          "000009      | LOAD_CONST         (1) 10\n"
                           "000012      | LESS\n"
                           "000013      | JUMP_FALSE         13 -> 72\n"
-                          "000016      4 LOAD_CONST         (4) 1\n"
+                          "000016      4 LOAD_CONST         (2) 1\n"
                           "000019      | LOAD_GLOBAL        i\n"
                           "000022      5 LOAD_GLOBAL        i\n"
-                          "000025      | LOAD_CONST         (7) 1\n"
+                          "000025      | LOAD_CONST         (3) 1\n"
                           "000028      | ADD\n"
                           "000029      | STORE_GLOBAL       i\n"
                           "000032      | POP\n"
                           "000033      6 LOAD_GLOBAL        i\n"
-                          "000036      | LOAD_CONST         (10) 3\n"
+                          "000036      | LOAD_CONST         (4) 3\n"
                           "000039      | EQUAL\n"
                           "000040      | JUMP_FALSE         40 -> 48\n"
                           "000043      7 POP_N              2\n"
                           "000045      | JUMP_FWD           45 -> 6\n"
                           "000048      9 LOAD_GLOBAL        i\n"
-                          "000051      | LOAD_CONST         (12) 7\n"
+                          "000051      | LOAD_CONST         (5) 7\n"
                           "000054      | EQUAL\n"
                           "000055      | JUMP_FALSE         55 -> 63\n"
                           "000058     10 POP_N              2\n"
@@ -335,7 +335,7 @@ TEST_F(CompileGenByteCodeTest, GenByteCode6Test)
                           "000003      | LOAD_LOCAL         base+1\n"
                           "000006      | LOAD_CONST         (1) 10\n"
                           "000009      | LESS\n"
-                          "000010      | JUMP_FALSE         10 -> 69\n"
+                          "000010      | JUMP_FALSE         10 -> 79\n"
                           "000013      3 LOAD_CONST         (2) 1\n"
                           "000016      | LOAD_LOCAL         base+1\n"
                           "000019      4 LOAD_LOCAL         base+1\n"
@@ -349,7 +349,7 @@ TEST_F(CompileGenByteCodeTest, GenByteCode6Test)
                           "000040      | EQUAL\n"
                           "000041      | JUMP_FALSE         41 -> 49\n"
                           "000044      8 POP_N              2\n"
-                          "000046      | JUMP_BWD           46 -> 69\n"
+                          "000046      | JUMP_BWD           46 -> 79\n"
                           "000049     10 LOAD_LOCAL         base+1\n"
                           "000052      | PRINT\n"
                           "000053     11 POP_N              2\n"
@@ -358,10 +358,14 @@ TEST_F(CompileGenByteCodeTest, GenByteCode6Test)
                           "000061      | ADD\n"
                           "000062      | STORE_LOCAL        base+1\n"
                           "000065      | POP\n"
-                          "000066      | JUMP_FWD           66 -> 3\n"
-                          "000069      | POP\n"
-                          "000070      | LOAD_NIL\n"
-                          "000071      | RETURN\n"
+                          "000066      | LOAD_LOCAL         base+1\n"
+                          "000069      | LOAD_CONST         (6) 10\n"
+                          "000072      | LESS\n"
+                          "000073      | JUMP_FALSE         73 -> 79\n"
+                          "000076      | JUMP_FWD           76 -> 13\n"
+                          "000079      | POP\n"
+                          "000080      | LOAD_NIL\n"
+                          "000081      | RETURN\n"
                           "  ======== chunk end  ========\n";
 
     auto lexer = aria::Lexer{source};
@@ -378,4 +382,46 @@ TEST_F(CompileGenByteCodeTest, GenByteCode6Test)
 
     auto output = testing::internal::GetCapturedStdout();
     EXPECT_EQ(output, result);
-}
\ No newline at end of file
+}
+TEST_F(CompileGenByteCodeTest, GenRegisterByteCodeTest)
+{
+    aria::String source = R"(
+    fun scale(a, b) {
+        var c = a + b * 2;
+        if (c > 10 and a != b) {
+            return c;
+        }
+        return -c;
+    }
+)";
+
+    // r0 被调用者，r1-r2 参数，r3-r5 字面量 2、10、nil，r6 局部变量 c，r7 临时值
+    aria::String result = "  ========   scale    ========\n"
+                          "000000      3 REG_MULTIPLY       r7 r2 r3\n"
+                          "000004      | REG_ADD            r6 r1 r7\n"
+                          "000008      4 REG_GREATER_JUMP   r6 > r4 else 8 -> 20\n"
+                          "000013      | REG_NOT_EQUAL_JUMP r1 != r2 else 13 -> 20\n"
+                          "000018      5 REG_RETURN         r6\n"
+                          "000020      7 REG_NEGATE         r7 r6\n"
+                          "000023      | REG_RETURN         r7\n"
+                          "000025      8 REG_RETURN         r5\n"
+                          "  ======== chunk end  ========\n";
+
+    auto lexer = aria::Lexer{source};
+    auto tokens = lexer.tokenize();
+    EXPECT_FALSE(lexer.had_error());
+    auto parser = aria::Parser{tokens};
+    auto ast = parser.parse();
+    EXPECT_FALSE(parser.hasError());
+    aria::ByteCodeGenerator generator =
+        aria::ByteCodeGenerator{"anonymous", "script", nullptr, gc, aria::CodeBackend::REGISTER};
+    auto fn = generator.generateCode(ast);
+    auto scale = aria::as_obj_function(fn->chunk_->consts_[0]);
+    EXPECT_EQ(scale->frame_size_, 8);
+    testing::internal::CaptureStdout();
+
+    scale->chunk_->disassemble("scale");
+
+    auto output = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(output, result);
+}
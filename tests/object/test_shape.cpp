@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "tests/gc/gc_init.h"
+
+#include "src/object/objClass.h"
+#include "src/object/objInstance.h"
+#include "src/object/objString.h"
+#include "src/object/shape.h"
+
+using namespace aria;
+
+class ShapeTest : public ObjectTestFixture
+{
+};
+
+// 相同顺序添加相同字段的实例共享同一个 shape
+TEST_F(ShapeTest, TransitionsAreShared)
+{
+    ObjString *x = new_ObjString("x", gc);
+    ObjString *y = new_ObjString("y", gc);
+    Shape *root = gc->root_shape_;
+
+    Shape *sx = root->add_field(x);
+    EXPECT_EQ(root->add_field(x), sx);
+    EXPECT_EQ(sx->field_count(), 1);
+    EXPECT_EQ(sx->lookup(x), 0);
+    EXPECT_EQ(sx->lookup(y), -1);
+
+    Shape *sxy = sx->add_field(y);
+    Shape *syx = root->add_field(y)->add_field(x);
+    EXPECT_NE(sxy, syx);
+    EXPECT_EQ(sxy->lookup(y), 1);
+    EXPECT_EQ(syx->lookup(y), 0);
+    EXPECT_EQ(sxy->field_name(0), x);
+}
+
+// 字段较多时切换为哈希索引
+TEST_F(ShapeTest, ManyFields)
+{
+    Shape *shape = gc->root_shape_;
+    List<ObjString *> names;
+    for (int i = 0; i < 20; i++) {
+        names.push_back(new_ObjString(format("f{}", i), gc));
+        shape = shape->add_field(names.back());
+    }
+    EXPECT_EQ(shape->field_count(), 20);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(shape->lookup(names[i]), i);
+    }
+    EXPECT_EQ(shape->lookup(new_ObjString("missing", gc)), -1);
+}
+
+// 实例字段保存在槽位数组中，超过内联容量后扩容
+TEST_F(ShapeTest, InstanceSlots)
+{
+    ObjClass *klass = new_ObjClass(new_ObjString("Point", gc), gc);
+    GcTempRootGuard guard{gc, NanBox::fromObj(klass)};
+    ObjInstance *instance = new_ObjInstance(klass, gc);
+    guard.push(NanBox::fromObj(instance));
+
+    const uint32_t count = ObjInstance::k_inline_slots * 3;
+    for (uint32_t i = 0; i < count; i++) {
+        instance->set_by_field(new_ObjString(format("f{}", i), gc), NanBox::fromNumber(i));
+    }
+    EXPECT_EQ(instance->shape_->field_count(), count);
+    EXPECT_NE(instance->slots_, instance->inline_slots_);
+
+    for (uint32_t i = 0; i < count; i++) {
+        Value value;
+        EXPECT_TRUE(NanBox::toBool(
+            instance->get_by_field(new_ObjString(format("f{}", i), gc), value)));
+        EXPECT_EQ(NanBox::toNumber(value), i);
+    }
+
+    // 覆盖已有字段不改变 shape
+    Shape *shape = instance->shape_;
+    instance->set_by_field(new_ObjString("f0", gc), NanBox::fromNumber(42));
+    EXPECT_EQ(instance->shape_, shape);
+    EXPECT_EQ(NanBox::toNumber(instance->slots_[0]), 42);
+}
+
+// 字段相同但添加顺序不同的实例仍然相等
+TEST_F(ShapeTest, InstanceEquality)
+{
+    ObjClass *klass = new_ObjClass(new_ObjString("Point", gc), gc);
+    GcTempRootGuard guard{gc, NanBox::fromObj(klass)};
+    ObjInstance *a = new_ObjInstance(klass, gc);
+    guard.push(NanBox::fromObj(a));
+    ObjInstance *b = new_ObjInstance(klass, gc);
+    guard.push(NanBox::fromObj(b));
+    ObjString *x = new_ObjString("x", gc);
+    ObjString *y = new_ObjString("y", gc);
+
+    a->set_by_field(x, NanBox::fromNumber(1));
+    a->set_by_field(y, NanBox::fromNumber(2));
+    b->set_by_field(y, NanBox::fromNumber(2));
+    b->set_by_field(x, NanBox::fromNumber(1));
+    EXPECT_NE(a->shape_, b->shape_);
+    EXPECT_TRUE(values_equal(NanBox::fromObj(a), NanBox::fromObj(b)));
+
+    Value copy = a->copy(gc);
+    EXPECT_EQ(as_obj_instance(copy)->shape_, a->shape_);
+    EXPECT_TRUE(values_equal(copy, NanBox::fromObj(a)));
+
+    b->set_by_field(x, NanBox::fromNumber(3));
+    EXPECT_FALSE(values_equal(NanBox::fromObj(a), NanBox::fromObj(b)));
+}
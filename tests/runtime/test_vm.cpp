@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "src/debugger/debugger.h"
+#include "src/runtime/opProfiler.h"
 #include "src/runtime/vm.h"
 
 using namespace aria;
@@ -74,6 +80,33 @@ TEST_F(VMTest, PrintNil)
     EXPECT_TRUE(runAndExpect("print nil;", "nil"));
 }
 
+TEST_F(VMTest, PrintStreamsNestedContainers)
+{
+    // 列表、映射和字符串直接写入输出缓冲，自引用的容器同样按 [...] / {...} 输出
+    EXPECT_TRUE(runAndExpect(R"(
+var l = [1, "a", {"k": [2.5, nil, true]}];
+l.append(l);
+print l;
+println("{}|{}", l, "x");
+var m = {"self": nil};
+m["self"] = m;
+print m;
+)",
+        "[1,'a',{'k':[2.5,nil,true]},[...]]\n[1,'a',{'k':[2.5,nil,true]},[...]]|x\n{'self':{...}}"));
+}
+
+TEST_F(VMTest, BufferedOutputFlushedBeforeRuntimeError)
+{
+    CaptureStdout();
+    auto result = vm->interpret(String{R"(
+print "before";
+var x = nil + 1;
+)"});
+    auto output = GetCapturedStdout();
+    EXPECT_EQ(result, InterpretResult::RUNTIME_ERROR);
+    EXPECT_EQ(output, "before\n");
+}
+
 // ==================== 算术运算 ====================
 
 TEST_F(VMTest, Arithmetic)
@@ -93,8 +126,54 @@ TEST_F(VMTest, ArithmeticPrecedence)
     EXPECT_TRUE(runAndExpect("print 10 - 2 - 3;", "5"));
 }
 
+// 同一条指令先以数字执行（被加速为 *_NUM），之后遇到字符串时需退回通用实现
+TEST_F(VMTest, QuickenedArithmeticFallback)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun add(a, b) { return a + b; }
+        fun less(a, b) { return a < b; }
+        var r = add(1, 2);
+        r = add(r, 3);
+        var s = add("a", "b");
+        print add(r, 4);
+        print s;
+        print less(1, 2);
+        print less(3, 2);
+        )",
+        "10\nab\ntrue\nfalse"));
+}
+
+TEST_F(VMTest, QuickenedDivisionByZero)
+{
+    runAndExpectRuntimeError(R"(
+        fun div(a, b) { return a / b; }
+        div(6, 3);
+        div(1, 0);
+    )");
+}
+
+TEST_F(VMTest, QuickenedComparisonTypeError)
+{
+    runAndExpectRuntimeError(R"(
+        fun less(a, b) { return a < b; }
+        less(1, 2);
+        less("a", "b");
+    )");
+}
+
 // ==================== 比较运算 ====================
 
+// 小整数溢出时提升为 double，输出与 double 运算一致
+TEST_F(VMTest, IntegerOverflow)
+{
+    EXPECT_TRUE(runAndExpect("var a = 2147483647; print a + 1;", "2147483648"));
+    EXPECT_TRUE(runAndExpect("print 65536 * 65536;", "4294967296"));
+    EXPECT_TRUE(runAndExpect("print 0 * -1;", "-0"));
+    EXPECT_TRUE(runAndExpect("print 7 / 2;", "3.5"));
+    EXPECT_TRUE(runAndExpect("var l = [1, 2, 3]; print l[4 / 2];", "3"));
+}
+
 TEST_F(VMTest, Comparison)
 {
     EXPECT_TRUE(runAndExpect("print 1 < 2;", "true"));
@@ -316,6 +395,128 @@ print d.sum();
         "7"));
 }
 
+// 同一个字段访问点先后遇到不同 shape 的实例，内联缓存需要正确失效
+TEST_F(VMTest, FieldInlineCacheShapes)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+class A { init() { this.x = 1; this.y = 2; } }
+class B { init() { this.y = 20; this.x = 10; } }
+fun getY(o) { return o.y; }
+fun setY(o, v) { o.y = v; }
+var a = A();
+var b = B();
+var out = getY(a) + getY(b) + getY(a);
+setY(a, 5);
+setY(b, 50);
+print out + getY(a) + getY(b);
+)",
+        "79"));
+}
+
+// 构造函数中添加的字段超过内联槽位容量
+TEST_F(VMTest, FieldInlineCacheManyFields)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+class Wide {
+    init(v) {
+        this.a = v; this.b = v; this.c = v; this.d = v;
+        this.e = v; this.f = v; this.g = v; this.h = v + 1;
+    }
+}
+var sum = 0;
+for (var i = 0; i < 10; i += 1) {
+    var w = Wide(i);
+    w.z = w.h;
+    sum = sum + w.a + w.z;
+}
+print sum;
+)",
+        "100"));
+}
+
+// INVOKE_METHOD：方法、同名字段、内置类型方法
+TEST_F(VMTest, InvokeMethod)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+class Counter {
+    init() { this.n = 0; }
+    add(k) { this.n = this.n + k; return this; }
+    get() { return this.n; }
+}
+var c = Counter();
+for (var i = 0; i < 5; i += 1) { c.add(i).add(1); }
+fun hello() { return "field"; }
+var d = Counter();
+d.get = hello;
+var l = [1, 2];
+l.append(3);
+println("{} {} {} {} {}", c.get(), d.get(), l.size(), "abc".length(), {"k": 1}.size());
+)",
+        "15 field 3 3 1"));
+}
+
+TEST_F(VMTest, InvokeMethodErrors)
+{
+    runAndExpectRuntimeError(R"(
+class A {}
+A().missing();
+)");
+    runAndExpectRuntimeError("var x = 1; x.foo();");
+    runAndExpectRuntimeError(R"(
+class A { f(a) { return a; } }
+A().f(1, 2);
+)");
+}
+
+TEST_F(VMTest, MethodsAsFirstClassValues)
+{
+    // 读取方法时才创建 bound method，它绑定读取时的接收者
+    EXPECT_TRUE(runAndExpect(R"(
+class Box {
+    init(v) { this.v = v; }
+    get() { return this.v; }
+}
+var a = Box(1);
+var b = Box(2);
+var getA = a.get;
+var getB = b.get;
+var l = [1];
+var push = l.append;
+push(2);
+var m = {"k": 3};
+var keys = m.keys;
+var it = iter([4]);
+var next = it.next;
+println("{} {} {} {} {}", getA(), getB(), l, keys(), next());
+println("{} {} {}", equals(a.get, a.get), equals(a.get, b.get), equals(l.append, push));
+)",
+        "1 2 [1,2] ['k'] 4\ntrue false true"));
+}
+
+// 全局变量可以覆盖同名内置函数，但不能对未定义的全局变量赋值
+TEST_F(VMTest, GlobalShadowsBuiltin)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+fun f() { return str; }
+print typeof(str);
+var str = 3;
+print f() + 1;
+)",
+        "4"));
+    runAndExpectRuntimeError("typeof = 1;");
+    runAndExpectRuntimeError("print undefinedGlobal;");
+    runAndExpectRuntimeError("undefinedGlobal = 1;");
+}
+
+// 多次 interpret（REPL）共享同一张全局变量表
+TEST_F(VMTest, GlobalsAcrossInterpret)
+{
+    EXPECT_TRUE(runAndExpect("var counter = 1; fun get() { return counter; }", ""));
+    EXPECT_TRUE(runAndExpect("counter = counter + 41; print get();", "42"));
+    runAndExpectRuntimeError("var counter = 7;");
+    EXPECT_TRUE(runAndExpect("print counter;", "7"));
+}
+
 // ==================== 列表 ====================
 
 TEST_F(VMTest, ListBasic)
@@ -340,6 +541,23 @@ print list[3];
         "4"));
 }
 
+// 下标读写的列表快速路径：范围外、负数和非整数下标仍按 get_by_index / set_by_index 报错
+TEST_F(VMTest, ListSubscriptFastPath)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+var l = [1, 2];
+for (var i = 0; i < 6; i += 1) { l.append(i * 10); }
+l[0] = l[7] + l[1.0];
+var x = l[2] = 5;
+print str(l) + " " + str(x);
+)",
+        "[52,2,5,10,20,30,40,50] 5"));
+    runAndExpectRuntimeError("var l = [1]; print l[1];");
+    runAndExpectRuntimeError("var l = [1]; print l[-1];");
+    runAndExpectRuntimeError("var l = [1]; l[1] = 2;");
+    runAndExpectRuntimeError("var l = [1]; l[0.5] = 2;");
+}
+
 // ==================== Map ====================
 
 TEST_F(VMTest, MapBasic)
@@ -381,6 +599,36 @@ print result;
         "catch"));
 }
 
+// catch 块不在 try 的保护范围内，其中抛出的异常交给外层处理器；
+// 从 try 块中 break/return 离开后，这个 try 不再捕获异常
+TEST_F(VMTest, TryCatchHandlerRanges)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+try {
+    try { throw "inner"; } catch (e) { print "in " + e; throw "rethrow"; }
+} catch (e) {
+    print "outer " + e;
+}
+fun early() { try { return 1; } catch (e) { return 2; } }
+for (var i = 0; i < 3; i = i + 1) {
+    try { if (i == 1) { break; } } catch (e) { print "never"; }
+}
+var a = 1;
+fun f() {
+    var x = early() + 9;
+    try { var y = [1, 2]; var z = 3; y[5]; } catch (e) { return x + a; }
+}
+try { print f(); throw "last"; } catch (e) { print e; }
+)",
+        "in inner\nouter rethrow\n11\nlast\n"));
+    runAndExpectRuntimeError(R"(
+for (var i = 0; i < 3; i = i + 1) {
+    try { break; } catch (e) { print "never"; }
+}
+throw "uncaught";
+)");
+}
+
 // 跨帧抛异常时，被越过的中间帧里 open upvalue 必须被正确 close，
 // 否则 stack_.resize 后闭包读取的将是悬挂/被覆盖的栈槽。
 TEST_F(VMTest, UnwindClosesUpvaluesAcrossFrames)
@@ -418,6 +666,100 @@ print sum;
         "15"));
 }
 
+TEST_F(VMTest, ForInStringMapAndIterator)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+var out = "";
+for (c in "abc") { out = out + c + "-"; }
+print out;
+var n = 0;
+for (p in {"a": 1, "b": 2, "c": 3}) { n = n + p[1]; }
+print n;
+for (x in iter([7, 8])) { print x; }
+for (x in []) { print "never"; }
+for (x in [1, 2, 3, 4]) {
+    if (x == 2) { continue; }
+    if (x == 4) { break; }
+    for (y in "xy") { print y; print x; }
+}
+)",
+        "a-b-c-\n6\n7\n8\nx\n1\ny\n1\nx\n3\ny\n3\n"));
+    runAndExpectRuntimeError("for (x in 5) { print x; }");
+}
+
+// 列表由 FOR_ITER 按游标遍历，每个元素只分发一条循环控制指令
+TEST_F(VMTest, ForInListDispatchesOneInstructionPerElement)
+{
+    OpProfiler profiler;
+    vm->set_op_profiler(&profiler);
+    EXPECT_TRUE(runAndExpect(R"(
+var items = [];
+for (var i = 0; i < 1000; i = i + 1) { items.append(i); }
+var s = 0;
+for (v in items) { s = s + v; }
+print s;
+)",
+        "499500"));
+    vm->set_op_profiler(nullptr);
+    EXPECT_EQ(profiler.count(opCode::GET_ITER), 1u);
+    EXPECT_EQ(profiler.count(opCode::FOR_ITER), 1001u);
+}
+
+TEST_F(VMTest, RangeIsLazyAndReusable)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+var r = range(0, 10, 3);
+for (x in r) { print x; }
+for (x in r) { print x; }
+for (x in range(5, 0, -2)) { print x; }
+for (x in range(3)) { print x; }
+for (x in range(2, 2)) { print x; }
+print r.next();
+print r.next();
+)",
+        "0\n3\n6\n9\n0\n3\n6\n9\n5\n3\n1\n0\n1\n2\n0\n3"));
+    runAndExpectRuntimeError("range(0, 10, 0);");
+    runAndExpectRuntimeError("range(0, \"a\");");
+}
+
+// 计数循环被旋转为循环尾判断条件，FOR_RANGE 的融合见 test_peephole.cpp
+TEST_F(VMTest, CountedForLoopInFunction)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+fun sum(n) {
+    var s = 0;
+    for (var i = 0; i < n; i++) { s = s + i; }
+    return s;
+}
+print sum(100);
+)",
+        "4950"));
+}
+
+TEST_F(VMTest, CountedForLoopControlFlowAndFallback)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+for (var i = 10; i > 0; i = i - 4) { print i; }
+for (var i = 0; i < 10; i++) {
+    if (i == 1) { continue; }
+    if (i == 3) { break; }
+    print i;
+}
+for (var i = 0; i < 0; i++) { print "never"; }
+for (var d = 0.5; d < 2; d++) { print d; }
+fun sum(n) {
+    var s = 0;
+    for (var i = 1; i <= n; i++) {
+        if (i % 2 == 0) { continue; }
+        s = s + i;
+    }
+    return s;
+}
+print sum(3000);
+)",
+        "10\n6\n2\n0\n2\n0.5\n1.5\n2250000"));
+}
+
 // ==================== 编译错误 ====================
 
 TEST_F(VMTest, CompileError)
@@ -483,3 +825,622 @@ print add10(3);
 )",
         "13"));
 }
+
+TEST_F(VMTest, ClosuresShareOnePrototype)
+{
+    // 同一原型创建的多个闭包各自持有捕获变量
+    EXPECT_TRUE(runAndExpect(R"(
+fun counter() {
+    var n = 0;
+    fun inc() { n = n + 1; return n; }
+    return inc;
+}
+var a = counter();
+var b = counter();
+a(); a();
+b();
+print typeof(a) + " " + str(a() * 10 + b());
+)",
+        "function 32"));
+}
+
+TEST_F(VMTest, SuperInClassDeclaredTwice)
+{
+    // 同一个类声明执行两次：各自的方法闭包记录各自的类，super 不会指向后创建的类
+    EXPECT_TRUE(runAndExpect(R"(
+class A { hi() { return "A"; } }
+class B { hi() { return "B"; } }
+fun make(base) {
+    class D : base {
+        init() { super.hi(); }
+        hi() { return "D" + super.hi(); }
+    }
+    return D;
+}
+var da = make(A);
+var db = make(B);
+print da().hi() + db().hi() + da().hi();
+)",
+        "DADBDA"));
+}
+
+TEST_F(VMTest, LocalFunctionRecursion)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+fun outer(k) {
+    fun fact(n) {
+        if (n <= 1) return k;
+        return n * fact(n - 1);
+    }
+    return fact(5);
+}
+print outer(2);
+)",
+        "240"));
+}
+
+TEST_F(VMTest, MethodCapturesEnclosingLocal)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+fun make(prefix) {
+    class Greeter {
+        init(name) { this.name = name; }
+        greet() { return prefix + this.name; }
+    }
+    return Greeter;
+}
+var g = make("hi ")("aria");
+var m = g.greet;
+print g.greet() + "|" + m();
+)",
+        "hi aria|hi aria"));
+}
+
+TEST_F(VMTest, OpenUpvaluesFollowStackGrowth)
+{
+    // 每层递归的 open upvalue 挂在各自栈帧上，值栈扩容后仍指向正确的槽位
+    EXPECT_TRUE(runAndExpect(R"(
+fun dive(n) {
+    var v = n;
+    fun get() { return v; }
+    if (n > 0) {
+        var inner = dive(n - 1);
+        v = v + inner();
+    }
+    return get;
+}
+print dive(2000)();
+)",
+        "2001000"));
+}
+
+TEST_F(VMTest, LoopScopeCapturesAreIndependent)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+fun build() {
+    var fs = [];
+    for (var i = 0; i < 3; i = i + 1) {
+        var j = i * 10;
+        fun f() { return j; }
+        fs.append(f);
+    }
+    return fs;
+}
+var fs = build();
+print str(fs[0]()) + "," + str(fs[1]()) + "," + str(fs[2]());
+)",
+        "0,10,20"));
+}
+
+TEST_F(VMTest, CallSiteCacheSwitchesCallee)
+{
+    // 同一调用点依次调用函数、闭包、原生函数和类，缓存未命中时回到通用路径
+    EXPECT_TRUE(runAndExpect(R"(
+class Box { init(v) { this.v = v; } }
+class Empty {}
+fun twice(x) { return x * 2; }
+fun make(k) { fun add(x) { return x + k; } return add; }
+fun apply(f, x) { return f(x); }
+var out = "";
+for (var i = 0; i < 3; i = i + 1) {
+    out = out + str(apply(twice, i)) + str(apply(make(i), 1)) + str(apply(str, i));
+    out = out + str(apply(Box, i).v) + ";";
+}
+fun build(c) { return c(); }
+print out + str(typeof(build(Empty)) == typeof(Empty()));
+)",
+        "0100;2211;4322;true"));
+}
+
+TEST_F(VMTest, CallSiteCacheKeepsArityCheck)
+{
+    runAndExpectRuntimeError(R"(
+fun one(a) { return a; }
+fun two(a, b) { return a + b; }
+fun apply(f) { return f(1); }
+apply(one);
+apply(one);
+apply(two);
+)");
+}
+
+TEST_F(VMTest, PrintlnTakesArgumentsFromStack)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+println("{}-{}-{}", 1, "a", [2]);
+println("{} {}", 7);
+println("{}", 8, 9);
+println("plain");
+)",
+        "1-a-[2]\n7 {}\n8\nplain"));
+}
+
+TEST_F(VMTest, LazyRestIndexAndIterate)
+{
+    // 只被下标访问和 for-in 遍历的剩余参数不生成列表
+    EXPECT_TRUE(runAndExpect(R"(
+fun sum(first, ...rest) {
+    var s = first;
+    for (x in rest) { s = s + x; }
+    return s * 100 + rest[0] + rest[1.0];
+}
+fun count(...rest) {
+    var n = 0;
+    for (x in rest) { n = n + 1; }
+    return n;
+}
+print str(sum(1, 2, 3, 4)) + "," + str(count()) + "," + str(count(1, 2, 3));
+)",
+        "1005,0,3"));
+}
+
+TEST_F(VMTest, LazyRestMaterializesWhenUsedAsValue)
+{
+    EXPECT_TRUE(runAndExpect(R"(
+fun show(...rest) { var first = rest[0]; print rest; return first; }
+fun grow(...rest) { rest.append(9); return rest; }
+fun reset(...rest) { rest = [0]; return rest[0]; }
+fun capture(...rest) { fun get() { return rest[1]; } return get; }
+show(1, 2);
+print str(grow(1)) + str(reset(5, 6)) + str(capture(3, 4)());
+)",
+        "[1,2]\n[1,9]04"));
+}
+
+TEST_F(VMTest, LazyRestIterateSeesMaterializedList)
+{
+    // 循环体把剩余参数用作值后，for-in 继续遍历生成的列表，与遍历普通列表一致
+    EXPECT_TRUE(runAndExpect(R"(
+fun b(...args) {
+    for (v in args) {
+        args.append(v);
+        if (args.size() > 6) break;
+    }
+    return args;
+}
+fun c(list) {
+    for (v in list) {
+        list.append(v);
+        if (list.size() > 6) break;
+    }
+    return list;
+}
+print str(b(1, 2)) + str(c([1, 2]));
+)",
+        "[1,2,1,2,1,2,1][1,2,1,2,1,2,1]"));
+}
+
+TEST_F(VMTest, LazyRestIndexOutOfRange)
+{
+    runAndExpectRuntimeError(R"(
+fun at(i, ...rest) { return rest[i]; }
+print at(0, 1);
+print at(1, 1);
+)");
+    runAndExpectRuntimeError(R"(
+fun at(...rest) { return rest[-1]; }
+at(1);
+)");
+}
+
+TEST_F(VMTest, LazyRestAcrossExceptionAndTailCall)
+{
+    // 异常跨过持有多余参数的栈帧、尾调用复用栈帧时 rest_args_ 都截断到正确位置
+    EXPECT_TRUE(runAndExpect(R"(
+fun boom(...rest) { throw rest[0]; }
+fun outer(...rest) {
+    try { boom(rest[1], 0); } catch (e) { return str(e) + str(rest[0]); }
+}
+fun loop(n, ...rest) {
+    if (n == 0) return rest[0] + rest[1];
+    return loop(n - 1, rest[1], rest[0] + 1);
+}
+print outer("a", "b") + "," + str(loop(1000, 0, 0)) + "," + outer("c", "d");
+)",
+        "ba,1000,dc"));
+}
+
+// ==================== 寄存器后端 ====================
+
+TEST_F(VMTest, RegisterBackendRecursion)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+fun fib(n) {
+    if (n < 2) return n;
+    return fib(n - 1) + fib(n - 2);
+}
+print fib(20);
+)",
+        "6765"));
+}
+
+TEST_F(VMTest, RegisterBackendLoops)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+fun run(n) {
+    var s = 0;
+    for (var i = 0; i < n; i++) {
+        if (i % 3 == 0 and i != 0) continue;
+        if (i >= 10) break;
+        s += i * 2 - 1;
+    }
+    var j = 0;
+    while (j < 3) {
+        j = j + 1;
+        s -= 1;
+    }
+    return s;
+}
+print run(100);
+)",
+        "44"));
+}
+
+TEST_F(VMTest, RegisterBackendGlobalsAndCalls)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+var total = 0;
+fun add(x) {
+    total = total + x;
+    return total;
+}
+fun twice(x) { return add(x) + add(x); }
+print str(twice(5)) + "," + str(total);
+)",
+        "15,10"));
+}
+
+TEST_F(VMTest, RegisterBackendAssignmentValues)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+fun f(a) {
+    var b = a;
+    var c = b + (b = b * 3) + (b += 1);
+    b *= 2;
+    return str(c) + "," + str(b) + "," + str(a);
+}
+print f(2);
+)",
+        "15,14,2"));
+}
+
+TEST_F(VMTest, RegisterBackendLogicAndStrings)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+fun pick(a, b) { return (a and b) or "none"; }
+fun neg(x) { return !x == false and -x < 0; }
+print pick(1, "yes") + pick(nil, 2) + str(neg(3)) + str(7 / 2);
+)",
+        "yesnonetrue3.5"));
+}
+
+TEST_F(VMTest, RegisterBackendMixedWithStackFunctions)
+{
+    // 使用闭包、类或容器的函数退回栈式字节码，两种函数可以互相调用
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+fun square(x) { return x * x; }
+fun make_adder(n) {
+    fun adder(x) { return square(x) + n; }
+    return adder;
+}
+class Box {
+    init(v) { this.v = v; }
+    get() { return square(this.v); }
+}
+fun sum(list, f) {
+    var s = 0;
+    for (x in list) { s = s + f(x); }
+    return s;
+}
+fun apply(f, x) { return f(x); }
+print apply(make_adder(1), 3) + Box(4).get() + sum([1, 2, 3], square);
+)",
+        "40"));
+}
+
+TEST_F(VMTest, RegisterBackendRuntimeErrors)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    runAndExpectRuntimeError("fun f(a) { return a < \"x\"; } f(1);");
+    runAndExpectRuntimeError("fun f(a) { return a / 0; } f(1);");
+    runAndExpectRuntimeError("fun f() { return undefined_name; } f();");
+    runAndExpectRuntimeError("fun f(a) { return a(); } f(1);");
+}
+
+TEST_F(VMTest, RegisterBackendCatchFromStackFrame)
+{
+    vm->set_backend(CodeBackend::REGISTER);
+    EXPECT_TRUE(runAndExpect(R"(
+fun inner(a) { return a + 1; }
+fun outer(a) { return inner(a) * 2; }
+try {
+    outer("s");
+} catch (e) {
+    print "caught";
+}
+print outer(1);
+)",
+        "caught\n4"));
+}
+
+// ==================== 基线 JIT ====================
+// 以下代码的调用次数和循环次数都超过 Jit::k_hot_threshold；未启用 JIT 时同样走解释器
+
+TEST_F(VMTest, JitHotLoopAndCalls)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun sum(n) {
+            var s = 0;
+            for (var i = 0; i < n; i++) { s = s + i * 2; }
+            return s;
+        }
+        fun inc(a) { return a + 1; }
+        var t = 0;
+        for (var i = 0; i < 3000; i++) { t = inc(t); }
+        print sum(100000);
+        print t;
+        )",
+        "9999900000\n3000"));
+}
+
+// int32 快速路径的守卫失败后交给慢路径：溢出、double 和字符串
+TEST_F(VMTest, JitGuardFallback)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun add(a, b) { return a + b; }
+        var big = 2147483000;
+        for (var i = 0; i < 2000; i++) { big = add(big, 1000); }
+        print big;
+        print add(0.5, 1);
+        print add("a", "b");
+        print add(3, 4) < add(2, 6);
+        )",
+        "2149483000\n1.5\nab\ntrue"));
+}
+
+// 已编译函数抛出的异常展开到解释器中的处理器，之后仍可继续调用
+TEST_F(VMTest, JitExceptionUnwind)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun f(a) { return a + nil; }
+        fun g(a) { return a * 2; }
+        var caught = 0;
+        for (var i = 0; i < 2000; i++) {
+            try { f(i); } catch (e) { caught = caught + 1; }
+        }
+        var s = 0;
+        for (var i = 0; i < 2000; i++) { s = s + g(i); }
+        print caught;
+        print s;
+        )",
+        "2000\n3998000"));
+    runAndExpectRuntimeError(R"(
+        fun div(a, b) { return a / b; }
+        for (var i = 1; i < 2000; i++) { div(6, i); }
+        div(1, 0);
+    )");
+}
+
+// ==================== 尾调用 ====================
+
+// 尾递归复用栈帧，递归深度远超调用栈大小
+TEST_F(VMTest, TailCallConstantStack)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun sum(n, acc) {
+            if (n == 0) { return acc; }
+            return sum(n - 1, acc + n);
+        }
+        fun isEven(n) { if (n == 0) { return true; } return isOdd(n - 1); }
+        fun isOdd(n) { if (n == 0) { return false; } return isEven(n - 1); }
+        print sum(100000, 0);
+        print isEven(10001);
+        )",
+        "5000050000\nfalse"));
+}
+
+// 被调用者不是 Aria 函数、参数个数不符或位于 try 块内时按普通调用执行
+TEST_F(VMTest, TailCallFallback)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        class Box { init(v) { this.v = v; } get() { return this.v; } }
+        fun make(v) { return Box(v); }
+        fun kind(v) { return typeof(v); }
+        fun bound(b) { var g = b.get; return g(); }
+        fun guarded(n) {
+            try { return make(n); } catch (e) { return nil; }
+        }
+        print make(3).get();
+        print kind(1);
+        print bound(Box(5));
+        print guarded(7).get();
+        )",
+        "3\nnumber\n5\n7"));
+    runAndExpectRuntimeError("fun f(a) { return a; } fun g() { return f(); } g();");
+}
+
+// 复用栈帧前关闭当前栈帧上被捕获的局部变量
+TEST_F(VMTest, TailCallClosesUpvalues)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun id(f) { return f; }
+        fun make() {
+            var x = 21;
+            fun get() { return x; }
+            return id(get);
+        }
+        fun clobber(a, b, c, d) { return a + b + c + d; }
+        var g = make();
+        clobber(1, 2, 3, 4);
+        print g() * 2;
+        )",
+        "42"));
+}
+
+// 调用栈和值栈按需扩容：深递归中捕获的 upvalue 在值栈搬迁后仍指向正确的槽位
+TEST_F(VMTest, DeepRecursionGrowsStacks)
+{
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun depth(n) {
+            if (n == 0) { return 0; }
+            return 1 + depth(n - 1);
+        }
+        fun capture(n) {
+            var x = n;
+            fun bump() { x = x + 1; return x; }
+            var d = depth(20000);
+            bump();
+            return x + d;
+        }
+        fun guarded(n) {
+            if (n == 0) { throw "bottom"; }
+            try { return guarded(n - 1); } catch (e) { return n; }
+        }
+        print depth(20000);
+        print depth(20000);
+        print capture(7);
+        print guarded(2000);
+        )",
+        "20000\n20000\n20008\n1"));
+}
+
+TEST_F(VMTest, UnboundedRecursionOverflows)
+{
+    runAndExpectRuntimeError(R"(
+        fun forever(n) { return 1 + forever(n + 1); }
+        forever(0);
+    )");
+}
+
+TEST_F(VMTest, TailCallIntoLargeFrameOverflows)
+{
+    // 尾调用在弹出当前栈帧之前预留被调用者的槽位，值栈耗尽时抛出的是栈溢出异常
+    String locals;
+    for (int i = 0; i < 2000; i++) {
+        locals += "var l" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+    }
+    String source = "fun f(n) { if (n == 0) return 0; return g(n); }\n"
+                    "fun g(n) {\n" + locals + "return f(n - 1) + l0;\n}\n"
+                    "try { f(100000); } catch (e) { print e; }\n";
+    EXPECT_TRUE(runAndExpect(source.c_str(), "<exception: Stack overflow.>"));
+}
+
+// ==================== 操作码统计 ====================
+
+TEST_F(VMTest, OpProfilerCountsOpcodes)
+{
+    OpProfiler profiler;
+    vm->set_op_profiler(&profiler);
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun add(a, b) { return a + b; }
+        var s = 0;
+        for (var i = 0; i < 2000; i = i + 1) { s = add(s, i); }
+        print s;
+        print 1;
+        print 2;
+        )",
+        "1999000\n1\n2"));
+    vm->set_op_profiler(nullptr);
+    profiler.finish();
+
+    // 统计期间不进入机器码，热函数的每次调用都计入
+    EXPECT_EQ(profiler.count(opCode::PRINT), 3u);
+    EXPECT_GE(profiler.count(opCode::CALL), 2000u);
+    EXPECT_EQ(profiler.pair_count(opCode::LOAD_CONST, opCode::PRINT), 2u);
+
+    std::ostringstream report;
+    profiler.report(report);
+    EXPECT_NE(report.str().find("PRINT"), std::string::npos);
+    std::ostringstream json;
+    profiler.write_json(json);
+    EXPECT_NE(json.str().find(R"("name": "CALL")"), std::string::npos);
+}
+
+TEST_F(VMTest, SamplingProfilerFoldsStacks)
+{
+    ASSERT_TRUE(vm->start_sampling(1000));
+    EXPECT_FALSE(vm->start_sampling(1000));
+    EXPECT_TRUE(runAndExpect(
+        R"(
+        fun spin() {
+            var t = clock();
+            var n = 0;
+            while (clock() - t < 0.3) { n = n + 1; }
+            return n > 0;
+        }
+        fun outer() { var r = spin(); return r; }
+        print outer();
+        )",
+        "true"));
+    const String folded = vm->stop_sampling();
+    EXPECT_NE(folded.find("outer (<stdin>:"), std::string::npos) << folded;
+    EXPECT_NE(folded.find(";spin (<stdin>:"), std::string::npos) << folded;
+    EXPECT_EQ(vm->stop_sampling(), "");
+}
+
+TEST_F(VMTest, DebuggerBreakpointRearmsAfterHit)
+{
+    const auto path = std::filesystem::temp_directory_path() / "aria_debugger_test.aria";
+    {
+        std::ofstream file{path};
+        file << "fun add(a, b) {\n"
+                "\n"
+                "    return a + b;\n"
+                "}\n"
+                "var s = 0;\n"
+                "for (var i = 0; i < 3; i = i + 1) { s = add(s, i); }\n"
+                "print s + 100;\n";
+    }
+    // 断点设在空行上，落到下一行的 return；每次调用都应再次命中
+    std::istringstream commands{"break 2\nrun\nc\nc\nc\n"};
+    auto *oldCin = std::cin.rdbuf(commands.rdbuf());
+    AriaDebugger debugger;
+    debugger.attach(vm);
+    CaptureStdout();
+    debugger.runScript(path.string());
+    const String output = GetCapturedStdout();
+    std::cin.rdbuf(oldCin);
+    vm->set_debugger(nullptr);
+    std::filesystem::remove(path);
+
+    size_t hits = 0;
+    for (size_t pos = 0; (pos = output.find("Breakpoint hit at line 3", pos)) != String::npos; pos++) {
+        hits++;
+    }
+    EXPECT_EQ(hits, 3u) << output;
+    EXPECT_NE(output.find("103"), String::npos) << output;
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "tests/gc/gc_init.h"
+
+#include "src/object/objString.h"
+#include "src/value/globalTable.h"
+#include "src/value/valueHashTable.h"
+
+using namespace aria;
+
+class GlobalTableTest : public ValueTestFixture
+{
+};
+
+// 同名变量总是解析到同一个槽位，新槽位为未定义状态
+TEST_F(GlobalTableTest, SlotOf)
+{
+    GlobalTable globals;
+    ObjString *a = new_ObjString("a", gc);
+    ObjString *b = new_ObjString("b", gc);
+
+    EXPECT_EQ(globals.slot_of(a), 0);
+    EXPECT_EQ(globals.slot_of(b), 1);
+    EXPECT_EQ(globals.slot_of(a), 0);
+    EXPECT_EQ(globals.size(), 2);
+    EXPECT_EQ(globals.find(b), 1);
+    EXPECT_EQ(globals.find(new_ObjString("c", gc)), -1);
+    EXPECT_EQ(globals.name(1), b);
+    EXPECT_FALSE(globals.is_defined(0));
+    EXPECT_EQ(globals.value(0), GlobalTable::k_undefined);
+}
+
+// 重复定义返回 false，但值仍然被更新
+TEST_F(GlobalTableTest, Define)
+{
+    GlobalTable globals;
+    ObjString *a = new_ObjString("a", gc);
+    uint32_t slot = globals.slot_of(a);
+
+    Value value;
+    EXPECT_FALSE(globals.get(a, value));
+    EXPECT_TRUE(globals.define(slot, NanBox::fromNumber(1)));
+    EXPECT_FALSE(globals.define(slot, NanBox::fromNumber(2)));
+    EXPECT_TRUE(globals.is_defined(slot));
+    EXPECT_TRUE(globals.get(a, value));
+    EXPECT_DOUBLE_EQ(NanBox::toNumber(value), 2.0);
+}
+
+// 内置变量在创建槽位时预先绑定，但不算作已定义的全局变量
+TEST_F(GlobalTableTest, BuiltinsArePreBound)
+{
+    ValueHashTable builtins{gc};
+    ObjString *pi = new_ObjString("pi", gc);
+    builtins.insert(NanBox::fromObj(pi), NanBox::fromNumber(3.14));
+    GlobalTable globals{&builtins};
+
+    uint32_t slot = globals.slot_of(pi);
+    EXPECT_DOUBLE_EQ(NanBox::toNumber(globals.value(slot)), 3.14);
+    EXPECT_FALSE(globals.is_defined(slot));
+    Value value;
+    EXPECT_FALSE(globals.get(pi, value));
+
+    EXPECT_TRUE(globals.define(slot, NanBox::fromNumber(3)));
+    EXPECT_DOUBLE_EQ(NanBox::toNumber(globals.value(slot)), 3.0);
+}
@@ -22,6 +22,61 @@ TEST(ValueTest, InvalidValueNumber)
     EXPECT_FALSE(aria::NanBox::isNumber(not_a_number));
 }
 
+TEST(ValueTest, ValueInt)
+{
+    aria::Value int_value = aria::NanBox::fromInt(-42);
+    EXPECT_TRUE(aria::NanBox::isInt(int_value));
+    EXPECT_TRUE(aria::NanBox::isNumber(int_value));
+    EXPECT_FALSE(aria::NanBox::isDouble(int_value));
+    EXPECT_FALSE(aria::NanBox::isObj(int_value));
+    EXPECT_FALSE(aria::NanBox::isNil(int_value));
+    EXPECT_EQ(aria::NanBox::toInt(int_value), -42);
+    EXPECT_DOUBLE_EQ(aria::NanBox::toNumber(int_value), -42.0);
+
+    // int32 与等值 double 相等且哈希一致
+    aria::Value double_value = aria::NanBox::fromNumber(-42.0);
+    EXPECT_TRUE(aria::values_same(int_value, double_value));
+    EXPECT_EQ(aria::value_hash(int_value), aria::value_hash(double_value));
+    EXPECT_EQ(aria::value_string(int_value), aria::value_string(double_value));
+
+    EXPECT_TRUE(aria::NanBox::isInt(aria::NanBox::packNumber(7.0)));
+    EXPECT_TRUE(aria::NanBox::isDouble(aria::NanBox::packNumber(7.5)));
+    EXPECT_TRUE(aria::NanBox::isDouble(aria::NanBox::packNumber(-0.0)));
+    EXPECT_TRUE(aria::NanBox::isDouble(aria::NanBox::packNumber(4294967296.0)));
+}
+
+// 整数运算溢出时提升为 double，-0 保持 double 语义
+TEST(ValueTest, IntArithmetic)
+{
+    using namespace aria;
+    Value max = NanBox::fromInt(INT32_MAX);
+    Value one = NanBox::fromInt(1);
+
+    EXPECT_TRUE(NanBox::isInt(NanBox::add(one, one)));
+    EXPECT_TRUE(NanBox::isDouble(NanBox::add(max, one)));
+    EXPECT_DOUBLE_EQ(NanBox::toNumber(NanBox::add(max, one)), 2147483648.0);
+    EXPECT_TRUE(NanBox::isDouble(NanBox::mul(max, max)));
+    EXPECT_TRUE(NanBox::isDouble(NanBox::div(NanBox::fromInt(6), NanBox::fromInt(3))));
+
+    Value negative_zero = NanBox::mul(NanBox::fromInt(0), NanBox::fromInt(-5));
+    EXPECT_TRUE(NanBox::isDouble(negative_zero));
+    EXPECT_TRUE(std::signbit(NanBox::toNumber(negative_zero)));
+    EXPECT_TRUE(std::signbit(NanBox::toNumber(NanBox::negate(NanBox::fromInt(0)))));
+    EXPECT_TRUE(std::signbit(NanBox::toNumber(NanBox::mod(NanBox::fromInt(-4), NanBox::fromInt(2)))));
+    EXPECT_EQ(NanBox::toInt(NanBox::mod(NanBox::fromInt(-7), NanBox::fromInt(3))), -1);
+    EXPECT_TRUE(NanBox::isDouble(NanBox::negate(NanBox::fromInt(INT32_MIN))));
+
+    EXPECT_TRUE(NanBox::less(NanBox::fromInt(1), NanBox::fromNumber(1.5)));
+    EXPECT_TRUE(NanBox::greaterEqual(NanBox::fromInt(2), NanBox::fromNumber(2.0)));
+
+    int32_t index;
+    EXPECT_TRUE(NanBox::toInteger(NanBox::fromNumber(3.0), index));
+    EXPECT_EQ(index, 3);
+    EXPECT_FALSE(NanBox::toInteger(NanBox::fromNumber(3.5), index));
+    EXPECT_FALSE(NanBox::toInteger(NanBox::fromNumber(1e10), index));
+    EXPECT_FALSE(NanBox::toInteger(NanBox::NilValue, index));
+}
+
 TEST(ValueTest, ValueBool)
 {
     auto bool1 = aria::NanBox::fromBool(true);
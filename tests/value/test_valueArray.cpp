@@ -133,4 +133,30 @@ TEST_F(ValueTestFixture, ValueArrayRemoveBounds)
     EXPECT_EQ(arr.size(), 0);
     // 空表任何 index 都越界。
     EXPECT_FALSE(arr.remove(0));
-}
\ No newline at end of file
+}
+// 短数组的元素存放在内联缓冲中；超过 k_inline_capacity 后换到堆上，clear 后回到内联缓冲
+TEST_F(ValueTestFixture, ValueArrayInlineStorage)
+{
+    aria::ValueArray arr = aria::ValueArray(gc);
+    for (uint32_t i = 0; i < aria::ValueArray::k_inline_capacity; i++) {
+        arr.push(aria::NanBox::fromNumber(i));
+    }
+    EXPECT_TRUE(arr.is_inline());
+
+    arr.push(aria::NanBox::fromNumber(100));
+    EXPECT_FALSE(arr.is_inline());
+    EXPECT_EQ(arr.size(), aria::ValueArray::k_inline_capacity + 1);
+    for (uint32_t i = 0; i < aria::ValueArray::k_inline_capacity; i++) {
+        EXPECT_EQ(aria::NanBox::toNumber(arr[i]), i);
+    }
+    EXPECT_EQ(aria::NanBox::toNumber(arr[aria::ValueArray::k_inline_capacity]), 100.0);
+
+    arr.clear();
+    EXPECT_TRUE(arr.is_inline());
+    EXPECT_TRUE(arr.empty());
+
+    aria::Value values[] = {aria::NanBox::TrueValue, aria::NanBox::NilValue};
+    aria::ValueArray small = aria::ValueArray(values, 2, gc);
+    EXPECT_TRUE(small.is_inline());
+    EXPECT_EQ(small.to_string(), "[true,nil]");
+}
@@ -262,18 +262,18 @@ TEST_F(ValueHashTableTest, CreateLists)
     table.insert(NanBox::fromNumber(2), NanBox::fromNumber(20));
 
     ObjList *keys = table.create_key_list();
-    EXPECT_EQ(keys->list_->size(), 2);
+    EXPECT_EQ(keys->list_.size(), 2);
 
     ObjList *values = table.create_value_list();
-    EXPECT_EQ(values->list_->size(), 2);
+    EXPECT_EQ(values->list_.size(), 2);
 
     ObjList *pairs = table.create_pair_list();
-    EXPECT_EQ(pairs->list_->size(), 2);
+    EXPECT_EQ(pairs->list_.size(), 2);
     // 每个 pair 是一个 [key, value] 的 list
-    for (uint32_t i = 0; i < pairs->list_->size(); i++) {
-        auto pairVal = (*pairs->list_)[i];
+    for (uint32_t i = 0; i < pairs->list_.size(); i++) {
+        auto pairVal = pairs->list_[i];
         EXPECT_TRUE(is_obj_list(pairVal));
         auto pairList = as_obj_list(pairVal);
-        EXPECT_EQ(pairList->list_->size(), 2);
+        EXPECT_EQ(pairList->list_.size(), 2);
     }
 }